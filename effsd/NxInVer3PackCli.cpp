@@ -1,19 +1,73 @@
 #include "src/NxInVer3Pack.hpp"
+#include "src/NxCommonColors.hpp"
+#include "src/NxOverrideDb.hpp"
+#include "../src/utils/base64enc.h"
+#include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
-// #include "mii_SwapEndian.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NXCLI_HAVE_MMAP 1
+#endif
 
 static void ShowUsage(const char* prog) {
     std::fprintf(stderr,
         "Usage:\n"
-        "  %s pack <input_mii_file> <output_mii_file> <facelineColor> <hairColor> <eyeColor> <eyebrowColor> <mouthColor> <beardColor> <glassColor> <glassType>\n"
-        "  %s unpack <input_mii_file>\n",
-        prog, prog);
+        "  %s pack <input_mii_file> <output_mii_file> <facelineColor> <hairColor> <eyeColor> <eyebrowColor> <mouthColor> <beardColor> <glassColor> <glassType> [mixed]\n"
+        "  %s unpack <input_mii_file>\n"
+        "  %s verify <input_mii_file>\n"
+        "  %s batch <pack|unpack> <input_file> <output_file> <bin72|bin96|base64|hex> [mixed]\n"
+        "  %s import <input_file_or_dir> <output_file> <bin96|base64|hex> [mixed]\n"
+        "  %s export <input_file> <output_file> <bin72|bin96|base64|hex>\n"
+        "  %s overrides <input_file> <output_db> <bin72|bin96|base64|hex>\n"
+        "\n"
+        "Mii files are 72 bytes (Ver3MiiDataCore) or 96 bytes (Ver3StoreData).\n"
+        "For 96 bytes, the creator name is kept and pack updates the checksum.\n"
+        "\n"
+        "Batch framing (use - for stdin/stdout):\n"
+        "  bin72/bin96:  records of a 72/96-byte Mii followed by the 8 extension fields, one byte each.\n"
+        "                unpack fills in the fields, or sets them all to 255 if there are none.\n"
+        "  base64/hex:   one record per line: <mii> [<facelineColor> ... <glassType>]\n"
+        "                Colors can be written as #RRGGBB, in pack too, to use the nearest one.\n"
+        "                unpack writes the fields after the Mii, or \"-\" if there are none.\n"
+        "                Lines that can't be processed are written as \"!\".\n"
+        "                unpack counts 96-byte Miis whose checksum doesn't match.\n"
+        "\n"
+        "Import reads decrypted amiibo dumps, or a 96-byte Mii followed by its 8-byte\n"
+        "NfpStoreDataExtension, and writes them packed in the same framing as batch pack.\n"
+        "Directories are searched recursively and written in path order.\n"
+        "\n"
+        "Export converts Miis to 88-byte Switch nn::mii CharInfo records, using the\n"
+        "extension colors when there are any. Input is plain 72/96-byte records, or one\n"
+        "Mii per line. Lines that can't be decoded become zeroed records.\n"
+        "\n"
+        "Overrides builds a color override database, keyed by each Mii's create ID, from\n"
+        "the same input as batch pack. Records without fields use the Mii's own eFFSD colors,\n"
+        "and are skipped if it has none. For duplicate create IDs, the last record wins.\n"
+        "Colors given as #RRGGBB are kept exactly, for up to 156 different ones.\n",
+        prog, prog, prog, prog, prog, prog, prog);
 }
 
-static bool ReadMiiFile(const char* path, Ver3MiiDataCore& out) {
+/// Raw Mii data in the little-endian file format.
+/// Accessed with Ver3MiiFileView, so no swapping is needed on big-endian hosts.
+struct MiiFileData {
+    u8 data[sizeof(Ver3StoreData)];
+    std::size_t size; ///< Ver3CoreRecordSize or Ver3StoreRecordSize.
+};
+
+static bool ReadMiiFile(const char* path, MiiFileData& out) {
     FILE* f = nullptr;
     if (std::strcmp(path, "-") == 0) {
         f = stdin;
@@ -24,23 +78,25 @@ static bool ReadMiiFile(const char* path, Ver3MiiDataCore& out) {
         std::perror("fopen");
         return false;
     }
-    size_t got = std::fread(&out, 1, sizeof(out), f);
+    // One byte past the largest size, to tell a 96-byte file from a longer one.
+    u8 extra = 0;
+    size_t got = std::fread(out.data, 1, sizeof(out.data), f);
+    if (got == sizeof(out.data)) {
+        got += std::fread(&extra, 1, 1, f);
+    }
     if (f != stdin) {
         std::fclose(f);
     }
-    if (got != sizeof(out)) {
-        std::fprintf(stderr, "Error: file too small or truncated.\n");
+    if (got != Ver3CoreRecordSize && got != Ver3StoreRecordSize) {
+        std::fprintf(stderr, "Error: expected a 72 or 96-byte Mii, got %zu bytes.\n", got);
         return false;
     }
-
-#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
-    SwapEndian(&out);
-#endif
+    out.size = got;
 
     return true;
 }
 
-static bool WriteMiiFile(const char* path, const Ver3MiiDataCore& in) {
+static bool WriteMiiFile(const char* path, const MiiFileData& in) {
     FILE* f = nullptr;
     if (std::strcmp(path, "-") == 0) {
         f = stdout;
@@ -51,17 +107,958 @@ static bool WriteMiiFile(const char* path, const Ver3MiiDataCore& in) {
         std::perror("fopen");
         return false;
     }
-    size_t wrote = std::fwrite(&in, 1, sizeof(in), f);
+    size_t wrote = std::fwrite(in.data, 1, in.size, f);
     if (f != stdout) {
         std::fclose(f);
     }
-    if (wrote != sizeof(in)) {
+    if (wrote != in.size) {
         std::fprintf(stderr, "Error: failed to write all data.\n");
         return false;
     }
     return true;
 }
 
+// // ---------------------------------------------------------------
+// //  Batch Mode
+// // ---------------------------------------------------------------
+
+enum class BatchFraming { Binary, Base64, Hex };
+
+struct BatchOptions {
+    bool pack;
+    BatchFraming framing;
+    std::size_t recordSize;  ///< Mii size for binary framing: 72 or 96.
+    ExtraEncoding encoding;
+};
+
+/// Counters for one slice of records.
+struct BatchStats {
+    std::size_t records = 0;
+    std::size_t withExtension = 0;
+    std::size_t errors = 0;
+    std::size_t badChecksums = 0; ///< 96-byte Miis with a wrong CRC, when unpacking.
+};
+
+/// Inputs at least this large are mmap'd rather than read.
+static constexpr std::size_t MapThreshold = 1 << 20;
+/// Bytes of input that batch mode works on at a time. Memory use stays
+/// around this much, plus each thread's output, however large the input is.
+static constexpr std::size_t BatchChunkSize = 4 << 20;
+/// Below this many records per thread, extra threads aren't worth starting.
+static constexpr std::size_t MinRecordsPerThread = 4096;
+/// Longest line written in text framing: a 96-byte Mii in hex, 8 fields, and a newline.
+static constexpr std::size_t MaxOutputLine = Ver3StoreRecordSize * 2 + 8 * 4 + 1;
+
+/// Whole input file, either mapped or read into memory.
+class InputBuffer {
+public:
+    InputBuffer() = default;
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+    ~InputBuffer() {
+#ifdef NXCLI_HAVE_MMAP
+        if (mMapped != nullptr) {
+            munmap(mMapped, mSize);
+        }
+#endif
+    }
+
+    bool Open(const char* path) {
+        FILE* f = std::strcmp(path, "-") == 0 ? stdin : std::fopen(path, "rb");
+        if (!f) {
+            std::perror("fopen");
+            return false;
+        }
+#ifdef NXCLI_HAVE_MMAP
+        struct stat st{};
+        if (f != stdin && fstat(fileno(f), &st) == 0 && S_ISREG(st.st_mode) &&
+            static_cast<std::size_t>(st.st_size) >= MapThreshold) {
+            void* mapped = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fileno(f), 0);
+            if (mapped != MAP_FAILED) {
+                std::fclose(f);
+                madvise(mapped, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+                mMapped = mapped;
+                mSize = static_cast<std::size_t>(st.st_size);
+                return true;
+            }
+        }
+#endif
+        // Pipes and small files.
+        u8 chunk[1 << 16];
+        std::size_t got = 0;
+        while ((got = std::fread(chunk, 1, sizeof(chunk), f)) != 0) {
+            mOwned.insert(mOwned.end(), chunk, chunk + got);
+        }
+        const bool failed = std::ferror(f) != 0;
+        if (f != stdin) {
+            std::fclose(f);
+        }
+        if (failed) {
+            std::fprintf(stderr, "Error: failed to read input.\n");
+            return false;
+        }
+        mSize = mOwned.size();
+        return true;
+    }
+
+    const u8* Data() const { return mMapped != nullptr ? static_cast<const u8*>(mMapped) : mOwned.data(); }
+    std::size_t Size() const { return mSize; }
+
+private:
+    void* mMapped = nullptr;
+    std::vector<u8> mOwned;
+    std::size_t mSize = 0;
+};
+
+/// Batch input, taken a chunk at a time. Mapped files are handed out
+/// in place, and anything else is read into one buffer that is reused.
+class InputStream {
+public:
+    InputStream() = default;
+    InputStream(const InputStream&) = delete;
+    InputStream& operator=(const InputStream&) = delete;
+    ~InputStream() {
+#ifdef NXCLI_HAVE_MMAP
+        if (mMapped != nullptr) {
+            munmap(mMapped, mMappedSize);
+        }
+#endif
+        if (mFile != nullptr && mFile != stdin) {
+            std::fclose(mFile);
+        }
+    }
+
+    bool Open(const char* path) {
+        mFile = std::strcmp(path, "-") == 0 ? stdin : std::fopen(path, "rb");
+        if (!mFile) {
+            std::perror("fopen");
+            return false;
+        }
+#ifdef NXCLI_HAVE_MMAP
+        struct stat st{};
+        if (mFile != stdin && fstat(fileno(mFile), &st) == 0 && S_ISREG(st.st_mode) &&
+            static_cast<std::size_t>(st.st_size) >= MapThreshold) {
+            void* mapped = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fileno(mFile), 0);
+            if (mapped != MAP_FAILED) {
+                madvise(mapped, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+                mMapped = mapped;
+                mMappedSize = static_cast<std::size_t>(st.st_size);
+            }
+        }
+#endif
+        if (mMapped == nullptr) {
+            mBuffer.reset(new u8[BatchChunkSize]);
+        }
+        return Advance(0);
+    }
+
+    /// Drops the first `used` bytes of the chunk, then fills it back up to BatchChunkSize.
+    /// @return False if reading failed.
+    bool Advance(std::size_t used) {
+        if (mMapped != nullptr) {
+#ifdef NXCLI_HAVE_MMAP
+            // Pages already processed aren't needed in memory any more.
+            const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            const std::size_t done = (mOffset + used) / page * page;
+            if (done > mReleased) {
+                madvise(static_cast<u8*>(mMapped) + mReleased, done - mReleased, MADV_DONTNEED);
+                mReleased = done;
+            }
+#endif
+            mOffset += used;
+            const std::size_t left = mMappedSize - mOffset;
+            mSize = left < BatchChunkSize ? left : BatchChunkSize;
+            mAtEnd = mSize == left;
+            return true;
+        }
+        // The unused end of the last chunk moves to the front.
+        std::memmove(mBuffer.get(), mBuffer.get() + used, mSize - used);
+        mSize -= used;
+        while (mSize < BatchChunkSize && !mAtEnd) {
+            const std::size_t got = std::fread(mBuffer.get() + mSize, 1, BatchChunkSize - mSize, mFile);
+            mSize += got;
+            if (got == 0) {
+                if (std::ferror(mFile)) {
+                    std::fprintf(stderr, "Error: failed to read input.\n");
+                    return false;
+                }
+                mAtEnd = true;
+            }
+        }
+        return true;
+    }
+
+    const u8* Data() const { return mMapped != nullptr ? static_cast<const u8*>(mMapped) + mOffset : mBuffer.get(); }
+    std::size_t Size() const { return mSize; }
+    /// True if the chunk reaches the end of the input.
+    bool AtEnd() const { return mAtEnd; }
+
+private:
+    FILE* mFile = nullptr;
+    void* mMapped = nullptr;
+    std::size_t mMappedSize = 0;
+    std::size_t mOffset = 0; ///< Of the chunk in the mapping.
+    std::size_t mReleased = 0; ///< Bytes at the start of the mapping given back with MADV_DONTNEED.
+    std::unique_ptr<u8[]> mBuffer;
+    std::size_t mSize = 0;
+    bool mAtEnd = false;
+};
+
+/// Packs or unpacks one Mii in the file format. `fields` is read for pack, written for unpack.
+/// The checksum of a 96-byte Mii is updated when packing, and checked when unpacking.
+/// @return False if the fields are out of range (pack) or there are none (unpack).
+static bool ProcessMii(const BatchOptions& options, u8* mii, std::size_t size, NxExtensionFields& fields, BatchStats& stats) {
+    if (options.pack) {
+        if (!FieldsInRange(fields)) {
+            return false;
+        }
+        NxInVer3Pack::Pack(fields, Ver3MiiFileView(mii), options.encoding);
+        if (size == Ver3StoreRecordSize) {
+            UpdateStoreDataCrc(mii);
+        }
+        return true;
+    }
+    if (size == Ver3StoreRecordSize && !VerifyStoreDataCrc(mii)) {
+        ++stats.badChecksums;
+    }
+    return NxInVer3Pack::TryUnpack(Ver3MiiFileConstView(mii), fields);
+}
+
+static void AddStats(BatchStats& total, const BatchStats& part) {
+    total.records += part.records;
+    total.withExtension += part.withExtension;
+    total.errors += part.errors;
+    total.badChecksums += part.badChecksums;
+}
+
+/// Number of slices (and threads) for `count` records.
+static std::size_t SliceCount(std::size_t count) {
+    const std::size_t hardware = std::thread::hardware_concurrency();
+    const std::size_t wanted = count / MinRecordsPerThread;
+    const std::size_t limit = hardware != 0 ? hardware : 1;
+    return wanted < 1 ? 1 : (wanted > limit ? limit : wanted);
+}
+
+/// Runs `body(slice, first, last, stats)` over [0, count), one thread per slice.
+template <typename Body>
+static BatchStats RunSliced(std::size_t count, Body body) {
+    const std::size_t threads = SliceCount(count);
+
+    std::vector<BatchStats> stats(threads);
+    std::vector<std::thread> workers;
+    const std::size_t share = (count + threads - 1) / threads;
+    for (std::size_t t = 0; t < threads; ++t) {
+        const std::size_t first = t * share < count ? t * share : count;
+        const std::size_t last = first + share < count ? first + share : count;
+        if (t + 1 == threads) {
+            body(t, first, last, stats[t]);
+        } else {
+            workers.emplace_back([&body, &stats, t, first, last] { body(t, first, last, stats[t]); });
+        }
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    BatchStats total;
+    for (const BatchStats& slice : stats) {
+        AddStats(total, slice);
+    }
+    return total;
+}
+
+/// Binary framing: the output is the input with each record processed.
+/// Each chunk's slices are copied into their thread's buffer, processed there, and written in order.
+static bool RunBatchBinary(const BatchOptions& options, InputStream& input, FILE* out, BatchStats& total) {
+    const std::size_t frame = options.recordSize + sizeof(NxExtensionFields);
+    std::vector<std::vector<u8>> outputs(SliceCount(BatchChunkSize / frame));
+
+    for (std::size_t used = 0; input.Advance(used);) {
+        const std::size_t count = input.Size() / frame;
+        if (count == 0) {
+            if (input.Size() != 0) {
+                std::fprintf(stderr, "Error: input size is not a multiple of the %zu-byte record.\n", frame);
+                return false;
+            }
+            return true;
+        }
+        const u8* data = input.Data();
+        AddStats(total, RunSliced(count, [&](std::size_t slice, std::size_t first, std::size_t last, BatchStats& stats) {
+            std::vector<u8>& buffer = outputs[slice];
+            buffer.assign(data + first * frame, data + last * frame);
+            for (std::size_t i = 0; i < last - first; ++i) {
+                u8* record = buffer.data() + i * frame;
+                NxExtensionFields fields{};
+                std::memcpy(&fields, record + options.recordSize, sizeof(fields));
+                const bool ok = ProcessMii(options, record, options.recordSize, fields, stats);
+                if (!options.pack) {
+                    if (!ok) {
+                        std::memset(&fields, 0xFF, sizeof(fields));
+                    }
+                    std::memcpy(record + options.recordSize, &fields, sizeof(fields));
+                }
+                ++stats.records;
+                stats.withExtension += ok ? 1 : 0;
+                stats.errors += (options.pack && !ok) ? 1 : 0;
+            }
+        }));
+        for (std::size_t i = 0; i < SliceCount(count); ++i) {
+            if (std::fwrite(outputs[i].data(), 1, outputs[i].size(), out) != outputs[i].size()) {
+                return false;
+            }
+        }
+        used = count * frame;
+    }
+    return false;
+}
+
+/// Decodes a Mii token. @return Decoded size, or 0 if invalid or not 72/96 bytes.
+static std::size_t DecodeMiiToken(BatchFraming framing, const char* token, std::size_t len, u8 (&out)[Ver3StoreRecordSize]) {
+    long size = -1;
+    if (framing == BatchFraming::Hex) {
+        if (HEX_DECODED_SIZE(len) <= sizeof(out)) {
+            size = hex_decode(token, len, out);
+        }
+    } else if (BASE64_DECODED_SIZE(len) <= sizeof(out)) {
+        size = base64_decode(token, len, out);
+    }
+    return size == static_cast<long>(Ver3CoreRecordSize) || size == static_cast<long>(Ver3StoreRecordSize)
+        ? static_cast<std::size_t>(size) : 0;
+}
+
+static char* EncodeMii(BatchFraming framing, const u8* mii, std::size_t size, char* out) {
+    if (framing == BatchFraming::Hex) {
+        hex_encode(mii, size, out);
+        return out + size * 2;
+    }
+    base64_encode(mii, size, out);
+    return out + (BASE64_ENCODED_SIZE(size) - 1);
+}
+
+static char* EncodeFields(const NxExtensionFields& fields, char* out) {
+    const u8* values = &fields.facelineColor;
+    for (std::size_t i = 0; i < sizeof(fields); ++i) {
+        *out++ = ' ';
+        const u32 value = values[i];
+        if (value >= 100) *out++ = static_cast<char>('0' + value / 100);
+        if (value >= 10)  *out++ = static_cast<char>('0' + value / 10 % 10);
+        *out++ = static_cast<char>('0' + value % 10);
+    }
+    return out;
+}
+
+/// The color fields of NxExtensionFields come first, then glassType.
+static constexpr std::size_t ColorFieldCount = 7;
+
+static NxColorPalette PaletteOfField(std::size_t field) {
+    return field == 0 ? NxColorPalette_Faceline : NxColorPalette_Common;
+}
+
+/// One line of text framing: a Mii token, then up to 8 fields.
+struct ParsedLine {
+    const char* token;
+    std::size_t tokenLength;
+    u8 mii[Ver3StoreRecordSize];
+    std::size_t size;          ///< 0 if the token isn't a 72- or 96-byte Mii.
+    NxExtensionFields fields;
+    std::size_t fieldCount;
+    bool fieldsValid;
+    /// Color fields given as #RRGGBB, as bits (1 << field), and their exact colors.
+    u8 exactColorMask;
+    NxSrgb8 exactColors[ColorFieldCount];
+};
+
+static void ParseLine(BatchFraming framing, const char* line, const char* end, ParsedLine& parsed) {
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    const char* p = line;
+    while (p < end && isSpace(*p)) ++p;
+    const char* token = p;
+    while (p < end && !isSpace(*p)) ++p;
+    parsed.token = token;
+    parsed.tokenLength = static_cast<std::size_t>(p - token);
+    parsed.size = DecodeMiiToken(framing, token, parsed.tokenLength, parsed.mii);
+
+    // Up to 8 fields after the Mii.
+    parsed.fields = {};
+    u8* values = &parsed.fields.facelineColor;
+    std::size_t fieldCount = 0;
+    bool fieldsValid = true;
+    parsed.exactColorMask = 0;
+    while (p < end) {
+        while (p < end && isSpace(*p)) ++p;
+        if (p == end) break;
+        if (fieldCount == sizeof(parsed.fields)) {
+            fieldsValid = false;
+            break;
+        }
+        // "-" is what unpack writes for no fields.
+        if (*p == '-' && fieldCount == 0 && (p + 1 == end || isSpace(p[1]))) {
+            ++p;
+            while (p < end && isSpace(*p)) ++p;
+            fieldsValid = p == end;
+            break;
+        }
+        // Colors may also be given as #RRGGBB.
+        if (*p == '#' && fieldCount < ColorFieldCount) {
+            const char* start = p;
+            while (p < end && !isSpace(*p)) ++p;
+            NxSrgb8 color{};
+            if (!ParseHexColor(start, static_cast<std::size_t>(p - start), color)) {
+                fieldsValid = false;
+                break;
+            }
+            values[fieldCount] = QuantizeColor(color, PaletteOfField(fieldCount));
+            parsed.exactColorMask |= static_cast<u8>(1u << fieldCount);
+            parsed.exactColors[fieldCount] = color;
+            ++fieldCount;
+            continue;
+        }
+        u32 value = 0;
+        std::size_t digits = 0;
+        for (; p < end && *p >= '0' && *p <= '9' && digits < 4; ++p, ++digits) {
+            value = value * 10 + static_cast<u32>(*p - '0');
+        }
+        if (digits == 0 || value > 255 || (p < end && !isSpace(*p))) {
+            fieldsValid = false;
+            break;
+        }
+        values[fieldCount++] = static_cast<u8>(value);
+    }
+    parsed.fieldCount = fieldCount;
+    parsed.fieldsValid = fieldsValid;
+}
+
+/// Processes one line. Writes the output line, without the newline, at `out`.
+static char* ProcessLine(const BatchOptions& options, const char* line, const char* end, char* out, BatchStats& stats) {
+    ++stats.records;
+    ParsedLine parsed;
+    ParseLine(options.framing, line, end, parsed);
+    NxExtensionFields& fields = parsed.fields;
+
+    if (parsed.size == 0 || !parsed.fieldsValid || (options.pack && parsed.fieldCount != sizeof(fields))) {
+        ++stats.errors;
+        *out++ = '!';
+        return out;
+    }
+
+    const bool ok = ProcessMii(options, parsed.mii, parsed.size, fields, stats);
+    if (options.pack) {
+        if (!ok) {
+            ++stats.errors;
+            *out++ = '!';
+            return out;
+        }
+        ++stats.withExtension;
+        out = EncodeMii(options.framing, parsed.mii, parsed.size, out);
+        return EncodeFields(fields, out);
+    }
+
+    // Unpacking doesn't change the Mii, so the token is copied as-is.
+    std::memcpy(out, parsed.token, parsed.tokenLength);
+    out += parsed.tokenLength;
+    if (!ok) {
+        *out++ = ' ';
+        *out++ = '-';
+        return out;
+    }
+    ++stats.withExtension;
+    return EncodeFields(fields, out);
+}
+
+/// Start of each non-empty line in `text`.
+static std::vector<std::size_t> FindLines(const char* text, std::size_t size) {
+    std::vector<std::size_t> lines;
+    for (std::size_t i = 0; i < size;) {
+        const void* newline = std::memchr(text + i, '\n', size - i);
+        const std::size_t next = newline != nullptr ? static_cast<std::size_t>(static_cast<const char*>(newline) - text) : size;
+        if (next > i && !(next == i + 1 && text[i] == '\r')) {
+            lines.push_back(i);
+        }
+        i = next + 1;
+    }
+    return lines;
+}
+
+/// End of the line starting at `line`, not including the newline.
+static const char* LineEnd(const char* text, std::size_t size, std::size_t line) {
+    const void* newline = std::memchr(text + line, '\n', size - line);
+    return newline != nullptr ? static_cast<const char*>(newline) : text + size;
+}
+
+/// Line framing. Each chunk's slices write into their thread's buffer, and those are written in order.
+/// A line cut off at the end of a chunk is left for the next one.
+static bool RunBatchText(const BatchOptions& options, InputStream& input, FILE* out, BatchStats& total) {
+    std::vector<std::vector<char>> outputs(SliceCount(BatchChunkSize));
+
+    for (std::size_t used = 0; input.Advance(used);) {
+        const char* text = reinterpret_cast<const char*>(input.Data());
+        std::size_t size = input.Size();
+        if (size == 0) {
+            return true;
+        }
+        // A chunk with no newline at all is one (too long) line.
+        if (!input.AtEnd()) {
+            std::size_t cut = size;
+            while (cut != 0 && text[cut - 1] != '\n') {
+                --cut;
+            }
+            size = cut != 0 ? cut : size;
+        }
+        const std::vector<std::size_t> lines = FindLines(text, size);
+        const std::size_t count = lines.size();
+
+        AddStats(total, RunSliced(count, [&](std::size_t slice, std::size_t first, std::size_t last, BatchStats& stats) {
+            std::vector<char>& output = outputs[slice];
+            output.clear();
+            char line[MaxOutputLine];
+            for (std::size_t i = first; i < last; ++i) {
+                char* o = ProcessLine(options, text + lines[i], LineEnd(text, size, lines[i]), line, stats);
+                *o++ = '\n';
+                output.insert(output.end(), line, o);
+            }
+        }));
+        for (std::size_t i = 0; i < SliceCount(count); ++i) {
+            if (std::fwrite(outputs[i].data(), 1, outputs[i].size(), out) != outputs[i].size()) {
+                return false;
+            }
+        }
+        used = size;
+    }
+    return false;
+}
+
+/// Parses the framing argument into `options`. @return False if it isn't one of the names.
+static bool ParseFraming(const char* framing, BatchOptions& options) {
+    if (std::strcmp(framing, "bin72") == 0) {
+        options.framing = BatchFraming::Binary;
+        options.recordSize = Ver3CoreRecordSize;
+    } else if (std::strcmp(framing, "bin96") == 0) {
+        options.framing = BatchFraming::Binary;
+        options.recordSize = Ver3StoreRecordSize;
+    } else if (std::strcmp(framing, "base64") == 0) {
+        options.framing = BatchFraming::Base64;
+    } else if (std::strcmp(framing, "hex") == 0) {
+        options.framing = BatchFraming::Hex;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static int RunBatch(int argc, char** argv) {
+    if (argc != 6 && !(argc == 7 && std::strcmp(argv[6], "mixed") == 0)) {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    BatchOptions options{};
+    options.encoding = argc == 7 ? ExtraEncoding_MixedRadix : ExtraEncoding_FixedWidth;
+    if (std::strcmp(argv[2], "pack") == 0) {
+        options.pack = true;
+    } else if (std::strcmp(argv[2], "unpack") != 0) {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+    if (!ParseFraming(argv[5], options)) {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    InputStream input;
+    if (!input.Open(argv[3])) {
+        return 1;
+    }
+    FILE* out = std::strcmp(argv[4], "-") == 0 ? stdout : std::fopen(argv[4], "wb");
+    if (!out) {
+        std::perror("fopen");
+        return 1;
+    }
+
+    BatchStats stats;
+    bool ok = options.framing == BatchFraming::Binary
+        ? RunBatchBinary(options, input, out, stats)
+        : RunBatchText(options, input, out, stats);
+    if (out != stdout) {
+        ok = std::fclose(out) == 0 && ok;
+    } else {
+        ok = std::fflush(out) == 0 && ok;
+    }
+    if (!ok) {
+        std::fprintf(stderr, "Error: failed to write all data.\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "%zu records, %zu %s, %zu errors.\n", stats.records, stats.withExtension,
+        options.pack ? "packed" : "with extension data", stats.errors);
+    if (stats.badChecksums != 0) {
+        std::fprintf(stderr, "%zu records have a bad checksum.\n", stats.badChecksums);
+    }
+    return stats.errors != 0 ? 1 : 0;
+}
+
+// // ---------------------------------------------------------------
+// //  amiibo Import
+// // ---------------------------------------------------------------
+
+static const char* DescribeImportResult(AmiiboImportResult result) {
+    switch (result) {
+        case AmiiboImport_Success:     return "ok";
+        case AmiiboImport_UnknownSize: return "not an amiibo dump or 104-byte Mii with extension";
+        case AmiiboImport_NoOwnerMii:  return "amiibo has no owner Mii";
+        case AmiiboImport_BadChecksum: return "bad Mii checksum (is the dump decrypted?)";
+    }
+    return "unknown error";
+}
+
+/// Imports one input file and writes its record at `out`, in the framing of batch pack.
+/// Miis whose extension doesn't match their colors are written unpacked, the way batch
+/// unpack writes Miis without one. Files that can't be imported are skipped in binary framing.
+static char* ImportFile(const BatchOptions& options, const char* path, char* out, BatchStats& stats) {
+    ++stats.records;
+    u8 mii[Ver3StoreRecordSize];
+    NxExtensionFields fields{};
+
+    InputBuffer input;
+    const bool read = input.Open(path);
+    const AmiiboImportResult result = read
+        ? ExtractAmiiboMii(input.Data(), input.Size(), mii, fields)
+        : AmiiboImport_UnknownSize;
+    if (result != AmiiboImport_Success) {
+        ++stats.errors;
+        std::fprintf(stderr, "%s: %s.\n", path, read ? DescribeImportResult(result) : "failed to read");
+        if (options.framing != BatchFraming::Binary) {
+            *out++ = '!';
+        }
+        return out;
+    }
+
+    // A 3DS/Wii U leaves the extension alone when editing, so it may not belong to the Mii anymore.
+    const bool matches = NxInVer3Pack::MatchesVisible(fields, Ver3MiiFileConstView(mii));
+    if (matches) {
+        NxInVer3Pack::Pack(fields, Ver3MiiFileView(mii), options.encoding);
+        UpdateStoreDataCrc(mii);
+        ++stats.withExtension;
+    } else {
+        std::memset(&fields, 0xFF, sizeof(fields));
+    }
+
+    if (options.framing == BatchFraming::Binary) {
+        std::memcpy(out, mii, sizeof(mii));
+        std::memcpy(out + sizeof(mii), &fields, sizeof(fields));
+        return out + sizeof(mii) + sizeof(fields);
+    }
+    out = EncodeMii(options.framing, mii, sizeof(mii), out);
+    if (!matches) {
+        *out++ = ' ';
+        *out++ = '-';
+        return out;
+    }
+    return EncodeFields(fields, out);
+}
+
+static int RunImport(int argc, char** argv) {
+    if (argc != 5 && !(argc == 6 && std::strcmp(argv[5], "mixed") == 0)) {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    BatchOptions options{};
+    options.pack = true;
+    options.encoding = argc == 6 ? ExtraEncoding_MixedRadix : ExtraEncoding_FixedWidth;
+    // Amiibo Miis are always 96 bytes.
+    if (!ParseFraming(argv[4], options) || options.recordSize == Ver3CoreRecordSize) {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+    options.recordSize = Ver3StoreRecordSize;
+
+    // Every file under a directory, sorted so that the output doesn't depend on the filesystem.
+    std::vector<std::string> paths;
+    std::error_code error;
+    if (std::filesystem::is_directory(argv[2], error)) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(argv[2], error)) {
+            if (entry.is_regular_file(error)) {
+                paths.push_back(entry.path().string());
+            }
+        }
+        if (error) {
+            std::fprintf(stderr, "Error: failed to list %s: %s\n", argv[2], error.message().c_str());
+            return 1;
+        }
+        std::sort(paths.begin(), paths.end());
+    } else {
+        paths.emplace_back(argv[2]);
+    }
+
+    FILE* out = std::strcmp(argv[3], "-") == 0 ? stdout : std::fopen(argv[3], "wb");
+    if (!out) {
+        std::perror("fopen");
+        return 1;
+    }
+
+    // As in RunBatchText, each slice fills its own buffer and those are written in order.
+    const std::size_t count = paths.size();
+    std::vector<std::unique_ptr<char[]>> outputs(SliceCount(count));
+    std::vector<std::size_t> outputSizes(outputs.size(), 0);
+
+    const BatchStats stats = RunSliced(count, [&](std::size_t slice, std::size_t first, std::size_t last, BatchStats& sliceStats) {
+        outputs[slice].reset(new char[(last - first) * MaxOutputLine]);
+        char* o = outputs[slice].get();
+        for (std::size_t i = first; i < last; ++i) {
+            o = ImportFile(options, paths[i].c_str(), o, sliceStats);
+            if (options.framing != BatchFraming::Binary) {
+                *o++ = '\n';
+            }
+        }
+        outputSizes[slice] = static_cast<std::size_t>(o - outputs[slice].get());
+    });
+
+    bool ok = true;
+    for (std::size_t i = 0; i < outputs.size(); ++i) {
+        if (outputSizes[i] != 0 && std::fwrite(outputs[i].get(), 1, outputSizes[i], out) != outputSizes[i]) {
+            ok = false;
+        }
+    }
+    if (out != stdout) {
+        ok = std::fclose(out) == 0 && ok;
+    } else {
+        ok = std::fflush(out) == 0 && ok;
+    }
+    if (!ok) {
+        std::fprintf(stderr, "Error: failed to write all data.\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "%zu files, %zu with Switch colors, %zu errors.\n",
+        stats.records, stats.withExtension, stats.errors);
+    return stats.errors != 0 ? 1 : 0;
+}
+
+// // ---------------------------------------------------------------
+// //  Switch Export
+// // ---------------------------------------------------------------
+
+static int RunExport(int argc, char** argv) {
+    BatchOptions options{};
+    if (argc != 5 || !ParseFraming(argv[4], options)) {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    InputBuffer input;
+    if (!input.Open(argv[2])) {
+        return 1;
+    }
+
+    // Binary input is converted in place. Text is decoded into 96-byte records first,
+    // with `valid` marking the lines that decoded.
+    const u8* records = input.Data();
+    std::size_t stride = options.recordSize;
+    std::size_t count = 0;
+    std::vector<u8> decoded;
+    std::vector<u8> valid;
+    const char* text = reinterpret_cast<const char*>(input.Data());
+    std::vector<std::size_t> lines;
+    if (options.framing == BatchFraming::Binary) {
+        if (input.Size() % stride != 0) {
+            std::fprintf(stderr, "Error: input size is not a multiple of the %zu-byte record.\n", stride);
+            return 1;
+        }
+        count = input.Size() / stride;
+    } else {
+        lines = FindLines(text, input.Size());
+        count = lines.size();
+        stride = Ver3StoreRecordSize;
+        decoded.resize(count * stride);
+        valid.resize(count);
+        records = decoded.data();
+    }
+
+    std::vector<NxCharInfo> charInfos(count);
+    const BatchStats stats = RunSliced(count, [&](std::size_t, std::size_t first, std::size_t last, BatchStats& sliceStats) {
+        sliceStats.records = last - first;
+        if (options.framing == BatchFraming::Binary) {
+            sliceStats.withExtension = NxInVer3Pack::ToCharInfoBatch<std::endian::little>(
+                records + first * stride, last - first, stride, charInfos.data() + first);
+            return;
+        }
+        // Miis are the first token of each line. Anything after them is ignored.
+        for (std::size_t i = first; i < last; ++i) {
+            const char* token = text + lines[i];
+            const char* end = LineEnd(text, input.Size(), lines[i]);
+            while (token < end && (*token == ' ' || *token == '\t')) ++token;
+            const char* tokenEnd = token;
+            while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\t' && *tokenEnd != '\r') ++tokenEnd;
+            u8 mii[Ver3StoreRecordSize] = {};
+            valid[i] = DecodeMiiToken(options.framing, token, static_cast<std::size_t>(tokenEnd - token), mii) != 0;
+            std::memcpy(decoded.data() + i * stride, mii, sizeof(mii));
+        }
+        for (std::size_t i = first; i < last; ++i) {
+            if (valid[i]) {
+                sliceStats.withExtension += NxInVer3Pack::ToCharInfo(
+                    Ver3MiiFileConstView(records + i * stride), charInfos[i]) ? 1 : 0;
+            } else {
+                // Zeroed, so the output still lines up with the input.
+                ++sliceStats.errors;
+            }
+        }
+    });
+
+    FILE* out = std::strcmp(argv[3], "-") == 0 ? stdout : std::fopen(argv[3], "wb");
+    if (!out) {
+        std::perror("fopen");
+        return 1;
+    }
+    bool ok = count == 0 || std::fwrite(charInfos.data(), sizeof(NxCharInfo), count, out) == count;
+    if (out != stdout) {
+        ok = std::fclose(out) == 0 && ok;
+    } else {
+        ok = std::fflush(out) == 0 && ok;
+    }
+    if (!ok) {
+        std::fprintf(stderr, "Error: failed to write all data.\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "%zu records, %zu with Switch colors, %zu errors.\n",
+        stats.records, stats.withExtension, stats.errors);
+    return stats.errors != 0 ? 1 : 0;
+}
+
+// // ---------------------------------------------------------------
+// //  Override Database
+// // ---------------------------------------------------------------
+
+/// Adds an entry for one record. Without fields, the Mii's own are used.
+/// @return False if the fields are out of range, or there are none at all.
+static bool AddOverride(const u8* mii, const NxExtensionFields* fields, std::vector<NxOverrideDbEntry>& entries) {
+    NxOverrideDbEntry entry{};
+    std::memcpy(entry.createId, mii + offsetof(Ver3MiiDataCore, createId), sizeof(entry.createId));
+    if (fields != nullptr) {
+        entry.fields = *fields;
+    } else if (!NxInVer3Pack::TryUnpack(Ver3MiiFileConstView(mii), entry.fields)) {
+        return false;
+    }
+    if (!FieldsInRange(entry.fields)) {
+        return false;
+    }
+    entries.push_back(entry);
+    return true;
+}
+
+/// Custom colors for the database, and the field value of each, by color.
+struct OverrideColors {
+    std::vector<NxSrgb8> colors;
+    std::map<u32, u8> values;
+    std::size_t approximated = 0; ///< Colors left quantized because the file was full.
+};
+
+/// Replaces the fields given as #RRGGBB with their exact color, unless it's a common color already.
+static void UseExactColors(const ParsedLine& parsed, OverrideColors& pool, NxExtensionFields& fields) {
+    u8* values = &fields.facelineColor;
+    // Faceline colors can't be custom, so those stay quantized.
+    for (std::size_t i = 1; i < ColorFieldCount; ++i) {
+        if ((parsed.exactColorMask >> i & 1) == 0) {
+            continue;
+        }
+        const NxSrgb8 color = parsed.exactColors[i];
+        const auto common = std::find_if(NxCommonColorsSrgb.begin(), NxCommonColorsSrgb.end(),
+            [&](NxSrgb8 c) { return c.r == color.r && c.g == color.g && c.b == color.b; });
+        if (common != NxCommonColorsSrgb.end()) {
+            values[i] = static_cast<u8>(common - NxCommonColorsSrgb.begin());
+            continue;
+        }
+        const u32 key = static_cast<u32>(color.r) << 16 | static_cast<u32>(color.g) << 8 | color.b;
+        auto it = pool.values.find(key);
+        if (it == pool.values.end()) {
+            if (pool.colors.size() == NxOverrideDbColor_Max) {
+                ++pool.approximated;
+                continue;
+            }
+            it = pool.values.emplace(key, static_cast<u8>(NxOverrideDbColor_Begin + pool.colors.size())).first;
+            pool.colors.push_back(color);
+        }
+        values[i] = it->second;
+    }
+}
+
+static int RunOverrides(int argc, char** argv) {
+    BatchOptions options{};
+    if (argc != 5 || !ParseFraming(argv[4], options)) {
+        ShowUsage(argv[0]);
+        return 1;
+    }
+
+    InputBuffer input;
+    if (!input.Open(argv[2])) {
+        return 1;
+    }
+
+    std::vector<NxOverrideDbEntry> entries;
+    OverrideColors pool;
+    std::size_t records = 0;
+    std::size_t skipped = 0;
+    if (options.framing == BatchFraming::Binary) {
+        const std::size_t stride = options.recordSize + sizeof(NxExtensionFields);
+        if (input.Size() % stride != 0) {
+            std::fprintf(stderr, "Error: input size is not a multiple of the %zu-byte record.\n", stride);
+            return 1;
+        }
+        records = input.Size() / stride;
+        for (std::size_t i = 0; i < records; ++i) {
+            const u8* mii = input.Data() + i * stride;
+            NxExtensionFields fields;
+            std::memcpy(&fields, mii + options.recordSize, sizeof(fields));
+            // All 255 is what batch unpack writes for "no fields".
+            const bool none = std::all_of(mii + options.recordSize, mii + stride, [](u8 b) { return b == 255; });
+            skipped += AddOverride(mii, none ? nullptr : &fields, entries) ? 0 : 1;
+        }
+    } else {
+        const char* text = reinterpret_cast<const char*>(input.Data());
+        const std::vector<std::size_t> lines = FindLines(text, input.Size());
+        records = lines.size();
+        for (const std::size_t line : lines) {
+            ParsedLine parsed;
+            ParseLine(options.framing, text + line, LineEnd(text, input.Size(), line), parsed);
+            const bool none = parsed.fieldCount == 0;
+            if (parsed.size == 0 || !parsed.fieldsValid || (!none && parsed.fieldCount != sizeof(parsed.fields))) {
+                ++skipped;
+                continue;
+            }
+            if (!AddOverride(parsed.mii, none ? nullptr : &parsed.fields, entries)) {
+                ++skipped;
+                continue;
+            }
+            UseExactColors(parsed, pool, entries.back().fields);
+        }
+    }
+
+    const std::size_t added = entries.size();
+    std::size_t duplicates = 0;
+    const std::vector<u8> file = NxOverrideDb::Build(std::move(entries), pool.colors, duplicates);
+
+    FILE* out = std::strcmp(argv[3], "-") == 0 ? stdout : std::fopen(argv[3], "wb");
+    if (!out) {
+        std::perror("fopen");
+        return 1;
+    }
+    bool ok = std::fwrite(file.data(), 1, file.size(), out) == file.size();
+    if (out != stdout) {
+        ok = std::fclose(out) == 0 && ok;
+    } else {
+        ok = std::fflush(out) == 0 && ok;
+    }
+    if (!ok) {
+        std::fprintf(stderr, "Error: failed to write all data.\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "%zu records, %zu entries, %zu duplicates replaced, %zu skipped.\n",
+        records, added - duplicates, duplicates, skipped);
+    std::fprintf(stderr, "%zu custom colors, %zu approximated.\n", pool.colors.size(), pool.approximated);
+    return skipped != 0 ? 1 : 0;
+}
+
 int main(int argc, char** argv) {
     if (argc < 3) {
         ShowUsage(argv[0]);
@@ -70,26 +1067,44 @@ int main(int argc, char** argv) {
 
     const char* mode = argv[1];
 
-    if (std::strcmp(mode, "pack") == 0) {
-        if (argc != 12) {
+    if (std::strcmp(mode, "batch") == 0) {
+        return RunBatch(argc, argv);
+    } else if (std::strcmp(mode, "import") == 0) {
+        return RunImport(argc, argv);
+    } else if (std::strcmp(mode, "overrides") == 0) {
+        return RunOverrides(argc, argv);
+    } else if (std::strcmp(mode, "export") == 0) {
+        return RunExport(argc, argv);
+    } else if (std::strcmp(mode, "pack") == 0) {
+        // Optional "mixed" selects ExtraEncoding_MixedRadix.
+        if (argc != 12 && !(argc == 13 && std::strcmp(argv[12], "mixed") == 0)) {
             ShowUsage(argv[0]);
             return 1;
         }
+        const ExtraEncoding encoding = argc == 13 ? ExtraEncoding_MixedRadix : ExtraEncoding_FixedWidth;
 
-        Ver3MiiDataCore mii{};
+        MiiFileData mii{};
         if (!ReadMiiFile(argv[2], mii)) {
             return 1;
         }
 
         NxExtensionFields fields{};
-        fields.facelineColor = static_cast<u8>(std::atoi(argv[4]));
-        fields.hairColor     = static_cast<u8>(std::atoi(argv[5]));
-        fields.eyeColor      = static_cast<u8>(std::atoi(argv[6]));
-        fields.eyebrowColor  = static_cast<u8>(std::atoi(argv[7]));
-        fields.mouthColor    = static_cast<u8>(std::atoi(argv[8]));
-        fields.beardColor    = static_cast<u8>(std::atoi(argv[9]));
-        fields.glassColor    = static_cast<u8>(std::atoi(argv[10]));
-        fields.glassType     = static_cast<u8>(std::atoi(argv[11]));
+        // Colors are indices, or #RRGGBB for the nearest color.
+        u8* values = &fields.facelineColor;
+        for (std::size_t i = 0; i < sizeof(fields); ++i) {
+            const char* arg = argv[4 + i];
+            NxSrgb8 color{};
+            if (arg[0] == '#' && i < ColorFieldCount) {
+                if (!ParseHexColor(arg, std::strlen(arg), color)) {
+                    std::fprintf(stderr, "Invalid color: %s\n", arg);
+                    return 1;
+                }
+                values[i] = QuantizeColor(color, PaletteOfField(i));
+                std::fprintf(stderr, "%s -> %u\n", arg, values[i]);
+            } else {
+                values[i] = static_cast<u8>(std::atoi(arg));
+            }
+        }
 
         // Bounds checking.
         if (fields.facelineColor >= FacelineColor_End)  { std::fprintf(stderr, "facelineColor out of range (0-9)\n"); return 1; }
@@ -101,7 +1116,10 @@ int main(int argc, char** argv) {
         if (fields.glassColor >= CommonColor_End) { std::fprintf(stderr, "glassColor out of range (0-99)\n"); return 1; }
         if (fields.glassType >= GlassType_End)  { std::fprintf(stderr, "glassType out of range (0-19)\n"); return 1; }
 
-        NxInVer3Pack::Pack(fields, mii);
+        NxInVer3Pack::Pack(fields, Ver3MiiFileView(mii.data), encoding);
+        if (mii.size == Ver3StoreRecordSize) {
+            UpdateStoreDataCrc(mii.data);
+        }
 
         if (!WriteMiiFile(argv[3], mii)) {
             return 1;
@@ -113,13 +1131,16 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        Ver3MiiDataCore mii{};
+        MiiFileData mii{};
         if (!ReadMiiFile(argv[2], mii)) {
             return 1;
         }
 
         NxExtensionFields out{};
-        NxInVer3Pack::Unpack(mii, out);
+        if (!NxInVer3Pack::TryUnpack(Ver3MiiFileConstView(mii.data), out)) {
+            std::fprintf(stderr, "No extension data found (missing flag or bad checksum).\n");
+            return 1;
+        }
 
         std::printf("Faceline Color: %u\n", out.facelineColor);
         std::printf("Hair Color:     %u\n", out.hairColor);
@@ -130,6 +1151,29 @@ int main(int argc, char** argv) {
         std::printf("Glass Color:    %u\n", out.glassColor);
         std::printf("Glass Type:     %u\n", out.glassType);
 
+    } else if (std::strcmp(mode, "verify") == 0) {
+        if (argc != 3) {
+            ShowUsage(argv[0]);
+            return 1;
+        }
+
+        MiiFileData mii{};
+        if (!ReadMiiFile(argv[2], mii)) {
+            return 1;
+        }
+        if (mii.size != Ver3StoreRecordSize) {
+            std::fprintf(stderr, "Error: only 96-byte Miis have a checksum.\n");
+            return 1;
+        }
+
+        const u16 computed = ComputeStoreDataCrc(mii.data);
+        if (!VerifyStoreDataCrc(mii.data)) {
+            std::printf("Checksum mismatch: stored %02X%02X, computed %04X\n",
+                mii.data[Ver3StoreDataCrcOffset], mii.data[Ver3StoreDataCrcOffset + 1], computed);
+            return 1;
+        }
+        std::printf("Checksum OK: %04X\n", computed);
+
     } else {
         ShowUsage(argv[0]);
         return 1;
@@ -0,0 +1,374 @@
+#include "src/NxInVer3Pack.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Exhaustive Pack/Unpack checks, kept apart from NxInVer3PackTest.cpp because
+// they take a while: build and run these after changing any table or layout.
+//
+// g++ -std=c++20 -O2 -I. src/NxInVer3Pack.cpp NxInVer3PackExhaustiveTest.cpp -lgtest -lgtest_main -lpthread
+
+namespace {
+
+// // ---------------------------------------------------------------
+// //  Work-Stealing Runner
+// // ---------------------------------------------------------------
+
+/// Half-open range of work item indices.
+struct WorkRange {
+    u64 begin;
+    u64 end;
+};
+
+/// Items per queued range. Small enough to balance, large enough that locking is negligible.
+constexpr u64 WorkChunkSize = 4096;
+
+/// Result of a sharded run.
+struct RunResult {
+    u64 items;
+    u64 failures;
+    u64 firstFailure; ///< Lowest failing item index, or UINT64_MAX.
+    double seconds;
+    unsigned threads;
+};
+
+/**
+ * @brief Calls `check(index)` for every index in [0, count), on all host cores.
+ * @details Each thread starts with its own contiguous share of chunks and takes
+ *          from the back of its queue. Threads that run out steal from the front
+ *          of the other queues, so uneven chunks don't leave cores idle.
+ * @param check Returns false for a failing item. Must be thread-safe.
+ */
+template <typename Check>
+RunResult RunSharded(u64 count, Check check) {
+    struct Queue {
+        std::mutex lock;
+        std::deque<WorkRange> ranges;
+    };
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::unique_ptr<Queue[]> queues(new Queue[threads]);
+
+    const u64 share = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        const u64 end = std::min(count, (t + 1) * share);
+        for (u64 begin = t * share; begin < end; begin += WorkChunkSize) {
+            queues[t].ranges.push_back({ begin, std::min(end, begin + WorkChunkSize) });
+        }
+    }
+
+    std::atomic<u64> failures{ 0 };
+    std::atomic<u64> firstFailure{ UINT64_MAX };
+
+    auto take = [&](unsigned self, WorkRange& out) {
+        for (unsigned k = 0; k < threads; ++k) {
+            Queue& queue = queues[(self + k) % threads];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (queue.ranges.empty()) {
+                continue;
+            }
+            if (k == 0) {
+                out = queue.ranges.back();
+                queue.ranges.pop_back();
+            } else {
+                out = queue.ranges.front();
+                queue.ranges.pop_front();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    auto worker = [&](unsigned self) {
+        WorkRange range{};
+        while (take(self, range)) {
+            for (u64 i = range.begin; i < range.end; ++i) {
+                if (check(i)) {
+                    continue;
+                }
+                failures.fetch_add(1, std::memory_order_relaxed);
+                u64 seen = firstFailure.load(std::memory_order_relaxed);
+                while (i < seen && !firstFailure.compare_exchange_weak(seen, i)) {
+                }
+            }
+        }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return { count, failures.load(), firstFailure.load(), elapsed.count(), threads };
+}
+
+void Report(const char* name, const RunResult& result) {
+    std::printf("[ EXHAUST  ] %s: %llu Miis in %.2f s, %.2f M Miis/s on %u threads\n",
+        name, static_cast<unsigned long long>(result.items), result.seconds,
+        static_cast<double>(result.items) / result.seconds / 1e6, result.threads);
+}
+
+// // ---------------------------------------------------------------
+// //  Mii Generation
+// // ---------------------------------------------------------------
+
+constexpr u64 SplitMix64(u64 x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/// Random Mii data: every field, including all padding and room bits, is noise.
+void FillRandom(u8 (&data)[Ver3CoreRecordSize], u64 seed) {
+    for (std::size_t i = 0; i < Ver3CoreRecordSize; i += 8) {
+        const u64 word = SplitMix64(seed + i);
+        std::memcpy(data + i, &word, 8);
+    }
+}
+
+/// Random in-range extension fields.
+NxExtensionFields RandomFields(u64 seed) {
+    u64 r = SplitMix64(seed);
+    NxExtensionFields out{};
+    out.facelineColor = static_cast<u8>(r % FacelineColor_End); r /= FacelineColor_End;
+    out.hairColor     = static_cast<u8>(r % CommonColor_End);   r /= CommonColor_End;
+    out.eyeColor      = static_cast<u8>(r % CommonColor_End);   r /= CommonColor_End;
+    out.eyebrowColor  = static_cast<u8>(r % CommonColor_End);   r /= CommonColor_End;
+    out.mouthColor    = static_cast<u8>(r % CommonColor_End);   r /= CommonColor_End;
+    out.beardColor    = static_cast<u8>(r % CommonColor_End);   r /= CommonColor_End;
+    out.glassColor    = static_cast<u8>(r % CommonColor_End);   r /= CommonColor_End;
+    out.glassType     = static_cast<u8>(r % GlassType_End);
+    return out;
+}
+
+/// Sets every bit of the fields that hold the extra block. roomIndex/positionInRoom
+/// only get 3 bits of it, but Pack() still writes their whole field.
+template <std::endian Order, std::size_t... I>
+void SetPaddingFields(Ver3MiiView<Order> view, std::index_sequence<I...>) {
+    (view.template Set<Ver3PaddingSchema[I].field>(~0u), ...);
+}
+
+/// Bytes with a 1 in every bit that Pack() may write: the visible colors and the extra block.
+template <std::endian Order>
+std::array<u8, Ver3CoreRecordSize> PackedBitsMask() {
+    std::array<u8, Ver3CoreRecordSize> mask{};
+    const Ver3MiiView<Order> view(mask.data());
+    view.template Set<Ver3Field::FaceColor>(~0u);
+    view.template Set<Ver3Field::HairColor>(~0u);
+    view.template Set<Ver3Field::EyeColor>(~0u);
+    view.template Set<Ver3Field::EyebrowColor>(~0u);
+    view.template Set<Ver3Field::MouthColor>(~0u);
+    view.template Set<Ver3Field::BeardColor>(~0u);
+    view.template Set<Ver3Field::GlassColor>(~0u);
+    view.template Set<Ver3Field::GlassType>(~0u);
+    SetPaddingFields(view, std::make_index_sequence<Ver3PaddingSchema.size()>{});
+    return mask;
+}
+
+/**
+ * @brief Packs `in` over random data, then checks that it unpacks to the same
+ *        fields, and that every bit outside of the packed ones was left alone.
+ */
+template <std::endian Order>
+bool CheckRoundTrip(const NxExtensionFields& in, ExtraEncoding encoding, u64 seed) {
+    static const std::array<u8, Ver3CoreRecordSize> mask = PackedBitsMask<Order>();
+
+    u8 before[Ver3CoreRecordSize];
+    FillRandom(before, seed);
+    u8 data[Ver3CoreRecordSize];
+    std::memcpy(data, before, sizeof(data));
+
+    NxInVer3Pack::Pack(in, Ver3MiiView<Order>(data), encoding);
+    for (std::size_t i = 0; i < Ver3CoreRecordSize; ++i) {
+        if (((before[i] ^ data[i]) & ~mask[i]) != 0) {
+            return false;
+        }
+    }
+
+    const Ver3MiiView<Order, const u8> view(data);
+    // roomIndex/positionInRoom must stay in range for the system to accept the data.
+    if (view.template Get<Ver3Field::RoomIndex>() > 9 || view.template Get<Ver3Field::PositionInRoom>() > 9) {
+        return false;
+    }
+    NxExtensionFields out{};
+    return NxInVer3Pack::TryUnpack(view, out) && std::memcmp(&in, &out, sizeof(in)) == 0;
+}
+
+/// Either byte order, chosen by the item index.
+bool CheckRoundTrip(const NxExtensionFields& in, ExtraEncoding encoding, u64 index) {
+    return (index & 1) != 0
+        ? CheckRoundTrip<std::endian::big>(in, encoding, index)
+        : CheckRoundTrip<std::endian::little>(in, encoding, index);
+}
+
+// // ---------------------------------------------------------------
+// //  Per-Field Access
+// // ---------------------------------------------------------------
+// Fields in GroupIndices order, so that each one can be swept with a runtime index.
+
+constexpr std::size_t FieldCount = 8;
+
+constexpr u8 NxInVer3Pack::GroupIndices::* GroupIndexMembers[FieldCount] = {
+    &NxInVer3Pack::GroupIndices::faceGI,  &NxInVer3Pack::GroupIndices::hairGI,
+    &NxInVer3Pack::GroupIndices::eyeGI,   &NxInVer3Pack::GroupIndices::browGI,
+    &NxInVer3Pack::GroupIndices::mouthGI, &NxInVer3Pack::GroupIndices::beardGI,
+    &NxInVer3Pack::GroupIndices::glassColorGI, &NxInVer3Pack::GroupIndices::glassTypeGI,
+};
+
+constexpr u8 NxExtensionFields::* FieldMembers[FieldCount] = {
+    &NxExtensionFields::facelineColor, &NxExtensionFields::hairColor,
+    &NxExtensionFields::eyeColor,      &NxExtensionFields::eyebrowColor,
+    &NxExtensionFields::mouthColor,    &NxExtensionFields::beardColor,
+    &NxExtensionFields::glassColor,    &NxExtensionFields::glassType,
+};
+
+constexpr Ver3Field VisibleFields[FieldCount] = {
+    Ver3Field::FaceColor,  Ver3Field::HairColor,  Ver3Field::EyeColor,   Ver3Field::EyebrowColor,
+    Ver3Field::MouthColor, Ver3Field::BeardColor, Ver3Field::GlassColor, Ver3Field::GlassType,
+};
+
+/// Bucket size for each visible value of field `field`.
+u32 BucketSize(std::size_t field, u32 ver3) {
+    switch (field) {
+        case 0:  return FusedFaceColors.counts[ver3];
+        case 2:  return FusedEyeColors.counts[ver3];
+        case 4:  return FusedMouthColors.counts[ver3];
+        case 6:  return FusedGlassColors.counts[ver3];
+        case 7:  return FusedGlassTypes.counts[ver3];
+        default: return FusedHairColors.counts[ver3];
+    }
+}
+
+/// Width of each group index in the fixed-width encoding.
+constexpr std::size_t GroupIndexWidth(std::size_t field) {
+    return GroupIndexSchema[field].width;
+}
+
+void SetVisible(Ver3MiiFileView view, std::size_t field, u32 value) {
+    switch (field) {
+        case 0:  view.Set<Ver3Field::FaceColor>(value);    break;
+        case 1:  view.Set<Ver3Field::HairColor>(value);    break;
+        case 2:  view.Set<Ver3Field::EyeColor>(value);     break;
+        case 3:  view.Set<Ver3Field::EyebrowColor>(value); break;
+        case 4:  view.Set<Ver3Field::MouthColor>(value);   break;
+        case 5:  view.Set<Ver3Field::BeardColor>(value);   break;
+        case 6:  view.Set<Ver3Field::GlassColor>(value);   break;
+        default: view.Set<Ver3Field::GlassType>(value);    break;
+    }
+}
+
+} // namespace
+
+// // ---------------------------------------------------------------
+// //  Tests
+// // ---------------------------------------------------------------
+
+TEST(NxInVer3PackExhaustive, AllVisibleValuesAndGroupIndices)
+{
+    // Every (visible Ver3 value, group index) a field can hold, including those
+    // that Pack() never writes: valid ones must unpack to a Ver4 index that packs
+    // back to the same pair, and the rest must be rejected.
+    u64 items = 0;
+    for (std::size_t field = 0; field < FieldCount; ++field) {
+        const u32 ver3Range = 1u << Ver3FieldDescs[static_cast<std::size_t>(VisibleFields[field])].width;
+        const u32 groupRange = 1u << GroupIndexWidth(field);
+        for (u32 ver3 = 0; ver3 < ver3Range; ++ver3) {
+            for (u32 group = 0; group < groupRange; ++group, ++items) {
+                u8 data[Ver3CoreRecordSize] = {};
+                const Ver3MiiFileView view(data);
+                SetVisible(view, field, ver3);
+                NxInVer3Pack::GroupIndices gi{};
+                gi.*GroupIndexMembers[field] = static_cast<u8>(group);
+                NxInVer3Pack::WriteMarkedBlock(gi, ExtraEncoding_FixedWidth, view);
+
+                NxExtensionFields out{};
+                const bool valid = group < BucketSize(field, ver3);
+                ASSERT_EQ(NxInVer3Pack::TryUnpack(Ver3MiiFileConstView(data), out), valid)
+                    << "field " << field << ", ver3 " << ver3 << ", group " << group;
+                if (!valid) {
+                    continue;
+                }
+
+                u8 repacked[Ver3CoreRecordSize] = {};
+                NxInVer3Pack::Pack(out, Ver3MiiFileView(repacked));
+                ASSERT_EQ(std::memcmp(data, repacked, sizeof(data)), 0)
+                    << "field " << field << ", ver3 " << ver3 << ", group " << group
+                    << ", ver4 " << int(out.*FieldMembers[field]);
+            }
+        }
+    }
+    std::printf("[ EXHAUST  ] %llu (field, ver3, group index) combinations\n", static_cast<unsigned long long>(items));
+}
+
+/// Fields [first, first + 4) take every combination of Ver4 values, the others are random.
+/// Four fields are one mixed-radix digit group, so this covers every value of each group.
+static void SweepDigitGroup(const char* name, std::size_t first, ExtraEncoding encoding)
+{
+    constexpr u32 ranges[FieldCount] = {
+        FacelineColor_End, CommonColor_End, CommonColor_End, CommonColor_End,
+        CommonColor_End, CommonColor_End, CommonColor_End, GlassType_End,
+    };
+    u64 count = 1;
+    for (std::size_t field = first; field < first + 4; ++field) {
+        count *= ranges[field];
+    }
+
+    const RunResult result = RunSharded(count, [&](u64 index) {
+        NxExtensionFields in = RandomFields(index ^ (u64(encoding) << 40) ^ (u64(first) << 48));
+        u64 rest = index;
+        for (std::size_t field = first; field < first + 4; ++field) {
+            in.*FieldMembers[field] = static_cast<u8>(rest % ranges[field]);
+            rest /= ranges[field];
+        }
+        return CheckRoundTrip(in, encoding, index);
+    });
+    Report(name, result);
+    EXPECT_EQ(result.failures, 0u) << "first failing index: " << result.firstFailure;
+}
+
+TEST(NxInVer3PackExhaustive, FixedWidth_FaceHairEyeEyebrow)
+{
+    SweepDigitGroup("fixed-width face x hair x eye x eyebrow", 0, ExtraEncoding_FixedWidth);
+}
+
+TEST(NxInVer3PackExhaustive, FixedWidth_MouthBeardGlass)
+{
+    SweepDigitGroup("fixed-width mouth x beard x glass color x glass type", 4, ExtraEncoding_FixedWidth);
+}
+
+TEST(NxInVer3PackExhaustive, MixedRadix_FaceHairEyeEyebrow)
+{
+    SweepDigitGroup("mixed-radix face x hair x eye x eyebrow", 0, ExtraEncoding_MixedRadix);
+}
+
+TEST(NxInVer3PackExhaustive, MixedRadix_MouthBeardGlass)
+{
+    SweepDigitGroup("mixed-radix mouth x beard x glass color x glass type", 4, ExtraEncoding_MixedRadix);
+}
+
+TEST(NxInVer3PackExhaustive, RandomTuples)
+{
+    // Whole random tuples over random data, for combinations across both groups.
+    constexpr u64 count = 20'000'000;
+    const RunResult result = RunSharded(count, [](u64 index) {
+        const ExtraEncoding encoding = (index & 2) != 0 ? ExtraEncoding_MixedRadix : ExtraEncoding_FixedWidth;
+        return CheckRoundTrip(RandomFields(~index), encoding, index);
+    });
+    Report("random tuples", result);
+    EXPECT_EQ(result.failures, 0u) << "first failing index: " << result.firstFailure;
+}
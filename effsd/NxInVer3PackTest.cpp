@@ -1,6 +1,10 @@
 #include "src/NxInVer3Pack.hpp"
+#include "src/NxCommonColors.hpp"
+#include "src/NxOverrideDb.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 /// Initializes Ver3MiiDataCore data to a clean baseline.
 /// We deliberately set visible color fields to zero,
@@ -156,3 +160,683 @@ TEST(NxInVer3Pack, RoundTrip_GlassType_0_to_19)
         Verify(mii);
     }
 }
+
+// // ---------------------------------------------------------------
+// //  Detection
+// // ---------------------------------------------------------------
+
+/// Extension fields that touch every group index.
+static NxExtensionFields GetAllFields() {
+    NxExtensionFields in{};
+    in.facelineColor = 9; in.hairColor = 99; in.eyeColor = 43; in.eyebrowColor = 47;
+    in.mouthColor = 8; in.beardColor = 73; in.glassColor = 23; in.glassType = 19;
+    return in;
+}
+
+TEST(NxInVer3Pack, Detect_PlainDataRejected)
+{
+    Ver3MiiDataCore mii = GetCleanData();
+    NxExtensionFields out{};
+    EXPECT_FALSE(NxInVer3Pack::QuickDetect(mii));
+    EXPECT_FALSE(NxInVer3Pack::TryUnpack(mii, out));
+}
+
+TEST(NxInVer3Pack, Detect_PackedDataAccepted)
+{
+    Ver3MiiDataCore mii = GetCleanData();
+    const NxExtensionFields in = GetAllFields();
+    NxInVer3Pack::Pack(in, mii);
+
+    EXPECT_TRUE(NxInVer3Pack::QuickDetect(mii));
+    NxExtensionFields out{};
+    ASSERT_TRUE(NxInVer3Pack::TryUnpack(mii, out));
+    EXPECT_EQ(std::memcmp(&in, &out, sizeof(in)), 0);
+}
+
+TEST(NxInVer3Pack, Detect_FlagInRawPadding6)
+{
+    Ver3MiiDataCore mii = GetCleanData();
+    NxInVer3Pack::Pack(GetAllFields(), mii);
+    // Flag is bit 1 of padding_6.
+    EXPECT_NE(mii.padding_6 & 0b10, 0);
+    mii.padding_6 = static_cast<u8>(mii.padding_6 & 0xFDu);
+    EXPECT_FALSE(NxInVer3Pack::QuickDetect(mii));
+}
+
+TEST(NxInVer3Pack, Detect_EditedVisibleColorRejected)
+{
+    Ver3MiiDataCore mii = GetCleanData();
+    NxInVer3Pack::Pack(GetAllFields(), mii);
+
+    // As if an old editor changed the hair color without knowing about eFFSD.
+    mii.hairColor = (mii.hairColor + 1) & 7;
+    NxExtensionFields out{};
+    EXPECT_FALSE(NxInVer3Pack::TryUnpack(mii, out));
+}
+
+TEST(NxInVer3Pack, Detect_CorruptedBlockRejected)
+{
+    Ver3MiiDataCore base = GetCleanData();
+    NxInVer3Pack::Pack(GetAllFields(), base);
+
+    ExtraDataBlock block{};
+    NxInVer3Pack::ExtractExtra(base, block);
+
+    // Flip each bit of the group indices and checksum; none may still pass.
+    int accepted = 0;
+    for (std::size_t bit = 0; bit < ExtraReservedBit; ++bit) {
+        if (bit >= ExtraFlagBit && bit < ExtraChecksumBit) {
+            continue; // Flag/encoding are covered by QuickDetect().
+        }
+        ExtraDataBlock corrupt = block;
+        corrupt.data[bit >> 3] = static_cast<u8>(corrupt.data[bit >> 3] ^ (1u << (bit & 7)));
+        Ver3MiiDataCore mii = base;
+        NxInVer3Pack::WriteExtra(mii, corrupt);
+
+        NxExtensionFields out{};
+        accepted += NxInVer3Pack::TryUnpack(mii, out) ? 1 : 0;
+    }
+    // A 6-bit checksum lets some single flips through by chance, but not many.
+    EXPECT_LE(accepted, 3);
+}
+
+TEST(NxInVer3Pack, MixedRadix_RoundTrip)
+{
+    Ver3MiiDataCore mii = GetCleanData();
+    u32 seed = 1234;
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        NxExtensionFields in{};
+        in.facelineColor = static_cast<u8>((seed >> 4) % FacelineColor_End);
+        in.hairColor     = static_cast<u8>((seed >> 8) % CommonColor_End);
+        in.eyeColor      = static_cast<u8>((seed >> 12) % CommonColor_End);
+        in.eyebrowColor  = static_cast<u8>((seed >> 16) % CommonColor_End);
+        in.mouthColor    = static_cast<u8>((seed >> 20) % CommonColor_End);
+        in.beardColor    = static_cast<u8>(i % CommonColor_End);
+        in.glassColor    = static_cast<u8>((i / 7) % CommonColor_End);
+        in.glassType     = static_cast<u8>((seed >> 24) % GlassType_End);
+
+        NxInVer3Pack::Pack(in, mii, ExtraEncoding_MixedRadix);
+
+        ExtraDataBlock block{};
+        NxInVer3Pack::ExtractExtra(mii, block);
+        const u64 encoding = GetField<ExtraBlockSchema, ExtraBlock_Encoding>(LoadBlock(block));
+        ASSERT_EQ(encoding, ExtraEncoding_MixedRadix);
+
+        NxExtensionFields out{};
+        ASSERT_TRUE(NxInVer3Pack::TryUnpack(mii, out)) << "iteration " << i;
+        ASSERT_EQ(std::memcmp(&in, &out, sizeof(in)), 0) << "iteration " << i;
+        Verify(mii);
+    }
+}
+
+TEST(NxInVer3Pack, MixedRadix_CorruptedBlockRejected)
+{
+    Ver3MiiDataCore base = GetCleanData();
+    NxInVer3Pack::Pack(GetAllFields(), base, ExtraEncoding_MixedRadix);
+
+    ExtraDataBlock block{};
+    NxInVer3Pack::ExtractExtra(base, block);
+
+    int accepted = 0;
+    for (std::size_t bit = 0; bit < ExtraReservedBit; ++bit) {
+        if (bit >= ExtraFlagBit && bit < ExtraChecksumBit) {
+            continue;
+        }
+        ExtraDataBlock corrupt = block;
+        corrupt.data[bit >> 3] = static_cast<u8>(corrupt.data[bit >> 3] ^ (1u << (bit & 7)));
+        Ver3MiiDataCore mii = base;
+        NxInVer3Pack::WriteExtra(mii, corrupt);
+
+        NxExtensionFields out{};
+        accepted += NxInVer3Pack::TryUnpack(mii, out) ? 1 : 0;
+    }
+    // The bits freed by the mixed-radix digits extend the checksum.
+    EXPECT_EQ(accepted, 0);
+}
+
+// // ---------------------------------------------------------------
+// //  Ver3MiiView
+// // ---------------------------------------------------------------
+
+/// Fills Mii data with deterministic pseudo-random bytes.
+static void FillPattern(u8* data, std::size_t size, u32 seed) {
+    for (std::size_t i = 0; i < size; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        data[i] = static_cast<u8>(seed >> 24);
+    }
+}
+
+/// Reverses the bytes of every 16/32-bit unit described in Ver3FieldDescs.
+static void SwapUnits(u8* data) {
+    std::size_t lastOffset = SIZE_MAX;
+    for (const Ver3FieldDesc& desc : Ver3FieldDescs) {
+        if (desc.offset == lastOffset) {
+            continue;
+        }
+        lastOffset = desc.offset;
+        for (std::size_t i = 0; i < desc.size / 2u; ++i) {
+            std::swap(data[desc.offset + i], data[desc.offset + desc.size - 1 - i]);
+        }
+    }
+}
+
+TEST(Ver3MiiView, MatchesBitfieldStruct)
+{
+    for (u32 seed = 0; seed < 64; ++seed) {
+        Ver3MiiDataCore mii{};
+        FillPattern(reinterpret_cast<u8*>(&mii), sizeof(mii), seed);
+        const Ver3MiiNativeConstView view = ViewOf(mii);
+
+        // At least one field from each unit, plus the edges of the wider ones.
+        EXPECT_EQ(view.Get<Ver3Field::MiiVersion>(),     mii.miiVersion);
+        EXPECT_EQ(view.Get<Ver3Field::RoomIndex>(),      mii.roomIndex);
+        EXPECT_EQ(view.Get<Ver3Field::BirthPlatform>(),  mii.birthPlatform);
+        EXPECT_EQ(view.Get<Ver3Field::Reserved1>(),      mii.reserved_1);
+        EXPECT_EQ(view.Get<Ver3Field::Reserved2_1>(),    mii.reserved_2[1]);
+        EXPECT_EQ(view.Get<Ver3Field::BirthDay>(),       mii.birthDay);
+        EXPECT_EQ(view.Get<Ver3Field::Build>(),          mii.build);
+        EXPECT_EQ(view.Get<Ver3Field::FaceColor>(),      mii.faceColor);
+        EXPECT_EQ(view.Get<Ver3Field::HairFlip>(),       mii.hairFlip);
+        EXPECT_EQ(view.Get<Ver3Field::EyeAspect>(),      mii.eyeAspect);
+        EXPECT_EQ(view.Get<Ver3Field::EyeY>(),           mii.eyeY);
+        EXPECT_EQ(view.Get<Ver3Field::EyebrowColor>(),   mii.eyebrowColor);
+        EXPECT_EQ(view.Get<Ver3Field::Padding4>(),       mii.padding_4);
+        EXPECT_EQ(view.Get<Ver3Field::NoseScale>(),      mii.noseScale);
+        EXPECT_EQ(view.Get<Ver3Field::MouthColor>(),     mii.mouthColor);
+        EXPECT_EQ(view.Get<Ver3Field::Padding6>(),       mii.padding_6);
+        EXPECT_EQ(view.Get<Ver3Field::BeardY>(),         mii.beardY);
+        EXPECT_EQ(view.Get<Ver3Field::GlassType>(),      mii.glassType);
+        EXPECT_EQ(view.Get<Ver3Field::MoleX>(),          mii.moleX);
+        EXPECT_EQ(view.Get<Ver3Field::Padding8>(),       mii.padding_8);
+    }
+}
+
+TEST(Ver3MiiView, SetOnlyTouchesField)
+{
+    u8 data[sizeof(Ver3MiiDataCore)];
+    FillPattern(data, sizeof(data), 1234);
+    u8 expected[sizeof(data)];
+    std::memcpy(expected, data, sizeof(data));
+
+    const Ver3MiiFileView view(data);
+    const u32 before = view.Get<Ver3Field::EyebrowScale>();
+    view.Set<Ver3Field::EyebrowScale>(~before);
+    EXPECT_EQ(view.Get<Ver3Field::EyebrowScale>(), ~before & 0xF);
+    view.Set<Ver3Field::EyebrowScale>(before);
+    EXPECT_EQ(std::memcmp(data, expected, sizeof(data)), 0);
+}
+
+TEST(Ver3MiiView, PackIsSameInBothByteOrders)
+{
+    const NxExtensionFields in = GetAllFields();
+
+    u8 little[sizeof(Ver3MiiDataCore)];
+    FillPattern(little, sizeof(little), 42);
+    u8 big[sizeof(little)];
+    std::memcpy(big, little, sizeof(little));
+    SwapUnits(big);
+
+    NxInVer3Pack::Pack(in, Ver3MiiView<std::endian::little>(little));
+    NxInVer3Pack::Pack(in, Ver3MiiView<std::endian::big>(big));
+
+    // Same data, just with every unit swapped.
+    SwapUnits(big);
+    EXPECT_EQ(std::memcmp(little, big, sizeof(little)), 0);
+
+    NxExtensionFields out{};
+    ASSERT_TRUE(NxInVer3Pack::TryUnpack(Ver3MiiFileConstView(little), out));
+    EXPECT_EQ(std::memcmp(&in, &out, sizeof(in)), 0);
+}
+
+// // ---------------------------------------------------------------
+// //  Batch API
+// // ---------------------------------------------------------------
+
+/// Owns the arrays behind an NxExtensionFieldsSoA.
+struct SoAStorage {
+    std::vector<u8> fields[8];
+    explicit SoAStorage(std::size_t count) {
+        for (std::vector<u8>& field : fields) {
+            field.assign(count, 0);
+        }
+    }
+    NxExtensionFieldsSoA View() {
+        return { fields[0].data(), fields[1].data(), fields[2].data(), fields[3].data(),
+                 fields[4].data(), fields[5].data(), fields[6].data(), fields[7].data() };
+    }
+    void Set(std::size_t i, const NxExtensionFields& in) {
+        // NxExtensionFields is 8 u8s, in the same order as NxExtensionFieldsSoA.
+        const u8* bytes = reinterpret_cast<const u8*>(&in);
+        for (std::size_t f = 0; f < 8; ++f) {
+            fields[f][i] = bytes[f];
+        }
+    }
+    NxExtensionFields Get(std::size_t i) const {
+        NxExtensionFields out{};
+        u8* bytes = reinterpret_cast<u8*>(&out);
+        for (std::size_t f = 0; f < 8; ++f) {
+            bytes[f] = fields[f][i];
+        }
+        return out;
+    }
+};
+
+TEST(NxInVer3Pack, Batch_MatchesSingle)
+{
+    constexpr std::size_t count = 200; // Not a multiple of the chunk size.
+    constexpr std::size_t stride = Ver3StoreRecordSize;
+
+    SoAStorage in(count);
+    std::vector<u8> batch(count * stride);
+    FillPattern(batch.data(), batch.size(), 7);
+    std::vector<u8> single = batch;
+
+    u32 seed = 99;
+    for (std::size_t i = 0; i < count; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        NxExtensionFields fields{};
+        fields.facelineColor = static_cast<u8>((seed >> 8) % FacelineColor_End);
+        fields.hairColor     = static_cast<u8>((seed >> 12) % CommonColor_End);
+        fields.eyeColor      = static_cast<u8>((seed >> 16) % CommonColor_End);
+        fields.eyebrowColor  = static_cast<u8>((seed >> 20) % CommonColor_End);
+        fields.mouthColor    = static_cast<u8>((i * 7) % CommonColor_End);
+        fields.beardColor    = static_cast<u8>((i * 13) % CommonColor_End);
+        fields.glassColor    = static_cast<u8>((i * 31) % CommonColor_End);
+        fields.glassType     = static_cast<u8>(i % GlassType_End);
+        in.Set(i, fields);
+        NxInVer3Pack::Pack(fields, Ver3MiiFileView(single.data() + i * stride));
+    }
+
+    NxInVer3Pack::PackBatch<std::endian::little>(in.View(), batch.data(), count, stride);
+    EXPECT_EQ(batch, single);
+
+    // Clear the flag on every other record, leaving the group indices intact.
+    for (std::size_t i = 1; i < count; i += 2) {
+        Ver3MiiFileView mii(batch.data() + i * stride);
+        const u32 padding = mii.Get<Ver3Field::Padding6>();
+        mii.Set<Ver3Field::Padding6>(padding & ~(1u << (ExtraFlagBit - ExtraPadding6Bit)));
+    }
+
+    SoAStorage out(count);
+    std::vector<u8> detected(count);
+    const std::size_t found = NxInVer3Pack::UnpackBatch<std::endian::little>(
+        batch.data(), count, stride, out.View(), detected.data());
+    EXPECT_EQ(found, count / 2);
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(detected[i], (i % 2) == 0 ? 1 : 0);
+        const NxExtensionFields expected = in.Get(i);
+        const NxExtensionFields actual = out.Get(i);
+        EXPECT_EQ(std::memcmp(&expected, &actual, sizeof(expected)), 0) << "record " << i;
+    }
+}
+
+TEST(NxInVer3Pack, FusedTables_MatchReverseMaps)
+{
+    for (std::size_t i = 0; i < ToVer3HairColorTable.size(); ++i) {
+        const u8 encoded = FusedHairColors.encode[i];
+        const std::size_t v3 = encoded / FusedHairColors.MaxGroupSize;
+        const std::size_t gi = encoded % FusedHairColors.MaxGroupSize;
+        EXPECT_EQ(v3, ToVer3HairColorTable[i]);
+        EXPECT_EQ(gi, RevHairColors.positionInGroup[i]);
+        EXPECT_EQ(FusedHairColors.decode[(v3 << FusedHairColors.GroupBits) | gi], i);
+    }
+    // Past the end of a bucket: clamped to its last entry.
+    const std::size_t count = RevMouthColors.counts[0];
+    const std::size_t groups = std::size_t(1) << FusedMouthColors.GroupBits;
+    for (std::size_t gi = count; gi < groups; ++gi) {
+        EXPECT_EQ(FusedMouthColors.decode[gi], RevMouthColors.byGroup[0][count - 1]);
+    }
+    // Ver3 value with no bucket: falls back to bucket 0.
+    const std::size_t emptyV3 = 7;
+    EXPECT_EQ(FusedGlassColors.counts[emptyV3], 0);
+    EXPECT_EQ(FusedGlassColors.decode[emptyV3 << FusedGlassColors.GroupBits], RevGlassColors.byGroup[0][0]);
+}
+
+// // ---------------------------------------------------------------
+// //  Ver3StoreData Checksum
+// // ---------------------------------------------------------------
+
+/// The Mii from the README example, in the file format with a valid CRC.
+static constexpr u8 ExampleStoreData[Ver3StoreRecordSize] = {
+    0x03, 0x00, 0x00, 0x40, 0x64, 0x34, 0x3A, 0x58, 0x80, 0x27, 0x86, 0x4B, 0xD7, 0x1F, 0x33, 0x18,
+    0xED, 0x56, 0x69, 0x2D, 0x0C, 0x3D, 0x00, 0x00, 0x01, 0x28, 0x62, 0x00, 0x6C, 0x00, 0x61, 0x00,
+    0x6E, 0x00, 0x63, 0x00, 0x6F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0x00,
+    0x12, 0x10, 0x7B, 0x04, 0x5C, 0x6E, 0x44, 0x1C, 0x8D, 0x64, 0xC7, 0x18, 0x00, 0x08, 0x19, 0x24,
+    0x0D, 0x00, 0x20, 0x41, 0xB3, 0x5B, 0x83, 0x5D, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB8, 0xC9,
+};
+
+/// One bit at a time, straight from the definition.
+static u16 ComputeCrc16Bitwise(const u8* data, std::size_t size) {
+    u32 crc = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc ^= u32(data[i]) << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) != 0 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return static_cast<u16>(crc);
+}
+
+TEST(Ver3StoreData, Crc16_MatchesBitwise)
+{
+    const char check[] = "123456789";
+    EXPECT_EQ(ComputeCrc16(reinterpret_cast<const u8*>(check), 9), 0x31C3); // CRC-16/XMODEM check value.
+
+    u8 data[256];
+    FillPattern(data, sizeof(data), 7);
+    for (std::size_t size = 0; size <= sizeof(data); ++size) {
+        EXPECT_EQ(ComputeCrc16(data, size), ComputeCrc16Bitwise(data, size)) << "size " << size;
+    }
+    // Continuing from a previous CRC is the same as one call over both parts.
+    EXPECT_EQ(ComputeCrc16(data + 13, 100, ComputeCrc16(data, 13)), ComputeCrc16(data, 113));
+}
+
+TEST(Ver3StoreData, UpdateAndVerify)
+{
+    u8 store[Ver3StoreRecordSize];
+    std::memcpy(store, ExampleStoreData, sizeof(store));
+    EXPECT_TRUE(VerifyStoreDataCrc(store));
+
+    // Packing changes the Mii, so the old CRC no longer matches.
+    NxInVer3Pack::Pack(GetAllFields(), Ver3MiiFileView(store));
+    EXPECT_FALSE(VerifyStoreDataCrc(store));
+    UpdateStoreDataCrc(store);
+    EXPECT_TRUE(VerifyStoreDataCrc(store));
+    // Creator name and the CRC itself are left alone by Pack().
+    EXPECT_EQ(std::memcmp(store + Ver3CoreRecordSize, ExampleStoreData + Ver3CoreRecordSize,
+        Ver3StoreDataCrcOffset - Ver3CoreRecordSize), 0);
+
+    store[Ver3CoreRecordSize] ^= 1;
+    EXPECT_FALSE(VerifyStoreDataCrc(store));
+}
+
+// // ---------------------------------------------------------------
+// //  amiibo Import
+// // ---------------------------------------------------------------
+
+TEST(AmiiboImport, ExtractFromDump)
+{
+    const NxExtensionFields fields = GetAllFields();
+    u8 store[Ver3StoreRecordSize];
+    std::memcpy(store, ExampleStoreData, sizeof(store));
+    NxInVer3Pack::Pack(fields, Ver3MiiFileView(store));
+    UpdateStoreDataCrc(store);
+
+    // What a Switch writes: the converted Mii and the extension it came from.
+    std::vector<u8> dump(540);
+    dump[AmiiboFlagsOffset] = AmiiboFlagHasOwnerMii;
+    std::memcpy(dump.data() + AmiiboMiiOffset, store, sizeof(store));
+    std::memcpy(dump.data() + AmiiboExtensionOffset, &fields, sizeof(fields));
+
+    u8 outStore[Ver3StoreRecordSize];
+    NxExtensionFields outFields{};
+    ASSERT_EQ(ExtractAmiiboMii(dump.data(), dump.size(), outStore, outFields), AmiiboImport_Success);
+    EXPECT_EQ(std::memcmp(outStore, store, sizeof(store)), 0);
+    EXPECT_EQ(std::memcmp(&outFields, &fields, sizeof(fields)), 0);
+    EXPECT_TRUE(NxInVer3Pack::MatchesVisible(outFields, Ver3MiiFileConstView(outStore)));
+
+    EXPECT_EQ(ExtractAmiiboMii(dump.data(), 539, outStore, outFields), AmiiboImport_UnknownSize);
+    dump[AmiiboMiiOffset + 1] ^= 1;
+    EXPECT_EQ(ExtractAmiiboMii(dump.data(), dump.size(), outStore, outFields), AmiiboImport_BadChecksum);
+    dump[AmiiboFlagsOffset] = 0;
+    EXPECT_EQ(ExtractAmiiboMii(dump.data(), dump.size(), outStore, outFields), AmiiboImport_NoOwnerMii);
+}
+
+TEST(AmiiboImport, StaleExtensionDoesNotMatch)
+{
+    u8 raw[StoreDataWithExtensionSize];
+    std::memcpy(raw, ExampleStoreData, Ver3StoreRecordSize);
+    NxExtensionFields fields = GetAllFields();
+    NxInVer3Pack::Pack(fields, Ver3MiiFileView(raw));
+    UpdateStoreDataCrc(raw);
+
+    // Changed on a 3DS/Wii U afterwards: the eye color no longer comes from the extension.
+    Ver3MiiFileView(raw).Set<Ver3Field::EyeColor>(ToVer3EyeColorTable[fields.eyeColor] ^ 1);
+    UpdateStoreDataCrc(raw);
+    std::memcpy(raw + Ver3StoreRecordSize, &fields, sizeof(fields));
+
+    u8 outStore[Ver3StoreRecordSize];
+    NxExtensionFields outFields{};
+    ASSERT_EQ(ExtractAmiiboMii(raw, sizeof(raw), outStore, outFields), AmiiboImport_Success);
+    EXPECT_FALSE(NxInVer3Pack::MatchesVisible(outFields, Ver3MiiFileConstView(outStore)));
+
+    fields.eyeColor = CommonColor_End;
+    EXPECT_FALSE(NxInVer3Pack::MatchesVisible(fields, Ver3MiiFileConstView(outStore)));
+}
+
+// // ---------------------------------------------------------------
+// //  Switch CharInfo Export
+// // ---------------------------------------------------------------
+
+TEST(NxCharInfo, UsesExtensionColors)
+{
+    const Ver3MiiFileConstView plain(ExampleStoreData);
+    NxCharInfo info{};
+    EXPECT_FALSE(NxInVer3Pack::ToCharInfo(plain, info));
+    EXPECT_EQ(info.hairColor, FromVer3HairColorTable[plain.Get<Ver3Field::HairColor>()]);
+    EXPECT_EQ(info.glassColor, FromVer3GlassColorTable[plain.Get<Ver3Field::GlassColor>()]);
+    EXPECT_EQ(info.height, plain.Get<Ver3Field::Height>());
+    EXPECT_EQ(info.mustacheY, plain.Get<Ver3Field::BeardY>());
+    EXPECT_EQ(info.nickname[0], u'b');
+    EXPECT_EQ(info.nickname[MII_NAME_LENGTH], 0);
+    EXPECT_EQ(info.createId[6] >> 4, 4);
+
+    u8 store[Ver3StoreRecordSize];
+    std::memcpy(store, ExampleStoreData, sizeof(store));
+    const NxExtensionFields fields = GetAllFields();
+    NxInVer3Pack::Pack(fields, Ver3MiiFileView(store));
+    NxCharInfo packed{};
+    EXPECT_TRUE(NxInVer3Pack::ToCharInfo(Ver3MiiFileConstView(store), packed));
+    EXPECT_EQ(packed.facelineColor, fields.facelineColor);
+    EXPECT_EQ(packed.hairColor, fields.hairColor);
+    EXPECT_EQ(packed.eyeColor, fields.eyeColor);
+    EXPECT_EQ(packed.eyebrowColor, fields.eyebrowColor);
+    EXPECT_EQ(packed.mouthColor, fields.mouthColor);
+    EXPECT_EQ(packed.beardColor, fields.beardColor);
+    EXPECT_EQ(packed.glassColor, fields.glassColor);
+    EXPECT_EQ(packed.glassType, fields.glassType);
+    // Packing only touches colors and unused bits, so nothing else changes.
+    EXPECT_EQ(std::memcmp(packed.createId, info.createId, sizeof(info.createId)), 0);
+    EXPECT_EQ(packed.eyeType, info.eyeType);
+    EXPECT_EQ(packed.moleY, info.moleY);
+}
+
+TEST(NxCharInfo, BatchMatchesSingle)
+{
+    constexpr std::size_t count = 300; // Not a multiple of the chunk size.
+    std::vector<u8> records(count * Ver3StoreRecordSize);
+    for (std::size_t i = 0; i < count; ++i) {
+        u8* record = records.data() + i * Ver3StoreRecordSize;
+        std::memcpy(record, ExampleStoreData, Ver3StoreRecordSize);
+        if (i % 3 != 0) {
+            NxExtensionFields fields = GetAllFields();
+            fields.hairColor = static_cast<u8>(i % CommonColor_End);
+            fields.glassType = static_cast<u8>(i % GlassType_End);
+            NxInVer3Pack::Pack(fields, Ver3MiiFileView(record));
+        }
+    }
+
+    std::vector<NxCharInfo> batch(count);
+    EXPECT_EQ((NxInVer3Pack::ToCharInfoBatch<std::endian::little>(records.data(), count, Ver3StoreRecordSize, batch.data())),
+        count - (count + 2) / 3);
+    for (std::size_t i = 0; i < count; ++i) {
+        NxCharInfo single{};
+        NxInVer3Pack::ToCharInfo(Ver3MiiFileConstView(records.data() + i * Ver3StoreRecordSize), single);
+        EXPECT_EQ(std::memcmp(&single, &batch[i], sizeof(single)), 0) << "record " << i;
+    }
+}
+
+// // ---------------------------------------------------------------
+// //  Common Color Quantizer
+// // ---------------------------------------------------------------
+
+TEST(NxCommonColors, PaletteColorsMapToThemselves)
+{
+    for (std::size_t i = 0; i < NxCommonColorsSrgb.size(); ++i) {
+        const NxSrgb8 expected = NxCommonColorsSrgb[i];
+        const NxSrgb8 found = NxCommonColorsSrgb[FindNearestColor(expected, NxColorPalette_Common)];
+        EXPECT_TRUE(found.r == expected.r && found.g == expected.g && found.b == expected.b) << "color " << i;
+    }
+    for (std::size_t i = 0; i < NxFacelineColorsSrgb.size(); ++i) {
+        EXPECT_EQ(FindNearestColor(NxFacelineColorsSrgb[i], NxColorPalette_Faceline), i);
+    }
+}
+
+TEST(NxCommonColors, LutMatchesExactSearch)
+{
+    // Random colors, then every color in a slab of cells around black, where
+    // the cube root in OKLab makes palette regions smallest.
+    constexpr std::size_t count = 20000;
+    std::vector<u8> bytes(count * 3);
+    FillPattern(bytes.data(), bytes.size(), 11);
+    std::vector<NxSrgb8> colors(count);
+    std::memcpy(colors.data(), bytes.data(), bytes.size());
+    constexpr u32 slab = 2u << (8 - ColorLutBits);
+    for (u32 r = 0; r < slab; ++r) {
+        for (u32 g = 0; g < 256; ++g) {
+            for (u32 b = 0; b < 256; ++b) {
+                colors.push_back({ static_cast<u8>(r), static_cast<u8>(g), static_cast<u8>(b) });
+            }
+        }
+    }
+    colors.push_back({ 16, 0, 0 });
+
+    for (const NxColorPalette palette : { NxColorPalette_Common, NxColorPalette_Faceline }) {
+        std::vector<u8> batch(colors.size());
+        QuantizeColors(colors.data(), colors.size(), palette, batch.data());
+        for (std::size_t i = 0; i < colors.size(); ++i) {
+            const NxSrgb8 c = colors[i];
+            ASSERT_EQ(batch[i], QuantizeColor(c, palette));
+            ASSERT_EQ(batch[i], FindNearestColor(c, palette))
+                << "palette " << palette << ", color " << int(c.r) << " " << int(c.g) << " " << int(c.b);
+        }
+    }
+}
+
+TEST(NxCommonColors, ParseHexColor)
+{
+    NxSrgb8 color{};
+    ASSERT_TRUE(ParseHexColor("#FF8001", 7, color));
+    EXPECT_EQ(color.r, 0xFF);
+    EXPECT_EQ(color.g, 0x80);
+    EXPECT_EQ(color.b, 0x01);
+    ASSERT_TRUE(ParseHexColor("a0b0c0", 6, color));
+    EXPECT_EQ(color.g, 0xB0);
+    EXPECT_FALSE(ParseHexColor("#FF80", 5, color));
+    EXPECT_FALSE(ParseHexColor("#GG8001", 7, color));
+    EXPECT_FALSE(ParseHexColor("FF80011", 7, color));
+}
+
+// // ---------------------------------------------------------------
+// //  Override Database
+// // ---------------------------------------------------------------
+
+/// Entries with distinct create IDs that share their last 6 bytes, like Miis from one console.
+static std::vector<NxOverrideDbEntry> MakeOverrideEntries(std::size_t count) {
+    std::vector<NxOverrideDbEntry> entries(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        NxOverrideDbEntry& entry = entries[i];
+        const u32 id = static_cast<u32>(i * 2654435761u) | 0x80000000u;
+        entry.createId[0] = static_cast<u8>(id >> 24);
+        entry.createId[1] = static_cast<u8>(id >> 16);
+        entry.createId[2] = static_cast<u8>(id >> 8);
+        entry.createId[3] = static_cast<u8>(id);
+        std::memset(entry.createId + 4, 0xA5, 6);
+        entry.fields = {
+            static_cast<u8>(i % FacelineColor_End), static_cast<u8>(i % CommonColor_End),
+            static_cast<u8>((i + 1) % CommonColor_End), static_cast<u8>((i + 2) % CommonColor_End),
+            static_cast<u8>((i + 3) % CommonColor_End), static_cast<u8>((i + 4) % CommonColor_End),
+            static_cast<u8>((i + 5) % CommonColor_End), static_cast<u8>(i % GlassType_End),
+        };
+    }
+    return entries;
+}
+
+TEST(NxOverrideDb, FindsEveryEntry)
+{
+    const std::vector<NxOverrideDbEntry> entries = MakeOverrideEntries(50000);
+    std::size_t duplicates = 1;
+    NxOverrideDb db;
+    ASSERT_EQ(db.Load(NxOverrideDb::Build(entries, {}, duplicates)), NxOverrideDb_Success);
+    EXPECT_EQ(duplicates, 0u);
+    EXPECT_EQ(db.Count(), entries.size());
+
+    for (const NxOverrideDbEntry& entry : entries) {
+        const NxExtensionFields* found = db.Find(entry.createId);
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(std::memcmp(found, &entry.fields, sizeof(entry.fields)), 0);
+    }
+    u8 missing[sizeof(Ver3CreateId)] = {};
+    EXPECT_EQ(db.Find(missing), nullptr);
+}
+
+TEST(NxOverrideDb, LastDuplicateWins)
+{
+    std::vector<NxOverrideDbEntry> entries = MakeOverrideEntries(3);
+    entries.push_back(entries[1]);
+    entries.back().fields.hairColor = 42;
+    std::size_t duplicates = 0;
+    NxOverrideDb db;
+    ASSERT_EQ(db.Load(NxOverrideDb::Build(entries, {}, duplicates)), NxOverrideDb_Success);
+    EXPECT_EQ(duplicates, 1u);
+    EXPECT_EQ(db.Count(), 3u);
+    ASSERT_NE(db.Find(entries[1].createId), nullptr);
+    EXPECT_EQ(db.Find(entries[1].createId)->hairColor, 42);
+}
+
+TEST(NxOverrideDb, RejectsBadFiles)
+{
+    std::size_t duplicates = 0;
+    const std::vector<u8> good = NxOverrideDb::Build(MakeOverrideEntries(4), {}, duplicates);
+    NxOverrideDb db;
+
+    std::vector<u8> file = good;
+    file[0] = 'X';
+    EXPECT_EQ(db.Load(file), NxOverrideDb_BadHeader);
+    file = good;
+    file[4] = NxOverrideDbVersion + 1;
+    EXPECT_EQ(db.Load(file), NxOverrideDb_BadVersion);
+    file = good;
+    file.pop_back();
+    EXPECT_EQ(db.Load(file), NxOverrideDb_Truncated);
+    // Swap the first two entries.
+    file = good;
+    std::swap_ranges(file.begin() + 16, file.begin() + 16 + 18, file.begin() + 16 + 18);
+    EXPECT_EQ(db.Load(file), NxOverrideDb_Unsorted);
+    file = good;
+    file[16 + 10 + 7] = GlassType_End; // glassType of the first entry.
+    EXPECT_EQ(db.Load(file), NxOverrideDb_OutOfRange);
+    EXPECT_EQ(db.Count(), 0u);
+
+    EXPECT_EQ(db.Load(good), NxOverrideDb_Success);
+    EXPECT_EQ(db.Count(), 4u);
+}
+
+TEST(NxOverrideDb, CustomColors)
+{
+    std::vector<NxOverrideDbEntry> entries = MakeOverrideEntries(2);
+    entries[0].fields.hairColor = NxOverrideDbColor_Begin + 1;
+    const std::vector<NxSrgb8> colors = { { 1, 2, 3 }, { 4, 5, 6 } };
+    std::size_t duplicates = 0;
+    const std::vector<u8> good = NxOverrideDb::Build(entries, colors, duplicates);
+    NxOverrideDb db;
+    ASSERT_EQ(db.Load(good), NxOverrideDb_Success);
+    ASSERT_EQ(db.ColorCount(), 2u);
+    const NxExtensionFields* found = db.Find(entries[0].createId);
+    ASSERT_NE(found, nullptr);
+    ASSERT_EQ(found->hairColor, NxOverrideDbColor_Begin + 1);
+    EXPECT_EQ(db.Colors()[found->hairColor - NxOverrideDbColor_Begin].g, 5);
+
+    // Referring to a color past the end.
+    std::vector<u8> file = good;
+    file[12] = 1; // colorCount
+    EXPECT_EQ(db.Load(file), NxOverrideDb_OutOfRange);
+    // Version 1 had no colors, so its reserved field is ignored.
+    file = NxOverrideDb::Build(MakeOverrideEntries(2), {}, duplicates);
+    file[4] = 1;
+    file[12] = 0xFF;
+    EXPECT_EQ(db.Load(file), NxOverrideDb_Success);
+    EXPECT_EQ(db.ColorCount(), 0u);
+}
@@ -0,0 +1,323 @@
+#include "NxCommonColors.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// // ---------------------------------------------------------------
+// //  OKLab
+// // ---------------------------------------------------------------
+// https://bottosson.github.io/posts/oklab/
+
+struct OkLab {
+    float L, a, b;
+};
+
+/// sRGB transfer function, for each 8-bit value.
+static const std::array<float, 256> SrgbToLinear = [] {
+    std::array<float, 256> out{};
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        const double c = static_cast<double>(i) / 255.0;
+        out[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+    }
+    return out;
+}();
+
+/// Cone responses of linear sRGB, before the cube root. Every coefficient is
+/// positive, so each one only grows with r, g and b.
+static void LinearToLms(float r, float g, float b, float& l, float& m, float& s) {
+    l = 0.4122214708f * r + 0.5363325363f * g + 0.0514459929f * b;
+    m = 0.2119034982f * r + 0.6806995451f * g + 0.1073969566f * b;
+    s = 0.0883024619f * r + 0.2817188376f * g + 0.6299787005f * b;
+}
+
+/// OKLab from the cube roots of the cone responses. Linear.
+static OkLab LmsRootsToOkLab(float l, float m, float s) {
+    return {
+        0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+        1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+        0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s,
+    };
+}
+
+static OkLab ToOkLab(NxSrgb8 color) {
+    float l, m, s;
+    LinearToLms(SrgbToLinear[color.r], SrgbToLinear[color.g], SrgbToLinear[color.b], l, m, s);
+    return LmsRootsToOkLab(std::cbrt(l), std::cbrt(m), std::cbrt(s));
+}
+
+static float DistanceSquared(const OkLab& x, const OkLab& y) {
+    const float dL = x.L - y.L;
+    const float da = x.a - y.a;
+    const float db = x.b - y.b;
+    return dL * dL + da * da + db * db;
+}
+
+// // ---------------------------------------------------------------
+// //  Palettes
+// // ---------------------------------------------------------------
+
+/// A palette converted to OKLab.
+struct OkLabPalette {
+    std::array<OkLab, CommonColor_End> colors;
+    std::size_t count;
+};
+
+static OkLabPalette MakeOkLabPalette(const NxSrgb8* colors, std::size_t count) {
+    OkLabPalette out{};
+    out.count = count;
+    for (std::size_t i = 0; i < count; ++i) {
+        out.colors[i] = ToOkLab(colors[i]);
+    }
+    return out;
+}
+
+static const OkLabPalette& GetOkLabPalette(NxColorPalette palette) {
+    static const OkLabPalette palettes[NxColorPalette_Count] = {
+        MakeOkLabPalette(NxCommonColorsSrgb.data(), NxCommonColorsSrgb.size()),
+        MakeOkLabPalette(NxFacelineColorsSrgb.data(), NxFacelineColorsSrgb.size()),
+    };
+    return palettes[palette];
+}
+
+/// Ties go to the lowest index, so duplicate palette entries resolve the same way every time.
+static u8 FindNearest(const OkLab& lab, const OkLabPalette& palette) {
+    std::size_t best = 0;
+    float bestDistance = DistanceSquared(lab, palette.colors[0]);
+    for (std::size_t i = 1; i < palette.count; ++i) {
+        const float distance = DistanceSquared(lab, palette.colors[i]);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return static_cast<u8>(best);
+}
+
+u8 FindNearestColor(NxSrgb8 color, NxColorPalette palette) {
+    return FindNearest(ToOkLab(color), GetOkLabPalette(palette));
+}
+
+// // ---------------------------------------------------------------
+// //  Lookup Table
+// // ---------------------------------------------------------------
+
+static constexpr std::size_t ColorLutSize = std::size_t(1) << ColorLutBits;
+static constexpr std::size_t ColorLutShift = 8 - ColorLutBits;
+
+/// Nearest palette color for every color in each cell, or if that depends on
+/// the color, the few palette colors that can be nearest anywhere in the cell.
+struct ColorLut {
+    /// Indexed by [r][g][b] cell. A palette index, ColorLutMixed + the offset
+    /// of the cell's candidates, or ColorLutSearchAll.
+    u16 cells[ColorLutSize * ColorLutSize * ColorLutSize];
+    /// Lists of candidates, shared by cells that have the same ones:
+    /// how many, then their palette indices in ascending order.
+    std::vector<u8> candidates;
+};
+
+static constexpr u16 ColorLutMixed = 0x100;
+/// For a cell whose candidates didn't fit in `candidates`. Never used by the palettes here.
+static constexpr u16 ColorLutSearchAll = 0xFFFF;
+
+/// Linear bounds on the cube root over [lo, hi], as `offset + slope * t`.
+/// The cube root is concave, so it's above its chord and below its tangents.
+struct CbrtBounds {
+    float chordOffset, chordSlope;
+    float tangentOffset, tangentSlope;
+};
+
+static CbrtBounds MakeCbrtBounds(float lo, float hi) {
+    CbrtBounds out{};
+    const float rootLo = std::cbrt(lo);
+    out.chordSlope = hi > lo ? (std::cbrt(hi) - rootLo) / (hi - lo) : 0.0f;
+    out.chordOffset = rootLo - out.chordSlope * lo;
+    const float mid = (lo + hi) / 2;
+    const float rootMid = std::cbrt(mid);
+    out.tangentSlope = 1.0f / (3.0f * rootMid * rootMid);
+    out.tangentOffset = rootMid - out.tangentSlope * mid;
+    return out;
+}
+
+/// Palette colors that can be nearest to some color in the cell from `lo` to `hi`.
+/// How much closer a winner is than another palette color is linear in OKLab, which is
+/// linear in the cube roots of the cone responses. Bounding each cube root by
+/// its chord or tangent gives a lower bound that's linear in the cone
+/// responses, which are linear in linear sRGB, where the cell is a box. So if
+/// the bound is positive at all 8 corners, the winner is closer everywhere in
+/// the cell, and the other can't be nearest there.
+static void FindCandidates(const OkLabPalette& palette, NxSrgb8 lo, NxSrgb8 hi, std::vector<u8>& out) {
+    float cornerLms[8][3];
+    // Palette colors nearest to a corner, which are the ones most likely to rule out the others.
+    u8 winners[8];
+    std::size_t winnerCount = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        const NxSrgb8 corner = { (i & 4) ? hi.r : lo.r, (i & 2) ? hi.g : lo.g, (i & 1) ? hi.b : lo.b };
+        float* lms = cornerLms[i];
+        LinearToLms(SrgbToLinear[corner.r], SrgbToLinear[corner.g], SrgbToLinear[corner.b], lms[0], lms[1], lms[2]);
+        const u8 nearest = FindNearest(LmsRootsToOkLab(std::cbrt(lms[0]), std::cbrt(lms[1]), std::cbrt(lms[2])), palette);
+        if (std::find(winners, winners + winnerCount, nearest) == winners + winnerCount) {
+            winners[winnerCount++] = nearest;
+        }
+    }
+    // Each cone response grows with r, g and b, so its range is from the first corner to the last.
+    CbrtBounds bounds[3];
+    for (std::size_t k = 0; k < 3; ++k) {
+        bounds[k] = MakeCbrtBounds(cornerLms[0][k], cornerLms[7][k]);
+    }
+    // Columns of LmsRootsToOkLab(): what each cube root adds to OKLab.
+    const OkLab columns[3] = { LmsRootsToOkLab(1, 0, 0), LmsRootsToOkLab(0, 1, 0), LmsRootsToOkLab(0, 0, 1) };
+
+    for (std::size_t j = 0; j < palette.count; ++j) {
+        const OkLab& other = palette.colors[j];
+        bool ruledOut = false;
+        for (std::size_t w = 0; w < winnerCount && !ruledOut; ++w) {
+            if (winners[w] == j) {
+                continue;
+            }
+            const OkLab& winner = palette.colors[winners[w]];
+            // |x - other|^2 - |x - winner|^2 = offset + sum of weight[k] * cube root k.
+            const OkLab diff = { other.L - winner.L, other.a - winner.a, other.b - winner.b };
+            float offset = (other.L * other.L + other.a * other.a + other.b * other.b) -
+                           (winner.L * winner.L + winner.a * winner.a + winner.b * winner.b);
+            float slopes[3];
+            for (std::size_t k = 0; k < 3; ++k) {
+                const float weight = -2.0f * (columns[k].L * diff.L + columns[k].a * diff.a + columns[k].b * diff.b);
+                const bool chord = weight >= 0.0f;
+                offset += weight * (chord ? bounds[k].chordOffset : bounds[k].tangentOffset);
+                slopes[k] = weight * (chord ? bounds[k].chordSlope : bounds[k].tangentSlope);
+            }
+            ruledOut = true;
+            for (std::size_t c = 0; c < 8 && ruledOut; ++c) {
+                // With a margin for rounding, which can only add candidates.
+                ruledOut = offset + slopes[0] * cornerLms[c][0] + slopes[1] * cornerLms[c][1] + slopes[2] * cornerLms[c][2] > 1e-6f;
+            }
+        }
+        if (!ruledOut) {
+            out.push_back(static_cast<u8>(j));
+        }
+    }
+}
+
+static void BuildColorLut(const OkLabPalette& palette, ColorLut& lut) {
+    constexpr u32 cellMax = (1u << ColorLutShift) - 1;
+    std::map<std::vector<u8>, u16> offsets;
+    std::vector<u8> found;
+    std::size_t cell = 0;
+    for (u32 r = 0; r < ColorLutSize; ++r) {
+        for (u32 g = 0; g < ColorLutSize; ++g) {
+            for (u32 b = 0; b < ColorLutSize; ++b) {
+                const NxSrgb8 lo = {
+                    static_cast<u8>(r << ColorLutShift),
+                    static_cast<u8>(g << ColorLutShift),
+                    static_cast<u8>(b << ColorLutShift),
+                };
+                const NxSrgb8 hi = { static_cast<u8>(lo.r | cellMax), static_cast<u8>(lo.g | cellMax), static_cast<u8>(lo.b | cellMax) };
+                found.clear();
+                FindCandidates(palette, lo, hi, found);
+                if (found.size() == 1) {
+                    lut.cells[cell++] = found[0];
+                    continue;
+                }
+                const auto [it, added] = offsets.try_emplace(found, ColorLutSearchAll);
+                if (added && lut.candidates.size() < ColorLutSearchAll - ColorLutMixed) {
+                    it->second = static_cast<u16>(ColorLutMixed + lut.candidates.size());
+                    lut.candidates.push_back(static_cast<u8>(found.size()));
+                    lut.candidates.insert(lut.candidates.end(), found.begin(), found.end());
+                }
+                lut.cells[cell++] = it->second;
+            }
+        }
+    }
+}
+
+/// Allocated on first use, so programs that only use FindNearestColor() don't carry the tables.
+static const ColorLut& GetColorLut(NxColorPalette palette) {
+    static std::unique_ptr<ColorLut> luts[NxColorPalette_Count];
+    static std::once_flag built[NxColorPalette_Count];
+    std::call_once(built[palette], [palette] {
+        luts[palette].reset(new ColorLut);
+        BuildColorLut(GetOkLabPalette(palette), *luts[palette]);
+    });
+    return *luts[palette];
+}
+
+static u8 LookUp(const ColorLut& lut, const OkLabPalette& palette, NxSrgb8 color) {
+    const std::size_t cell =
+        (std::size_t(color.r >> ColorLutShift) << (ColorLutBits * 2)) |
+        (std::size_t(color.g >> ColorLutShift) << ColorLutBits) |
+        std::size_t(color.b >> ColorLutShift);
+    const u16 entry = lut.cells[cell];
+    if (entry < ColorLutMixed) {
+        return static_cast<u8>(entry);
+    }
+    const OkLab lab = ToOkLab(color);
+    if (entry == ColorLutSearchAll) {
+        return FindNearest(lab, palette);
+    }
+
+    // Ascending, so ties go to the lowest index like FindNearest().
+    const u8* candidates = &lut.candidates[entry - ColorLutMixed];
+    const std::size_t count = *candidates++;
+    u8 best = candidates[0];
+    float bestDistance = DistanceSquared(lab, palette.colors[best]);
+    for (std::size_t i = 1; i < count; ++i) {
+        const float distance = DistanceSquared(lab, palette.colors[candidates[i]]);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = candidates[i];
+        }
+    }
+    return best;
+}
+
+u8 QuantizeColor(NxSrgb8 color, NxColorPalette palette) {
+    return LookUp(GetColorLut(palette), GetOkLabPalette(palette), color);
+}
+
+void QuantizeColors(const NxSrgb8* colors, std::size_t count, NxColorPalette palette, u8* outIndices) {
+    const ColorLut& lut = GetColorLut(palette);
+    const OkLabPalette& okLab = GetOkLabPalette(palette);
+    for (std::size_t i = 0; i < count; ++i) {
+        outIndices[i] = LookUp(lut, okLab, colors[i]);
+    }
+}
+
+bool ParseHexColor(const char* text, std::size_t length, NxSrgb8& out) {
+    if (length == 7 && text[0] == '#') {
+        ++text;
+        --length;
+    }
+    if (length != 6) {
+        return false;
+    }
+    u32 value = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        const char c = text[i];
+        u32 digit = 0;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<u32>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<u32>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<u32>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        value = value << 4 | digit;
+    }
+    out = { static_cast<u8>(value >> 16), static_cast<u8>(value >> 8), static_cast<u8>(value) };
+    return true;
+}
+
+extern "C" {
+    void NxInVer3Pack_QuantizeColors(const u8* rgb, u32 count, u32 palette, u8* outIndices) {
+        static_assert(sizeof(NxSrgb8) == 3);
+        if (palette >= NxColorPalette_Count) {
+            return;
+        }
+        QuantizeColors(reinterpret_cast<const NxSrgb8*>(rgb), count, static_cast<NxColorPalette>(palette), outIndices);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+/**
+ * @file NxCommonColors.hpp
+ * @brief Switch common/faceline color palettes, and nearest-color lookup
+ *        from arbitrary sRGB colors to their indices.
+ *
+ * Distances are measured in OKLab, where Euclidean distance is close to
+ * perceived difference. Lookups go through a 32x32x32 table built on first use,
+ * so each one is a single load. FindNearestColor() searches the palette exactly.
+ */
+
+#include "NxInVer3Pack.hpp"
+
+struct NxSrgb8 {
+    u8 r, g, b;
+};
+
+/// Which palette to quantize to.
+enum NxColorPalette {
+    NxColorPalette_Common,   ///< nn::mii CommonColorTable, for hair, eye, eyebrow, mouth, beard and glass colors.
+    NxColorPalette_Faceline, ///< nn::mii FacelineColorTable.
+    NxColorPalette_Count
+};
+
+// The sRGB colors of nn::mii's tables, as 8-bit values.
+// The plugin fills gNnMiiColorTables from these too (src/ffl_colors.cpp).
+
+inline constexpr auto NxCommonColorsSrgb = std::array<NxSrgb8, CommonColor_End>({{
+    /*  0: */ {  45,  40,  40 }, {  64,  32,  16 }, {  92,  24,  10 }, { 124,  58,  20 },
+    /*  4: */ { 120, 120, 128 }, {  78,  62,  16 }, { 136,  88,  24 }, { 208, 160,  74 },
+    /*  8: */ {   0,   0,   0 }, { 108, 112, 112 }, { 102,  60,  44 }, {  96,  94,  48 },
+    /* 12: */ {  70,  84, 168 }, {  56, 112,  88 }, {  96,  56,  16 }, { 168,  16,   8 },
+    /* 16: */ {  32,  48, 104 }, { 168,  96,   0 }, { 120, 112, 104 }, { 216,  82,   8 },
+    /* 20: */ { 240,  12,   8 }, { 245,  72,  72 }, { 240, 154, 116 }, { 140,  80,  64 },
+    /* 24: */ { 132,  38,  38 }, { 255, 115, 102 }, { 255, 166, 166 }, { 255, 192, 186 },
+    /* 28: */ { 115,  46,  59 }, { 153,  31,  61 }, { 138,  23,  62 }, { 181,  62,  66 },
+    /* 32: */ { 199,  30,  86 }, { 176,  83, 129 }, { 199,  84, 110 }, { 250, 117, 151 },
+    /* 36: */ { 252, 172, 201 }, { 255, 201, 216 }, {  49,  28,  64 }, {  55,  40,  61 },
+    /* 40: */ {  76,  24,  77 }, { 111,  66, 179 }, { 133,  92, 184 }, { 192, 131, 204 },
+    /* 44: */ { 168, 147, 201 }, { 197, 172, 230 }, { 238, 190, 250 }, { 210, 197, 237 },
+    /* 48: */ {  25,  31,  64 }, {  18,  63, 102 }, {  42, 130, 212 }, {  87, 180, 242 },
+    /* 52: */ { 122, 197, 222 }, { 137, 166, 250 }, { 132, 189, 250 }, { 161, 227, 255 },
+    /* 56: */ {  11,  46,  54 }, {   1,  61,  59 }, {  13,  79,  89 }, {  35, 102,  99 },
+    /* 60: */ {  48, 126, 140 }, {  79, 174, 176 }, { 122, 196, 158 }, { 127, 212, 192 },
+    /* 64: */ { 135, 229, 182 }, {  10,  74,  53 }, {  67, 122,   0 }, {   2, 117,  98 },
+    /* 68: */ {  54, 153, 112 }, {  75, 173,  26 }, { 146, 191,  10 }, {  99, 199, 136 },
+    /* 72: */ { 158, 224,  66 }, { 150, 222, 126 }, { 187, 242, 170 }, { 153, 147,  43 },
+    /* 76: */ { 166, 149,  99 }, { 204, 192,  57 }, { 204, 185, 135 }, { 217, 204, 130 },
+    /* 80: */ { 213, 217, 111 }, { 213, 230, 131 }, { 216, 250, 157 }, { 125,  69,   0 },
+    /* 84: */ { 230, 187, 122 }, { 254, 226,  74 }, { 250, 222, 130 }, { 247, 234, 156 },
+    /* 88: */ { 250, 248, 155 }, { 166,  77,  30 }, { 255, 150,  13 }, { 209, 155, 105 },
+    /* 92: */ { 255, 178, 102 }, { 255, 194, 140 }, { 229, 207, 177 }, {  65,  65,  65 },
+    /* 96: */ { 155, 155, 155 }, { 190, 190, 190 }, { 220, 215, 205 }, { 255, 255, 255 },
+}});
+
+inline constexpr auto NxFacelineColorsSrgb = std::array<NxSrgb8, FacelineColor_End>({{
+    /*  0: */ { 255, 211, 173 }, { 255, 182, 107 }, { 222, 121,  66 }, { 255, 170, 140 }, { 173,  81,  41 },
+    /*  5: */ {  99,  44,  24 }, { 255, 190, 165 }, { 255, 197, 143 }, { 140,  60,  35 }, {  60,  45,  35 },
+}});
+
+/// Bits per channel of the lookup table: 32 cells per channel.
+static constexpr std::size_t ColorLutBits = 5;
+
+/// @return Index of the palette color closest to `color` in OKLab. Searches the whole palette.
+u8 FindNearestColor(NxSrgb8 color, NxColorPalette palette);
+
+/// @brief FindNearestColor() through a lookup table, for the cell that `color` falls in.
+/// @detail Cells with one nearest palette color for all their colors return it. The
+///         rest (about 40% for the common palette) search only the few palette colors
+///         that can be nearest there, so the result is always FindNearestColor()'s.
+///         The table is allocated and built on first use for each palette (about 70 KB
+///         each) and is thread-safe.
+u8 QuantizeColor(NxSrgb8 color, NxColorPalette palette);
+
+/// QuantizeColor() for `count` colors.
+void QuantizeColors(const NxSrgb8* colors, std::size_t count, NxColorPalette palette, u8* outIndices);
+
+/// @brief Parses a hex color: "#RRGGBB" or "RRGGBB".
+/// @return False if `text` is anything else.
+bool ParseHexColor(const char* text, std::size_t length, NxSrgb8& out);
+
+// C ABI wrappers.
+extern "C" {
+    /// `rgb` holds `count` colors of 3 bytes each. `palette` is an NxColorPalette.
+    void NxInVer3Pack_QuantizeColors(const u8* rgb, u32 count, u32 palette, u8* outIndices);
+}
@@ -1,81 +1,337 @@
 #include "NxInVer3Pack.hpp"
+#include <algorithm>
 #include <cassert>
-#include <cstring> // for std::memset
 
 // // ---------------------------------------------------------------
 // //  Group Index Helpers
 // // ---------------------------------------------------------------
 
-/// Returns the group index (position in bucket) for a given ver4 index using a reverse map.
-template <typename RevT>
-constexpr u8 GroupIndexOf(const RevT& rev, u8 ver4Index) {
-    return rev.positionInGroup[ver4Index];
+/// Splits a fused `encode` entry back into the visible ver3 value and group index.
+/// The divisor is a constant, so this is a multiply and shift.
+template <typename FusedT>
+constexpr void SplitEncoded(const FusedT& table, u8 ver4Index, u8& outVer3, u8& outGroupIndex) {
+    const u32 encoded = table.encode[ver4Index];
+    outVer3       = static_cast<u8>(encoded / FusedT::MaxGroupSize);
+    outGroupIndex = static_cast<u8>(encoded % FusedT::MaxGroupSize);
 }
 
-/// Reconstructs ver4 index from ver3 value and group index, with clamping for safety.
-template <typename RevT>
-constexpr u8 Ver4FromGroup(const RevT& rev, u8 ver3Value, u8 groupIndex) {
-    u16 count = rev.counts[ver3Value];
-    assert(count > 0);
-    if (groupIndex >= count) {
-        // Clamp to a valid entry to avoid out-of-range reads in corrupted cases.
-        groupIndex = static_cast<u8>(count - 1);
+/// Reconstructs ver4 index from ver3 value and group index.
+/// Out-of-range values are already clamped in the table, so any input is safe.
+template <typename FusedT>
+constexpr u8 Ver4FromGroup(const FusedT& table, u32 ver3Value, u32 groupIndex) {
+    constexpr u32 groupMask = (1u << FusedT::GroupBits) - 1u;
+    return table.decode[(ver3Value << FusedT::GroupBits) | (groupIndex & groupMask)];
+}
+
+// // ---------------------------------------------------------------
+// //  Mixed-Radix Coding
+// // ---------------------------------------------------------------
+// For ExtraEncoding_MixedRadix, the radix of each group index is the size of
+// the bucket that the visible Ver3 color selects, rather than the largest one.
+// The indices are split into two digit groups, so that each value stays small
+// enough for exact division with a 32x32 multiply.
+
+/// GroupIndices members in digit order, least significant first.
+static constexpr u8 NxInVer3Pack::GroupIndices::* GroupIndexMembers[] = {
+    &NxInVer3Pack::GroupIndices::faceGI,  &NxInVer3Pack::GroupIndices::hairGI,
+    &NxInVer3Pack::GroupIndices::eyeGI,   &NxInVer3Pack::GroupIndices::browGI,
+    &NxInVer3Pack::GroupIndices::mouthGI, &NxInVer3Pack::GroupIndices::beardGI,
+    &NxInVer3Pack::GroupIndices::glassColorGI, &NxInVer3Pack::GroupIndices::glassTypeGI,
+};
+static constexpr std::size_t GroupIndexCount = std::size(GroupIndexMembers);
+/// Digits [0, MixedRadixSplit) are the low value, the rest are the high value.
+static constexpr std::size_t MixedRadixSplit = 4;
+
+/// Largest possible radix, over all fields.
+static constexpr std::size_t MaxRadix = 64;
+static constexpr std::size_t RadixReciprocalShift = 31;
+/// ceil(2^31 / d) for each radix d. floor(x / d) == (x * r[d]) >> 31 for all x < 2^31 / d.
+static constexpr auto RadixReciprocals = [] {
+    std::array<u32, MaxRadix + 1> out{};
+    for (std::size_t d = 1; d <= MaxRadix; ++d) {
+        out[d] = static_cast<u32>(((u64(1) << RadixReciprocalShift) + d - 1) / d);
+    }
+    return out;
+}();
+
+/// Largest value of each digit group, for the largest buckets.
+constexpr u64 MaxDigitGroupProduct(std::size_t first, std::size_t last) {
+    constexpr std::size_t sizes[] = {
+        FusedFaceColors.MaxGroupSize, FusedHairColors.MaxGroupSize, FusedEyeColors.MaxGroupSize,
+        FusedHairColors.MaxGroupSize, FusedMouthColors.MaxGroupSize, FusedHairColors.MaxGroupSize,
+        FusedGlassColors.MaxGroupSize, FusedGlassTypes.MaxGroupSize,
+    };
+    u64 product = 1;
+    for (std::size_t i = first; i < last; ++i) {
+        product *= sizes[i];
+    }
+    return product;
+}
+static_assert(MaxDigitGroupProduct(0, MixedRadixSplit) * MaxRadix < (u64(1) << RadixReciprocalShift) &&
+              MaxDigitGroupProduct(MixedRadixSplit, GroupIndexCount) * MaxRadix < (u64(1) << RadixReciprocalShift),
+              "Digit groups are too large for exact reciprocal division.");
+static_assert(std::bit_width(MaxDigitGroupProduct(0, MixedRadixSplit) - 1) +
+              std::bit_width(MaxDigitGroupProduct(MixedRadixSplit, GroupIndexCount) - 1) <= UsedIndexBits,
+              "Mixed-radix digits must never need more bits than fixed-width group indices.");
+
+/// floor(x / d) for 1 <= d <= MaxRadix, and x within a digit group.
+constexpr u32 DivideByRadix(u32 x, u32 d) {
+    return static_cast<u32>((u64(x) * RadixReciprocals[d]) >> RadixReciprocalShift);
+}
+
+/// Bit layout of the group index field with ExtraEncoding_MixedRadix.
+/// It depends on the visible Ver3 colors:
+///   [low digits: lowBits][high digits: highBits][extended checksum: checkBits][zero]
+struct MixedRadixLayout {
+    u32 radix[GroupIndexCount]; ///< Bucket size for each group index, at least 1.
+    u32 lowBits;
+    u32 highBits;
+    u32 checkBits;
+};
+
+/// Bits of the 32-bit checksum hash are used up to this many beyond ExtraChecksumBits.
+static constexpr u32 MaxExtendedChecksumBits = 32 - ExtraChecksumBits;
+
+template <std::endian Order>
+static MixedRadixLayout GetMixedRadixLayout(Ver3MiiView<Order, const u8> mii)
+{
+    MixedRadixLayout layout{ {
+        FusedFaceColors.counts[mii.template Get<Ver3Field::FaceColor>()],
+        FusedHairColors.counts[mii.template Get<Ver3Field::HairColor>()],
+        FusedEyeColors.counts[mii.template Get<Ver3Field::EyeColor>()],
+        FusedHairColors.counts[mii.template Get<Ver3Field::EyebrowColor>()],
+        FusedMouthColors.counts[mii.template Get<Ver3Field::MouthColor>()],
+        FusedHairColors.counts[mii.template Get<Ver3Field::BeardColor>()],
+        FusedGlassColors.counts[mii.template Get<Ver3Field::GlassColor>()],
+        FusedGlassTypes.counts[mii.template Get<Ver3Field::GlassType>()],
+    }, 0, 0, 0 };
+
+    u32 low = 1;
+    u32 high = 1;
+    for (std::size_t i = 0; i < GroupIndexCount; ++i) {
+        // A Ver3 value with no bucket can't come from Pack(), but must not divide by zero.
+        layout.radix[i] = layout.radix[i] != 0 ? layout.radix[i] : 1;
+        (i < MixedRadixSplit ? low : high) *= layout.radix[i];
     }
-    return rev.byGroup[ver3Value][groupIndex];
+    layout.lowBits  = static_cast<u32>(std::bit_width(low - 1));
+    layout.highBits = static_cast<u32>(std::bit_width(high - 1));
+    const u32 freeBits = static_cast<u32>(UsedIndexBits) - layout.lowBits - layout.highBits;
+    layout.checkBits = freeBits < MaxExtendedChecksumBits ? freeBits : MaxExtendedChecksumBits;
+    return layout;
+}
+
+/// Digits [first, last) of `gi` as one value, most significant digit last.
+static u32 EncodeDigits(const NxInVer3Pack::GroupIndices& gi, const MixedRadixLayout& layout,
+    std::size_t first, std::size_t last)
+{
+    u32 value = 0;
+    for (std::size_t i = last; i-- > first;) {
+        value = value * layout.radix[i] + gi.*GroupIndexMembers[i];
+    }
+    return value;
+}
+
+static void DecodeDigits(u32 value, const MixedRadixLayout& layout,
+    std::size_t first, std::size_t last, NxInVer3Pack::GroupIndices& gi)
+{
+    for (std::size_t i = first; i < last; ++i) {
+        const u32 quotient = DivideByRadix(value, layout.radix[i]);
+        gi.*GroupIndexMembers[i] = static_cast<u8>(value - quotient * layout.radix[i]);
+        value = quotient;
+    }
+}
+
+// Checksum.
+
+/// 32-bit hash behind the checksum. The top bits are stored at ExtraChecksumBit.
+template <std::endian Order>
+static u32 ChecksumHash(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii)
+{
+    // Everything below the flag, plus the encoding: 38 bits.
+    const u64 word     = LoadBlock(inBlock);
+    u64 indices        = GetField<ExtraBlockSchema, ExtraBlock_GroupIndices>(word);
+    const u64 encoding = GetField<ExtraBlockSchema, ExtraBlock_Encoding>(word);
+    if (encoding == ExtraEncoding_MixedRadix) {
+        // Only the digits. The bits after them hold the extended checksum.
+        const MixedRadixLayout layout = GetMixedRadixLayout(mii);
+        indices &= BitMask(layout.lowBits + layout.highBits);
+    }
+    // Visible Ver3 colors, 3 bits each except for the 4-bit glass type: 25 bits.
+    const u32 visible =
+        mii.template Get<Ver3Field::FaceColor>()          | mii.template Get<Ver3Field::HairColor>()    << 3 |
+        mii.template Get<Ver3Field::EyeColor>()     << 6  | mii.template Get<Ver3Field::EyebrowColor>() << 9 |
+        mii.template Get<Ver3Field::MouthColor>()   << 12 | mii.template Get<Ver3Field::BeardColor>()   << 15 |
+        mii.template Get<Ver3Field::GlassColor>()   << 18 | mii.template Get<Ver3Field::GlassType>()    << 21;
+
+    // Multiply-xorshift over 32-bit lanes (no 64-bit multiplies on Espresso).
+    u32 h = static_cast<u32>(indices) * 0x9E3779B1u;
+    h ^= static_cast<u32>((indices >> 32) | (encoding << (UsedIndexBits - 32))) * 0x85EBCA77u;
+    h ^= visible * 0xC2B2AE3Du;
+    h ^= h >> 15;
+    h *= 0x27D4EB2Fu;
+    h ^= h >> 13;
+    return h;
+}
+
+/// The `bits` bits of the hash right below the ones in the checksum field.
+constexpr u32 ExtendedChecksum(u32 hash, u32 bits) {
+    return bits != 0 ? (hash << ExtraChecksumBits) >> (32 - bits) : 0;
+}
+
+template <std::endian Order>
+u8 NxInVer3Pack::ComputeChecksum(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii)
+{
+    // Top bits are the best mixed.
+    return static_cast<u8>(ChecksumHash(inBlock, mii) >> (32 - ExtraChecksumBits));
 }
 
 // Visible data packing.
 
-void NxInVer3Pack::Pack(const NxExtensionFields& ver4, Ver3MiiDataCore& mii)
+template <std::endian Order>
+void NxInVer3Pack::Pack(const NxExtensionFields& ver4, Ver3MiiView<Order> mii, ExtraEncoding encoding)
 {
-    // Map ver4 indices to visible ver3 indices that the system supports.
-    const u8 faceColorV3    = ToVer3FacelineColorTable[ver4.facelineColor];
-    const u8 hairColorV3    = ToVer3HairColorTable[ver4.hairColor];
-    const u8 eyeColorV3     = ToVer3EyeColorTable[ver4.eyeColor];
-    const u8 eyebrowColorV3 = ToVer3HairColorTable[ver4.eyebrowColor];
-    const u8 mouthColorV3   = ToVer3MouthColorTable[ver4.mouthColor];
-    const u8 beardColorV3   = ToVer3HairColorTable[ver4.beardColor];
-    const u8 glassColorV3   = ToVer3GlassColorTable[ver4.glassColor];
-    const u8 glassTypeV3    = ToVer3GlassTypeTable[ver4.glassType];
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wconversion"
-    // Write ver3 visible indices into Mii data.
-    mii.faceColor    = static_cast<u8>(faceColorV3);
-    mii.hairColor    = static_cast<u8>(hairColorV3);
-    mii.eyeColor     = static_cast<u8>(eyeColorV3);
-    mii.eyebrowColor = static_cast<u8>(eyebrowColorV3);
-    mii.mouthColor   = static_cast<u8>(mouthColorV3);
-    mii.beardColor   = static_cast<u8>(beardColorV3);
-    mii.glassColor   = static_cast<u8>(glassColorV3);
-    mii.glassType    = static_cast<u8>(glassTypeV3);
-#pragma GCC diagnostic pop
-
-    // Compute group indices to allow ver4 reconstruction.
+    // Map ver4 indices to visible ver3 indices that the system supports,
+    // along with group indices to allow ver4 reconstruction.
+    u8 v3[8];
     GroupIndices gi{};
-    gi.faceGI       = GroupIndexOf(RevFaceColors,  ver4.facelineColor);
-    gi.hairGI       = GroupIndexOf(RevHairColors,  ver4.hairColor);
-    gi.eyeGI        = GroupIndexOf(RevEyeColors,   ver4.eyeColor);
-    gi.browGI       = GroupIndexOf(RevHairColors,  ver4.eyebrowColor);
-    gi.mouthGI      = GroupIndexOf(RevMouthColors, ver4.mouthColor);
-    gi.beardGI      = GroupIndexOf(RevHairColors,  ver4.beardColor);
-    gi.glassColorGI = GroupIndexOf(RevGlassColors, ver4.glassColor);
-    gi.glassTypeGI  = GroupIndexOf(RevGlassTypes,  ver4.glassType);
+    SplitEncoded(FusedFaceColors,  ver4.facelineColor, v3[0], gi.faceGI);
+    SplitEncoded(FusedHairColors,  ver4.hairColor,     v3[1], gi.hairGI);
+    SplitEncoded(FusedEyeColors,   ver4.eyeColor,      v3[2], gi.eyeGI);
+    SplitEncoded(FusedHairColors,  ver4.eyebrowColor,  v3[3], gi.browGI);
+    SplitEncoded(FusedMouthColors, ver4.mouthColor,    v3[4], gi.mouthGI);
+    SplitEncoded(FusedHairColors,  ver4.beardColor,    v3[5], gi.beardGI);
+    SplitEncoded(FusedGlassColors, ver4.glassColor,    v3[6], gi.glassColorGI);
+    SplitEncoded(FusedGlassTypes,  ver4.glassType,     v3[7], gi.glassTypeGI);
+
+    // Write them into Mii data.
+    mii.template Set<Ver3Field::FaceColor>(v3[0]);
+    mii.template Set<Ver3Field::HairColor>(v3[1]);
+    mii.template Set<Ver3Field::EyeColor>(v3[2]);
+    mii.template Set<Ver3Field::EyebrowColor>(v3[3]);
+    mii.template Set<Ver3Field::MouthColor>(v3[4]);
+    mii.template Set<Ver3Field::BeardColor>(v3[5]);
+    mii.template Set<Ver3Field::GlassColor>(v3[6]);
+    mii.template Set<Ver3Field::GlassType>(v3[7]);
+
+    WriteMarkedBlock(gi, encoding, mii);
+}
+
+template <std::endian Order>
+void NxInVer3Pack::WriteMarkedBlock(const GroupIndices& gi, ExtraEncoding encoding, Ver3MiiView<Order> mii)
+{
+    const Ver3MiiView<Order, const u8> visible(mii);
 
     // Pack group indices into the beginning of ExtraDataBlock.
     ExtraDataBlock block{};
-    std::memset(block.data, 0, EXTRA_BYTES_TOTAL);
+    if (encoding == ExtraEncoding_MixedRadix) {
+        EncodeGroupIndicesMixedRadix(gi, visible, block);
+    } else {
+        EncodeGroupIndices(gi, block);
+    }
 
-    EncodeGroupIndices(gi, block);
+    // Mark the block as eFFSD data. The checksum needs the visible colors to be written already.
+    u64 word = LoadBlock(block);
+    word = SetField<ExtraBlockSchema, ExtraBlock_Flag>(word, 1);
+    word = SetField<ExtraBlockSchema, ExtraBlock_Encoding>(word, encoding);
+    StoreBlock(word, block);
+    const u32 hash = ChecksumHash(block, visible);
+    word = SetField<ExtraBlockSchema, ExtraBlock_Checksum>(word, hash >> (32 - ExtraChecksumBits));
+    if (encoding == ExtraEncoding_MixedRadix) {
+        // Bits left over after the digits hold more of the hash.
+        const MixedRadixLayout layout = GetMixedRadixLayout(visible);
+        word |= u64(ExtendedChecksum(hash, layout.checkBits)) << (layout.lowBits + layout.highBits);
+    }
+    StoreBlock(word, block);
 
-    // The rest of the 51-bit block remains zero for now (future checksum/user space).
-    // Write the block into the Mii struct reserved/padding fields contiguously.
+    // The rest of the 51-bit block remains zero (reserved).
+    // Write the block into the Mii data's reserved/padding fields contiguously.
     WriteExtra(mii, block);
 }
 
+// Detection.
+
+/// Returns true if the Ver3 value has a bucket, and the group index is inside it.
+template <typename FusedT>
+constexpr bool IsValidGroup(const FusedT& table, u32 ver3Value, u8 groupIndex) {
+    return groupIndex < table.counts[ver3Value];
+}
+
+template <std::endian Order>
+bool NxInVer3Pack::Detect(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii)
+{
+    if (!QuickDetect(mii)) {
+        return false;
+    }
+
+    GroupIndices gi{};
+    DecodeGroupIndices(inBlock, mii, gi);
+    // A group index past the end of its bucket can't have come from Pack().
+    if (!IsValidGroup(FusedFaceColors,  mii.template Get<Ver3Field::FaceColor>(),    gi.faceGI) ||
+        !IsValidGroup(FusedHairColors,  mii.template Get<Ver3Field::HairColor>(),    gi.hairGI) ||
+        !IsValidGroup(FusedEyeColors,   mii.template Get<Ver3Field::EyeColor>(),     gi.eyeGI) ||
+        !IsValidGroup(FusedHairColors,  mii.template Get<Ver3Field::EyebrowColor>(), gi.browGI) ||
+        !IsValidGroup(FusedMouthColors, mii.template Get<Ver3Field::MouthColor>(),   gi.mouthGI) ||
+        !IsValidGroup(FusedHairColors,  mii.template Get<Ver3Field::BeardColor>(),   gi.beardGI) ||
+        !IsValidGroup(FusedGlassColors, mii.template Get<Ver3Field::GlassColor>(),   gi.glassColorGI) ||
+        !IsValidGroup(FusedGlassTypes,  mii.template Get<Ver3Field::GlassType>(),    gi.glassTypeGI)) {
+        return false;
+    }
+
+    const u64 word = LoadBlock(inBlock);
+    const u32 hash = ChecksumHash(inBlock, mii);
+    if (GetField<ExtraBlockSchema, ExtraBlock_Checksum>(word) != hash >> (32 - ExtraChecksumBits)) {
+        return false;
+    }
+    if (GetField<ExtraBlockSchema, ExtraBlock_Encoding>(word) == ExtraEncoding_MixedRadix) {
+        // The extended checksum, and zeroes in any bits past it.
+        const MixedRadixLayout layout = GetMixedRadixLayout(mii);
+        const u64 rest = GetField<ExtraBlockSchema, ExtraBlock_GroupIndices>(word) >> (layout.lowBits + layout.highBits);
+        return rest == ExtendedChecksum(hash, layout.checkBits);
+    }
+    return true;
+}
+
+template <std::endian Order>
+bool NxInVer3Pack::TryUnpack(Ver3MiiView<Order, const u8> mii, NxExtensionFields& outVer4)
+{
+    // Reject ordinary data before extracting anything.
+    if (!QuickDetect(mii)) {
+        return false;
+    }
+    ExtraDataBlock block{};
+    ExtractExtra(mii, block);
+    if (!Detect(block, mii)) {
+        return false;
+    }
+    Unpack(block, mii, outVer4);
+    return true;
+}
+
+template <std::endian Order>
+bool NxInVer3Pack::MatchesVisible(const NxExtensionFields& ver4, Ver3MiiView<Order, const u8> mii)
+{
+    const u8* values = &ver4.facelineColor;
+    const u8 limits[] = { FacelineColor_End, CommonColor_End, CommonColor_End, CommonColor_End,
+                          CommonColor_End, CommonColor_End, CommonColor_End, GlassType_End };
+    for (std::size_t i = 0; i < std::size(limits); ++i) {
+        if (values[i] >= limits[i]) {
+            return false;
+        }
+    }
+    return mii.template Get<Ver3Field::FaceColor>()    == ToVer3FacelineColorTable[ver4.facelineColor] &&
+           mii.template Get<Ver3Field::HairColor>()    == ToVer3HairColorTable[ver4.hairColor] &&
+           mii.template Get<Ver3Field::EyeColor>()     == ToVer3EyeColorTable[ver4.eyeColor] &&
+           mii.template Get<Ver3Field::EyebrowColor>() == ToVer3HairColorTable[ver4.eyebrowColor] &&
+           mii.template Get<Ver3Field::MouthColor>()   == ToVer3MouthColorTable[ver4.mouthColor] &&
+           mii.template Get<Ver3Field::BeardColor>()   == ToVer3HairColorTable[ver4.beardColor] &&
+           mii.template Get<Ver3Field::GlassColor>()   == ToVer3GlassColorTable[ver4.glassColor] &&
+           mii.template Get<Ver3Field::GlassType>()    == ToVer3GlassTypeTable[ver4.glassType];
+}
+
 // Unpacking: read the extra block, and reconstruct Ver4 fields.
 
-void NxInVer3Pack::Unpack(const Ver3MiiDataCore& mii, NxExtensionFields& outVer4)
+template <std::endian Order>
+void NxInVer3Pack::Unpack(Ver3MiiView<Order, const u8> mii, NxExtensionFields& outVer4)
 {
     // Extract the contiguous block from the data.
     ExtraDataBlock block{};
@@ -84,139 +340,486 @@ void NxInVer3Pack::Unpack(const Ver3MiiDataCore& mii, NxExtensionFields& outVer4
     Unpack(block, mii, outVer4);
 }
 
-void NxInVer3Pack::Unpack(const ExtraDataBlock& inBlock, const Ver3MiiDataCore& mii, NxExtensionFields& outVer4)
+template <std::endian Order>
+void NxInVer3Pack::Unpack(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii, NxExtensionFields& outVer4)
 {
     // Read visible ver3 values back from the data for disambiguation.
     GroupIndices gi{};
-    NxInVer3Pack::DecodeGroupIndices(inBlock, gi);
-    const u8 faceV3  = static_cast<u8>(mii.faceColor);
-    const u8 hairV3  = static_cast<u8>(mii.hairColor);
-    const u8 eyeV3   = static_cast<u8>(mii.eyeColor);
-    const u8 browV3  = static_cast<u8>(mii.eyebrowColor);
-    const u8 mouthV3 = static_cast<u8>(mii.mouthColor);
-    const u8 beardV3 = static_cast<u8>(mii.beardColor);
-    const u8 gcolV3  = static_cast<u8>(mii.glassColor);
-    const u8 gtypV3  = static_cast<u8>(mii.glassType);
-
-    // Reconstruct ver4 indices using reverse-mapping buckets.
-    outVer4.facelineColor = Ver4FromGroup(RevFaceColors,   faceV3,  gi.faceGI);
-    outVer4.hairColor     = Ver4FromGroup(RevHairColors,   hairV3,  gi.hairGI);
-    outVer4.eyeColor      = Ver4FromGroup(RevEyeColors,    eyeV3,   gi.eyeGI);
-    outVer4.eyebrowColor  = Ver4FromGroup(RevHairColors,   browV3,  gi.browGI);
-    outVer4.mouthColor    = Ver4FromGroup(RevMouthColors,  mouthV3, gi.mouthGI);
-    outVer4.beardColor    = Ver4FromGroup(RevHairColors,   beardV3, gi.beardGI);
-    outVer4.glassColor    = Ver4FromGroup(RevGlassColors,  gcolV3,  gi.glassColorGI);
-    outVer4.glassType     = Ver4FromGroup(RevGlassTypes,   gtypV3,  gi.glassTypeGI);
+    NxInVer3Pack::DecodeGroupIndices(inBlock, mii, gi);
+    const u8 faceV3  = static_cast<u8>(mii.template Get<Ver3Field::FaceColor>());
+    const u8 hairV3  = static_cast<u8>(mii.template Get<Ver3Field::HairColor>());
+    const u8 eyeV3   = static_cast<u8>(mii.template Get<Ver3Field::EyeColor>());
+    const u8 browV3  = static_cast<u8>(mii.template Get<Ver3Field::EyebrowColor>());
+    const u8 mouthV3 = static_cast<u8>(mii.template Get<Ver3Field::MouthColor>());
+    const u8 beardV3 = static_cast<u8>(mii.template Get<Ver3Field::BeardColor>());
+    const u8 gcolV3  = static_cast<u8>(mii.template Get<Ver3Field::GlassColor>());
+    const u8 gtypV3  = static_cast<u8>(mii.template Get<Ver3Field::GlassType>());
+
+    // Reconstruct ver4 indices using the fused decode tables.
+    outVer4.facelineColor = Ver4FromGroup(FusedFaceColors,  faceV3,  gi.faceGI);
+    outVer4.hairColor     = Ver4FromGroup(FusedHairColors,  hairV3,  gi.hairGI);
+    outVer4.eyeColor      = Ver4FromGroup(FusedEyeColors,   eyeV3,   gi.eyeGI);
+    outVer4.eyebrowColor  = Ver4FromGroup(FusedHairColors,  browV3,  gi.browGI);
+    outVer4.mouthColor    = Ver4FromGroup(FusedMouthColors, mouthV3, gi.mouthGI);
+    outVer4.beardColor    = Ver4FromGroup(FusedHairColors,  beardV3, gi.beardGI);
+    outVer4.glassColor    = Ver4FromGroup(FusedGlassColors, gcolV3,  gi.glassColorGI);
+    outVer4.glassType     = Ver4FromGroup(FusedGlassTypes,  gtypV3,  gi.glassTypeGI);
+}
+
+// Batch packing/unpacking.
+
+/// Records per chunk. Chunk-local arrays stay on the stack.
+static constexpr std::size_t BatchChunkSize = 64;
+
+/// Per-field Pack() lookups over a chunk: visible Ver3 value and group index.
+template <typename FusedT>
+static inline void ToVer3Batch(const FusedT& table, const u8* ver4, u8* outVer3, u8* outGI, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        SplitEncoded(table, ver4[i], outVer3[i], outGI[i]);
+    }
+}
+
+/// Per-field Unpack() lookups over a chunk.
+template <typename FusedT>
+static inline void Ver4FromGroupBatch(const FusedT& table, const u8* ver3, const u8* gi, u8* outVer4, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        outVer4[i] = Ver4FromGroup(table, ver3[i], gi[i]);
+    }
+}
+
+/// NxExtensionFields as a chunk of arrays, in the same order as the struct.
+struct BatchFields {
+    u8 face[BatchChunkSize], hair[BatchChunkSize], eye[BatchChunkSize], brow[BatchChunkSize];
+    u8 mouth[BatchChunkSize], beard[BatchChunkSize], glassColor[BatchChunkSize], glassType[BatchChunkSize];
+};
+
+template <std::endian Order>
+void NxInVer3Pack::PackBatch(const NxExtensionFieldsSoA& ver4, u8* records, std::size_t count, std::size_t stride,
+    ExtraEncoding encoding)
+{
+    assert(stride >= Ver3CoreRecordSize);
+    BatchFields v3;
+    BatchFields gi;
+
+    for (std::size_t base = 0; base < count; base += BatchChunkSize) {
+        const std::size_t n = count - base < BatchChunkSize ? count - base : BatchChunkSize;
+
+        // Field-major lookups.
+        ToVer3Batch(FusedFaceColors,  ver4.facelineColor + base, v3.face,       gi.face,       n);
+        ToVer3Batch(FusedHairColors,  ver4.hairColor + base,     v3.hair,       gi.hair,       n);
+        ToVer3Batch(FusedEyeColors,   ver4.eyeColor + base,      v3.eye,        gi.eye,        n);
+        ToVer3Batch(FusedHairColors,  ver4.eyebrowColor + base,  v3.brow,       gi.brow,       n);
+        ToVer3Batch(FusedMouthColors, ver4.mouthColor + base,    v3.mouth,      gi.mouth,      n);
+        ToVer3Batch(FusedHairColors,  ver4.beardColor + base,    v3.beard,      gi.beard,      n);
+        ToVer3Batch(FusedGlassColors, ver4.glassColor + base,    v3.glassColor, gi.glassColor, n);
+        ToVer3Batch(FusedGlassTypes,  ver4.glassType + base,     v3.glassType,  gi.glassType,  n);
+
+        // Record-major writes.
+        for (std::size_t i = 0; i < n; ++i) {
+            const Ver3MiiView<Order> mii(records + (base + i) * stride);
+            mii.template Set<Ver3Field::FaceColor>(v3.face[i]);
+            mii.template Set<Ver3Field::HairColor>(v3.hair[i]);
+            mii.template Set<Ver3Field::EyeColor>(v3.eye[i]);
+            mii.template Set<Ver3Field::EyebrowColor>(v3.brow[i]);
+            mii.template Set<Ver3Field::MouthColor>(v3.mouth[i]);
+            mii.template Set<Ver3Field::BeardColor>(v3.beard[i]);
+            mii.template Set<Ver3Field::GlassColor>(v3.glassColor[i]);
+            mii.template Set<Ver3Field::GlassType>(v3.glassType[i]);
+
+            const GroupIndices recordGI{ gi.face[i], gi.hair[i], gi.eye[i], gi.brow[i],
+                gi.mouth[i], gi.beard[i], gi.glassColor[i], gi.glassType[i] };
+            WriteMarkedBlock(recordGI, encoding, mii);
+        }
+    }
+}
+
+template <std::endian Order>
+std::size_t NxInVer3Pack::UnpackBatch(const u8* records, std::size_t count, std::size_t stride,
+    const NxExtensionFieldsSoA& outVer4, u8* outDetected)
+{
+    assert(stride >= Ver3CoreRecordSize);
+    BatchFields v3;
+    BatchFields gi;
+    std::size_t detected = 0;
+
+    for (std::size_t base = 0; base < count; base += BatchChunkSize) {
+        const std::size_t n = count - base < BatchChunkSize ? count - base : BatchChunkSize;
+
+        // Record-major reads.
+        for (std::size_t i = 0; i < n; ++i) {
+            const Ver3MiiView<Order, const u8> mii(records + (base + i) * stride);
+            v3.face[i]       = static_cast<u8>(mii.template Get<Ver3Field::FaceColor>());
+            v3.hair[i]       = static_cast<u8>(mii.template Get<Ver3Field::HairColor>());
+            v3.eye[i]        = static_cast<u8>(mii.template Get<Ver3Field::EyeColor>());
+            v3.brow[i]       = static_cast<u8>(mii.template Get<Ver3Field::EyebrowColor>());
+            v3.mouth[i]      = static_cast<u8>(mii.template Get<Ver3Field::MouthColor>());
+            v3.beard[i]      = static_cast<u8>(mii.template Get<Ver3Field::BeardColor>());
+            v3.glassColor[i] = static_cast<u8>(mii.template Get<Ver3Field::GlassColor>());
+            v3.glassType[i]  = static_cast<u8>(mii.template Get<Ver3Field::GlassType>());
+
+            ExtraDataBlock block{};
+            ExtractExtra(mii, block);
+            GroupIndices recordGI{};
+            DecodeGroupIndices(block, mii, recordGI);
+            gi.face[i]       = recordGI.faceGI;
+            gi.hair[i]       = recordGI.hairGI;
+            gi.eye[i]        = recordGI.eyeGI;
+            gi.brow[i]       = recordGI.browGI;
+            gi.mouth[i]      = recordGI.mouthGI;
+            gi.beard[i]      = recordGI.beardGI;
+            gi.glassColor[i] = recordGI.glassColorGI;
+            gi.glassType[i]  = recordGI.glassTypeGI;
+
+            const bool isDetected = Detect(block, mii);
+            detected += isDetected ? 1 : 0;
+            if (outDetected != nullptr) {
+                outDetected[base + i] = isDetected ? 1 : 0;
+            }
+        }
+
+        // Field-major lookups.
+        Ver4FromGroupBatch(FusedFaceColors,  v3.face,       gi.face,       outVer4.facelineColor + base, n);
+        Ver4FromGroupBatch(FusedHairColors,  v3.hair,       gi.hair,       outVer4.hairColor + base,     n);
+        Ver4FromGroupBatch(FusedEyeColors,   v3.eye,        gi.eye,        outVer4.eyeColor + base,      n);
+        Ver4FromGroupBatch(FusedHairColors,  v3.brow,       gi.brow,       outVer4.eyebrowColor + base,  n);
+        Ver4FromGroupBatch(FusedMouthColors, v3.mouth,      gi.mouth,      outVer4.mouthColor + base,    n);
+        Ver4FromGroupBatch(FusedHairColors,  v3.beard,      gi.beard,      outVer4.beardColor + base,    n);
+        Ver4FromGroupBatch(FusedGlassColors, v3.glassColor, gi.glassColor, outVer4.glassColor + base,    n);
+        Ver4FromGroupBatch(FusedGlassTypes,  v3.glassType,  gi.glassType,  outVer4.glassType + base,     n);
+    }
+    return detected;
 }
 
 void NxInVer3Pack::EncodeGroupIndices(const GroupIndices& gi, ExtraDataBlock& outBlock)
 {
-    std::memset(outBlock.data, 0, EXTRA_BYTES_TOTAL);
-    std::size_t bit = 0;
-    PutBits(outBlock.data, bit, FacelineColorBits, gi.faceGI);       bit += FacelineColorBits;
-    PutBits(outBlock.data, bit, HairColorBits,     gi.hairGI);       bit += HairColorBits;
-    PutBits(outBlock.data, bit, EyeColorBits,      gi.eyeGI);        bit += EyeColorBits;
-    PutBits(outBlock.data, bit, EyebrowColorBits,  gi.browGI);       bit += EyebrowColorBits;
-    PutBits(outBlock.data, bit, MouthColorBits,    gi.mouthGI);      bit += MouthColorBits;
-    PutBits(outBlock.data, bit, BeardColorBits,    gi.beardGI);      bit += BeardColorBits;
-    PutBits(outBlock.data, bit, GlassColorBits,    gi.glassColorGI); bit += GlassColorBits;
-    PutBits(outBlock.data, bit, GlassTypeBits,     gi.glassTypeGI);  bit += GlassTypeBits;
+    // Group indices are the first field of the block, the rest is zeroed.
+    StoreBlock(GatherFields<GroupIndexSchema>(gi), outBlock);
 }
 
 void NxInVer3Pack::DecodeGroupIndices(const ExtraDataBlock& inBlock, GroupIndices& gi)
 {
-    std::size_t bit = 0;
-    gi.faceGI       = static_cast<u8>(GetBits(inBlock.data, bit, FacelineColorBits)); bit += FacelineColorBits;
-    gi.hairGI       = static_cast<u8>(GetBits(inBlock.data, bit, HairColorBits));     bit += HairColorBits;
-    gi.eyeGI        = static_cast<u8>(GetBits(inBlock.data, bit, EyeColorBits));      bit += EyeColorBits;
-    gi.browGI       = static_cast<u8>(GetBits(inBlock.data, bit, EyebrowColorBits));  bit += EyebrowColorBits;
-    gi.mouthGI      = static_cast<u8>(GetBits(inBlock.data, bit, MouthColorBits));    bit += MouthColorBits;
-    gi.beardGI      = static_cast<u8>(GetBits(inBlock.data, bit, BeardColorBits));    bit += BeardColorBits;
-    gi.glassColorGI = static_cast<u8>(GetBits(inBlock.data, bit, GlassColorBits));    bit += GlassColorBits;
-    gi.glassTypeGI  = static_cast<u8>(GetBits(inBlock.data, bit, GlassTypeBits));     bit += GlassTypeBits;
+    ScatterFields<GroupIndexSchema>(LoadBlock(inBlock), gi);
+}
+
+template <std::endian Order>
+void NxInVer3Pack::EncodeGroupIndicesMixedRadix(const GroupIndices& gi, Ver3MiiView<Order, const u8> mii, ExtraDataBlock& outBlock)
+{
+    const MixedRadixLayout layout = GetMixedRadixLayout(mii);
+    const u64 low  = EncodeDigits(gi, layout, 0, MixedRadixSplit);
+    const u64 high = EncodeDigits(gi, layout, MixedRadixSplit, GroupIndexCount);
+    StoreBlock(low | high << layout.lowBits, outBlock);
+}
+
+template <std::endian Order>
+void NxInVer3Pack::DecodeGroupIndices(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii, GroupIndices& gi)
+{
+    const u64 word = LoadBlock(inBlock);
+    if (GetField<ExtraBlockSchema, ExtraBlock_Encoding>(word) != ExtraEncoding_MixedRadix) {
+        // Unknown encodings are read as fixed-width, like unmarked data.
+        ScatterFields<GroupIndexSchema>(word, gi);
+        return;
+    }
+    const MixedRadixLayout layout = GetMixedRadixLayout(mii);
+    const u32 low  = static_cast<u32>(word & BitMask(layout.lowBits));
+    const u32 high = static_cast<u32>((word >> layout.lowBits) & BitMask(layout.highBits));
+    DecodeDigits(low,  layout, 0, MixedRadixSplit, gi);
+    DecodeDigits(high, layout, MixedRadixSplit, GroupIndexCount, gi);
 }
 
 // ExtraDataBlock contiguous extraction.
 
-void NxInVer3Pack::ExtractExtra(const Ver3MiiDataCore& mii, ExtraDataBlock& out)
+template <std::endian Order>
+void NxInVer3Pack::ExtractExtra(Ver3MiiView<Order, const u8> mii, ExtraDataBlock& out)
 {
-    std::memset(out.data, 0, EXTRA_BYTES_TOTAL);
-    std::size_t bit = 0;
-
-    // Strict order as documented. We read the current numeric field values as bits.
-    PutBits(out.data, bit, 2,  static_cast<u64>(mii.reserved_0));      bit += 2;
-    PutBits(out.data, bit, 4,  static_cast<u64>(mii.authorType));      bit += 4;
-    PutBits(out.data, bit, 1,  static_cast<u64>(mii.reserved_1));      bit += 1;
-    PutBits(out.data, bit, 8,  static_cast<u64>(mii.reserved_2[0]));   bit += 8;
-    PutBits(out.data, bit, 8,  static_cast<u64>(mii.reserved_2[1]));   bit += 8;
-
-    PutBits(out.data, bit, 1,  static_cast<u64>(mii.padding_0));       bit += 1;
-    PutBits(out.data, bit, 4,  static_cast<u64>(mii.padding_1));       bit += 4;
-    PutBits(out.data, bit, 2,  static_cast<u64>(mii.padding_2));       bit += 2;
-    PutBits(out.data, bit, 1,  static_cast<u64>(mii.padding_3));       bit += 1;
-    PutBits(out.data, bit, 2,  static_cast<u64>(mii.padding_4));       bit += 2;
-    PutBits(out.data, bit, 2,  static_cast<u64>(mii.padding_5));       bit += 2;
-    PutBits(out.data, bit, 8,  static_cast<u64>(mii.padding_6));       bit += 8;
-    PutBits(out.data, bit, 1,  static_cast<u64>(mii.padding_7));       bit += 1;
-    PutBits(out.data, bit, 1,  static_cast<u64>(mii.padding_8));       bit += 1;
-
-    // Only 3 bits (0-7) are used in roomIndex/positionInRoom.
-    /*
-    // If fields are zero or out of range, treat as 1 (encoded zero) defensively.
-    u32 room = (mii.roomIndex == 0 || mii.roomIndex > 9) ? 1u : static_cast<u32>(mii.roomIndex);
-    u32 pos  = (mii.positionInRoom == 0 || mii.positionInRoom > 9) ? 1u : static_cast<u32>(mii.positionInRoom);
-    PutBits(out.data, bit, 3, static_cast<u64>((room - 1) & 0x7));     bit += 3;
-    PutBits(out.data, bit, 3, static_cast<u64>((pos  - 1) & 0x7));     bit += 3;
-    */
-    PutBits(out.data, bit, 3,  static_cast<u64>(mii.roomIndex) & 0x7);      bit += 3;
-    PutBits(out.data, bit, 3,  static_cast<u64>(mii.positionInRoom) & 0x7); bit += 3;
-
-    // We ignore any remaining bits; total must be <= 51.
-    (void)bit;
+    // Order and widths are in Ver3PaddingSchema.
+    StoreBlock(GatherFields<Ver3PaddingSchema>(mii), out);
 }
 
 // ExtraDataBlock writing.
 
-void NxInVer3Pack::WriteExtra(Ver3MiiDataCore& mii, const ExtraDataBlock& in)
+template <std::endian Order>
+void NxInVer3Pack::WriteExtra(Ver3MiiView<Order> mii, const ExtraDataBlock& in)
 {
-    std::size_t bit = 0;
-
-    // For all assignments below, values may or may not be changed.
-    // GCC complains about this depsite the explicit static_cast, clang doesn't.
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wconversion"
-    // Read fields back from the block, then assign into struct fields.
-
-    mii.reserved_0 = static_cast<u32>(GetBits(in.data, bit, 2));   bit += 2;
-    // authorType is an unused field always unread and 0. There is even an enum
-    // for it, but it only has one value "0 = Normal". It was presumably for UGC.
-    mii.authorType = static_cast<u32>(GetBits(in.data, bit, 4));   bit += 4;
-    mii.reserved_1 = static_cast<u32>(GetBits(in.data, bit, 1));   bit += 1;
-
-    mii.reserved_2[0] = static_cast<u8>(GetBits(in.data, bit, 8)); bit += 8;
-    mii.reserved_2[1] = static_cast<u8>(GetBits(in.data, bit, 8)); bit += 8;
-
-    mii.padding_0 = static_cast<u16>(GetBits(in.data, bit, 1));     bit += 1;
-    mii.padding_1 = static_cast<u16>(GetBits(in.data, bit, 4));     bit += 4;
-    mii.padding_2 = static_cast<u16>(GetBits(in.data, bit, 2));     bit += 2;
-    mii.padding_3 = static_cast<u16>(GetBits(in.data, bit, 1));     bit += 1;
-    mii.padding_4 = static_cast<u16>(GetBits(in.data, bit, 2));     bit += 2;
-    mii.padding_5 = static_cast<u16>(GetBits(in.data, bit, 2));     bit += 2;
-    mii.padding_6 = static_cast<u16>(GetBits(in.data, bit, 8));     bit += 8;
-    mii.padding_7 = static_cast<u16>(GetBits(in.data, bit, 1));     bit += 1;
-    mii.padding_8 = static_cast<u16>(GetBits(in.data, bit, 1));     bit += 1;
-
-    // roomIndex/positionInRoom are only used on the 3DS database.
-    // They should otherwise be unused on Wii U and in data transmission.
-    // Their max value is 9, otherwise verification fails. So, only 3 bits are used.
-    // Because these can be non-zero, they are put at the end.
-    // They may eventually be removed as well if they
-
-    mii.roomIndex      = static_cast<u32>(GetBits(in.data, bit, 3)); bit += 3;
-    mii.positionInRoom = static_cast<u32>(GetBits(in.data, bit, 3)); bit += 3;
-#pragma GCC diagnostic pop
-
-    (void)bit;
+    // For all fields, values may or may not be changed.
+    // roomIndex/positionInRoom only receive 3 bits, so they never exceed 9.
+    ScatterFields<Ver3PaddingSchema>(LoadBlock(in), mii);
+}
+
+// // ---------------------------------------------------------------
+// //  Switch CharInfo Export
+// // ---------------------------------------------------------------
+
+static constexpr std::size_t Ver3NameOffset = 0x1A;
+/// Bytes hashed into the Switch create ID: authorId and createId.
+static constexpr std::size_t Ver3IdsOffset  = 0x04;
+static constexpr std::size_t Ver3IdsSize    = sizeof(Ver3AuthorId) + sizeof(Ver3CreateId);
+
+/// Out-of-range Ver3 values, which FFL would reject anyway, take the last entry.
+template <std::size_t N>
+constexpr u8 FromVer3(const std::array<u8, N>& table, u32 value) {
+    return table[value < N ? value : N - 1];
+}
+
+/// SplitMix64 finalizer.
+constexpr u64 Mix64(u64 x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/// A version 4 UUID from the Ver3 IDs, so that the same Mii always gets the same one.
+static void MakeCreateId(const u8* mii, u8 (&out)[16]) {
+    u64 hash = 0xCBF29CE484222325ull; // FNV-1a
+    for (std::size_t i = 0; i < Ver3IdsSize; ++i) {
+        hash = (hash ^ mii[Ver3IdsOffset + i]) * 0x100000001B3ull;
+    }
+    const u64 halves[2] = { Mix64(hash), Mix64(hash + 0x9E3779B97F4A7C15ull) };
+    for (std::size_t i = 0; i < sizeof(out); ++i) {
+        out[i] = static_cast<u8>(halves[i / 8] >> (56 - (i % 8) * 8));
+    }
+    out[6] = static_cast<u8>((out[6] & 0x0F) | 0x40); // Version 4.
+    out[8] = static_cast<u8>((out[8] & 0x3F) | 0x80); // RFC 4122 variant.
+}
+
+template <Ver3Field F, std::endian Order>
+constexpr u8 GetByte(Ver3MiiView<Order, const u8> mii) {
+    return static_cast<u8>(mii.template Get<F>());
+}
+
+/// Everything but the colors and glass type, which depend on the extension fields.
+template <std::endian Order>
+static void FillCharInfo(Ver3MiiView<Order, const u8> mii, NxCharInfo& out)
+{
+    MakeCreateId(mii.Data(), out.createId);
+    const u8* name = mii.Data() + Ver3NameOffset;
+    for (std::size_t i = 0; i < MII_NAME_LENGTH; ++i) {
+        const u32 lo = name[i * 2 + (Order == std::endian::little ? 0 : 1)];
+        const u32 hi = name[i * 2 + (Order == std::endian::little ? 1 : 0)];
+        out.nickname[i] = static_cast<u16>(lo | hi << 8);
+    }
+    out.nickname[MII_NAME_LENGTH] = 0;
+
+    out.fontRegion      = GetByte<Ver3Field::FontRegion>(mii);
+    out.favoriteColor   = GetByte<Ver3Field::FavoriteColor>(mii);
+    out.gender          = GetByte<Ver3Field::Gender>(mii);
+    out.height          = GetByte<Ver3Field::Height>(mii);
+    out.build           = GetByte<Ver3Field::Build>(mii);
+    out.type            = 0;
+    out.regionMove      = GetByte<Ver3Field::RegionMove>(mii);
+    out.facelineType    = GetByte<Ver3Field::FaceType>(mii);
+    out.facelineWrinkle = GetByte<Ver3Field::FaceTex>(mii);
+    out.facelineMake    = GetByte<Ver3Field::FaceMake>(mii);
+    out.hairType        = GetByte<Ver3Field::HairType>(mii);
+    out.hairFlip        = GetByte<Ver3Field::HairFlip>(mii);
+    out.eyeType         = GetByte<Ver3Field::EyeType>(mii);
+    out.eyeScale        = GetByte<Ver3Field::EyeScale>(mii);
+    out.eyeAspect       = GetByte<Ver3Field::EyeAspect>(mii);
+    out.eyeRotate       = GetByte<Ver3Field::EyeRotate>(mii);
+    out.eyeX            = GetByte<Ver3Field::EyeX>(mii);
+    out.eyeY            = GetByte<Ver3Field::EyeY>(mii);
+    out.eyebrowType     = GetByte<Ver3Field::EyebrowType>(mii);
+    out.eyebrowScale    = GetByte<Ver3Field::EyebrowScale>(mii);
+    out.eyebrowAspect   = GetByte<Ver3Field::EyebrowAspect>(mii);
+    out.eyebrowRotate   = GetByte<Ver3Field::EyebrowRotate>(mii);
+    out.eyebrowX        = GetByte<Ver3Field::EyebrowX>(mii);
+    out.eyebrowY        = GetByte<Ver3Field::EyebrowY>(mii);
+    out.noseType        = GetByte<Ver3Field::NoseType>(mii);
+    out.noseScale       = GetByte<Ver3Field::NoseScale>(mii);
+    out.noseY           = GetByte<Ver3Field::NoseY>(mii);
+    out.mouthType       = GetByte<Ver3Field::MouthType>(mii);
+    out.mouthScale      = GetByte<Ver3Field::MouthScale>(mii);
+    out.mouthAspect     = GetByte<Ver3Field::MouthAspect>(mii);
+    out.mouthY          = GetByte<Ver3Field::MouthY>(mii);
+    out.beardType       = GetByte<Ver3Field::BeardType>(mii);
+    out.mustacheType    = GetByte<Ver3Field::MustacheType>(mii);
+    out.mustacheScale   = GetByte<Ver3Field::BeardScale>(mii);
+    out.mustacheY       = GetByte<Ver3Field::BeardY>(mii);
+    out.glassScale      = GetByte<Ver3Field::GlassScale>(mii);
+    out.glassY          = GetByte<Ver3Field::GlassY>(mii);
+    out.moleType        = GetByte<Ver3Field::MoleType>(mii);
+    out.moleScale       = GetByte<Ver3Field::MoleScale>(mii);
+    out.moleX           = GetByte<Ver3Field::MoleX>(mii);
+    out.moleY           = GetByte<Ver3Field::MoleY>(mii);
+    out.padding         = 0;
+}
+
+/// Colors and glass type for a Mii without extension fields.
+template <std::endian Order>
+static void FillCharInfoColorsFromVer3(Ver3MiiView<Order, const u8> mii, NxCharInfo& out)
+{
+    // Faceline colors and glass types are the same numbers in Ver3 and Ver4.
+    out.facelineColor = static_cast<u8>(mii.template Get<Ver3Field::FaceColor>());
+    out.hairColor     = FromVer3(FromVer3HairColorTable,  mii.template Get<Ver3Field::HairColor>());
+    out.eyeColor      = FromVer3(FromVer3EyeColorTable,   mii.template Get<Ver3Field::EyeColor>());
+    out.eyebrowColor  = FromVer3(FromVer3HairColorTable,  mii.template Get<Ver3Field::EyebrowColor>());
+    out.mouthColor    = FromVer3(FromVer3MouthColorTable, mii.template Get<Ver3Field::MouthColor>());
+    out.beardColor    = FromVer3(FromVer3HairColorTable,  mii.template Get<Ver3Field::BeardColor>());
+    out.glassColor    = FromVer3(FromVer3GlassColorTable, mii.template Get<Ver3Field::GlassColor>());
+    out.glassType     = static_cast<u8>(mii.template Get<Ver3Field::GlassType>());
+}
+
+static void FillCharInfoColors(const NxExtensionFields& ver4, NxCharInfo& out)
+{
+    out.facelineColor = ver4.facelineColor;
+    out.hairColor     = ver4.hairColor;
+    out.eyeColor      = ver4.eyeColor;
+    out.eyebrowColor  = ver4.eyebrowColor;
+    out.mouthColor    = ver4.mouthColor;
+    out.beardColor    = ver4.beardColor;
+    out.glassColor    = ver4.glassColor;
+    out.glassType     = ver4.glassType;
+}
+
+template <std::endian Order>
+bool NxInVer3Pack::ToCharInfo(Ver3MiiView<Order, const u8> mii, NxCharInfo& out)
+{
+    FillCharInfo(mii, out);
+    NxExtensionFields ver4{};
+    if (TryUnpack(mii, ver4)) {
+        FillCharInfoColors(ver4, out);
+        return true;
+    }
+    FillCharInfoColorsFromVer3(mii, out);
+    return false;
+}
+
+template <std::endian Order>
+void NxInVer3Pack::ToCharInfoBatch(const u8* records, std::size_t count, std::size_t stride,
+    const NxExtensionFieldsSoA& ver4, const u8* detected, NxCharInfo* out)
+{
+    assert(stride >= Ver3CoreRecordSize);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Ver3MiiView<Order, const u8> mii(records + i * stride);
+        FillCharInfo(mii, out[i]);
+        if (detected[i] != 0) {
+            const NxExtensionFields fields = {
+                ver4.facelineColor[i], ver4.hairColor[i], ver4.eyeColor[i], ver4.eyebrowColor[i],
+                ver4.mouthColor[i], ver4.beardColor[i], ver4.glassColor[i], ver4.glassType[i],
+            };
+            FillCharInfoColors(fields, out[i]);
+        } else {
+            FillCharInfoColorsFromVer3(mii, out[i]);
+        }
+    }
+}
+
+template <std::endian Order>
+std::size_t NxInVer3Pack::ToCharInfoBatch(const u8* records, std::size_t count, std::size_t stride, NxCharInfo* out)
+{
+    BatchFields ver4;
+    u8 detected[BatchChunkSize];
+    const NxExtensionFieldsSoA soa = {
+        ver4.face, ver4.hair, ver4.eye, ver4.brow, ver4.mouth, ver4.beard, ver4.glassColor, ver4.glassType,
+    };
+    std::size_t withExtension = 0;
+    for (std::size_t base = 0; base < count; base += BatchChunkSize) {
+        const std::size_t n = count - base < BatchChunkSize ? count - base : BatchChunkSize;
+        const u8* chunk = records + base * stride;
+        withExtension += UnpackBatch<Order>(chunk, n, stride, soa, detected);
+        ToCharInfoBatch<Order>(chunk, n, stride, soa, detected, out + base);
+    }
+    return withExtension;
+}
+
+// Both byte orders are always available: files are little-endian
+// regardless of the host, and FFL's data on Wii U is big-endian.
+#define NXINVER3PACK_INSTANTIATE(order) \
+    template void NxInVer3Pack::Pack<order>(const NxExtensionFields&, Ver3MiiView<order>, ExtraEncoding); \
+    template void NxInVer3Pack::Unpack<order>(Ver3MiiView<order, const u8>, NxExtensionFields&); \
+    template void NxInVer3Pack::Unpack<order>(const ExtraDataBlock&, Ver3MiiView<order, const u8>, NxExtensionFields&); \
+    template void NxInVer3Pack::ExtractExtra<order>(Ver3MiiView<order, const u8>, ExtraDataBlock&); \
+    template void NxInVer3Pack::WriteExtra<order>(Ver3MiiView<order>, const ExtraDataBlock&); \
+    template bool NxInVer3Pack::Detect<order>(const ExtraDataBlock&, Ver3MiiView<order, const u8>); \
+    template bool NxInVer3Pack::TryUnpack<order>(Ver3MiiView<order, const u8>, NxExtensionFields&); \
+    template bool NxInVer3Pack::MatchesVisible<order>(const NxExtensionFields&, Ver3MiiView<order, const u8>); \
+    template u8 NxInVer3Pack::ComputeChecksum<order>(const ExtraDataBlock&, Ver3MiiView<order, const u8>); \
+    template void NxInVer3Pack::PackBatch<order>(const NxExtensionFieldsSoA&, u8*, std::size_t, std::size_t, ExtraEncoding); \
+    template std::size_t NxInVer3Pack::UnpackBatch<order>(const u8*, std::size_t, std::size_t, const NxExtensionFieldsSoA&, u8*); \
+    template void NxInVer3Pack::WriteMarkedBlock<order>(const GroupIndices&, ExtraEncoding, Ver3MiiView<order>); \
+    template void NxInVer3Pack::EncodeGroupIndicesMixedRadix<order>(const GroupIndices&, Ver3MiiView<order, const u8>, ExtraDataBlock&); \
+    template void NxInVer3Pack::DecodeGroupIndices<order>(const ExtraDataBlock&, Ver3MiiView<order, const u8>, GroupIndices&); \
+    template bool NxInVer3Pack::ToCharInfo<order>(Ver3MiiView<order, const u8>, NxCharInfo&); \
+    template void NxInVer3Pack::ToCharInfoBatch<order>(const u8*, std::size_t, std::size_t, const NxExtensionFieldsSoA&, const u8*, NxCharInfo*); \
+    template std::size_t NxInVer3Pack::ToCharInfoBatch<order>(const u8*, std::size_t, std::size_t, NxCharInfo*);
+
+NXINVER3PACK_INSTANTIATE(std::endian::little)
+NXINVER3PACK_INSTANTIATE(std::endian::big)
+
+#undef NXINVER3PACK_INSTANTIATE
+
+// // ---------------------------------------------------------------
+// //  Ver3StoreData Checksum
+// // ---------------------------------------------------------------
+
+static constexpr u32 Crc16Polynomial = 0x1021;
+static constexpr std::size_t Crc16Slices = 8;
+
+/// Crc16Tables[k][b] is the CRC of byte b followed by k zero bytes.
+static constexpr auto Crc16Tables = [] {
+    std::array<std::array<u16, 256>, Crc16Slices> tables{};
+    for (u32 b = 0; b < 256; ++b) {
+        u32 crc = b << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) != 0 ? (crc << 1) ^ Crc16Polynomial : crc << 1;
+        }
+        tables[0][b] = static_cast<u16>(crc);
+    }
+    for (std::size_t k = 1; k < Crc16Slices; ++k) {
+        for (u32 b = 0; b < 256; ++b) {
+            const u32 prev = tables[k - 1][b];
+            tables[k][b] = static_cast<u16>((prev << 8) ^ tables[0][prev >> 8]);
+        }
+    }
+    return tables;
+}();
+
+u16 ComputeCrc16(const u8* data, std::size_t size, u16 crc) {
+    const auto& t = Crc16Tables;
+    // The running CRC is folded into the first two bytes of each step, then
+    // every byte is looked up by its distance from the end of the step.
+    // The eight lookups don't depend on each other, unlike the bytewise loop.
+    for (; size >= Crc16Slices; data += Crc16Slices, size -= Crc16Slices) {
+        crc = static_cast<u16>(
+            t[7][data[0] ^ (crc >> 8)] ^ t[6][data[1] ^ (crc & 0xFF)] ^
+            t[5][data[2]] ^ t[4][data[3]] ^ t[3][data[4]] ^ t[2][data[5]] ^
+            t[1][data[6]] ^ t[0][data[7]]);
+    }
+    for (; size != 0; ++data, --size) {
+        crc = static_cast<u16>((crc << 8) ^ t[0][(crc >> 8) ^ *data]);
+    }
+    return crc;
+}
+
+// // ---------------------------------------------------------------
+// //  amiibo Import
+// // ---------------------------------------------------------------
+
+AmiiboImportResult ExtractAmiiboMii(const u8* data, std::size_t size,
+    u8 (&outStoreData)[Ver3StoreRecordSize], NxExtensionFields& outVer4)
+{
+    const u8* mii = nullptr;
+    const u8* extension = nullptr;
+    if (size == StoreDataWithExtensionSize) {
+        mii = data;
+        extension = data + Ver3StoreRecordSize;
+    } else if (std::find(std::begin(AmiiboDumpSizes), std::end(AmiiboDumpSizes), size) != std::end(AmiiboDumpSizes)) {
+        if ((data[AmiiboFlagsOffset] & AmiiboFlagHasOwnerMii) == 0) {
+            return AmiiboImport_NoOwnerMii;
+        }
+        mii = data + AmiiboMiiOffset;
+        extension = data + AmiiboExtensionOffset;
+    } else {
+        return AmiiboImport_UnknownSize;
+    }
+
+    if (!VerifyStoreDataCrc(mii)) {
+        return AmiiboImport_BadChecksum;
+    }
+    std::memcpy(outStoreData, mii, Ver3StoreRecordSize);
+    std::memcpy(&outVer4, extension, sizeof(outVer4));
+    return AmiiboImport_Success;
 }
 
 extern "C" {
@@ -226,11 +829,35 @@ extern "C" {
     void NxInVer3Pack_Unpack(const Ver3MiiDataCore* in, NxExtensionFields* out) {
         NxInVer3Pack::Unpack(*in, *out);
     }
+    int NxInVer3Pack_TryUnpack(const Ver3MiiDataCore* in, NxExtensionFields* out) {
+        return NxInVer3Pack::TryUnpack(*in, *out) ? 1 : 0;
+    }
+    void NxInVer3Pack_PackBatch(const NxExtensionFieldsSoA* in, u8* records, u32 count, u32 stride) {
+        NxInVer3Pack::PackBatch<std::endian::little>(*in, records, count, stride);
+    }
+    u32 NxInVer3Pack_UnpackBatch(const u8* records, u32 count, u32 stride, const NxExtensionFieldsSoA* out, u8* outDetected) {
+        return static_cast<u32>(NxInVer3Pack::UnpackBatch<std::endian::little>(records, count, stride, *out, outDetected));
+    }
+    void NxInVer3Pack_UpdateStoreDataCrc(u8* records, u32 count, u32 stride) {
+        for (u32 i = 0; i < count; ++i) {
+            UpdateStoreDataCrc(records + std::size_t(i) * stride);
+        }
+    }
+    u32 NxInVer3Pack_VerifyStoreDataCrc(const u8* records, u32 count, u32 stride) {
+        u32 valid = 0;
+        for (u32 i = 0; i < count; ++i) {
+            valid += VerifyStoreDataCrc(records + std::size_t(i) * stride) ? 1 : 0;
+        }
+        return valid;
+    }
+    u32 NxInVer3Pack_ToCharInfoBatch(const u8* records, u32 count, u32 stride, NxCharInfo* out) {
+        return static_cast<u32>(NxInVer3Pack::ToCharInfoBatch<std::endian::little>(records, count, stride, out));
+    }
 }
 
 /*
  * Usage in JS:
- * > emcc -s WASM=1 -s SINGLE_FILE=1 -s MALLOC=emmalloc -s INITIAL_HEAP=64kb -s STRICT=1 -s MINIMAL_RUNTIME=2 -s EXPORTED_FUNCTIONS="['_NxInVer3Pack_Pack','_NxInVer3Pack_Unpack','_malloc','_free']" -sEXPORTED_RUNTIME_METHODS="['ccall','HEAPU8']" -s MODULARIZE=1 -sEXPORT_KEEPALIVE=1 -O2 NxInVer3Pack.cpp
+ * > emcc -s WASM=1 -s SINGLE_FILE=1 -s MALLOC=emmalloc -s INITIAL_HEAP=64kb -s STRICT=1 -s MINIMAL_RUNTIME=2 -s EXPORTED_FUNCTIONS="['_NxInVer3Pack_Pack','_NxInVer3Pack_Unpack','_NxInVer3Pack_TryUnpack','_NxInVer3Pack_PackBatch','_NxInVer3Pack_UnpackBatch','_NxInVer3Pack_UpdateStoreDataCrc','_NxInVer3Pack_VerifyStoreDataCrc','_NxInVer3Pack_ToCharInfoBatch','_NxInVer3Pack_QuantizeColors','_malloc','_free']" -sEXPORTED_RUNTIME_METHODS="['ccall','HEAPU8']" -s MODULARIZE=1 -sEXPORT_KEEPALIVE=1 -O2 NxInVer3Pack.cpp NxCommonColors.cpp
  * Call like so:
 async function main() {
     const mod = await Module();
@@ -259,4 +886,9 @@ async function main() {
     console.log(customFields, storeData); // Results.
 }
 main();
+
+ * For whole databases, use NxInVer3Pack_PackBatch/_UnpackBatch instead of calling the above per Mii.
+ * Records are in the file format, 72 or 96 bytes apart (stride). NxExtensionFieldsSoA is
+ * 8 pointers (32 bytes on wasm32), each to a Uint8Array of `count` values in the heap.
+ * For 96-byte records, call NxInVer3Pack_UpdateStoreDataCrc afterwards to fix up the checksums.
 */
@@ -10,7 +10,7 @@
  * - Treat the "ExtraDataBlock" as a raw byte buffer (no std::array exposure).
  * - Create mapping and reverse-mapping tables at compile-time (constexpr).
  * - Place roomIndex/positionInRoom bits at the end of the block and force them non-zero.
- * - Leave spare bits in the block for future checksum/user data growth.
+ * - Mark packed data with a flag, encoding and checksum in the spare bits of the block.
  *
  * Notes:
  * - The Ver3 bitfield struct is inherently compiler/endianness-sensitive in layout.
@@ -19,7 +19,11 @@
  */
 
 #include <array>
+#include <bit>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 
 using u8  = std::uint8_t;
 using u16 = std::uint16_t;
@@ -312,6 +316,207 @@ static_assert(sizeof(Ver3MiiDataCore) == 72);
 static_assert(sizeof(Ver3MiiDataOfficial) == 92);
 static_assert(sizeof(Ver3StoreData) == 96);
 
+// // ---------------------------------------------------------------
+// //  Ver3StoreData Checksum
+// // ---------------------------------------------------------------
+// CRC-16/XMODEM (polynomial 0x1021, initial value 0) over everything before `crc`,
+// stored big-endian. The bytes are checksummed as stored, so this is the same
+// for little-endian (3DS, files) and big-endian (Wii U memory) data.
+
+static constexpr std::size_t Ver3StoreDataCrcOffset = 94;
+static_assert(Ver3StoreDataCrcOffset + sizeof(u16) == sizeof(Ver3StoreData));
+
+/// CRC-16/XMODEM of `size` bytes, continuing from `crc`.
+/// Table-driven, eight bytes per step (slicing-by-8).
+u16 ComputeCrc16(const u8* data, std::size_t size, u16 crc = 0);
+
+/// @return CRC of the 96-byte Ver3StoreData at `storeData`, not including the stored one.
+inline u16 ComputeStoreDataCrc(const u8* storeData) {
+    return ComputeCrc16(storeData, Ver3StoreDataCrcOffset);
+}
+/// Writes the CRC into the last two bytes of a 96-byte Ver3StoreData.
+inline void UpdateStoreDataCrc(u8* storeData) {
+    const u16 crc = ComputeStoreDataCrc(storeData);
+    storeData[Ver3StoreDataCrcOffset]     = static_cast<u8>(crc >> 8);
+    storeData[Ver3StoreDataCrcOffset + 1] = static_cast<u8>(crc);
+}
+/// @return True if the CRC stored in a 96-byte Ver3StoreData matches its contents.
+inline bool VerifyStoreDataCrc(const u8* storeData) {
+    const u16 stored = static_cast<u16>((storeData[Ver3StoreDataCrcOffset] << 8) | storeData[Ver3StoreDataCrcOffset + 1]);
+    return ComputeStoreDataCrc(storeData) == stored;
+}
+
+
+// // ---------------------------------------------------------------
+// //  Ver3 Mii View
+// // ---------------------------------------------------------------
+// Ver3MiiDataCore's bitfield layout depends on the compiler and on the
+// host's byte order. Ver3MiiView instead reads and writes fields straight
+// from raw bytes, using the constexpr descriptors below.
+//
+// The LE and BE bitfield declarations above are mirror images, so a field
+// has the same shift within its 16/32-bit unit in either byte order. Only
+// loading the unit depends on the byte order, which is a template parameter:
+// - Files and QR codes (FFSD, as on 3DS) are little-endian.
+// - FFL's buffers on Wii U are big-endian, i.e. std::endian::native.
+
+/// Every scalar field of Ver3MiiDataCore.
+enum class Ver3Field : u8 {
+    MiiVersion, Copyable, NgWord, RegionMove, FontRegion, Reserved0,
+    RoomIndex, PositionInRoom, AuthorType, BirthPlatform, Reserved1,
+    Reserved2_0, Reserved2_1,
+    Gender, BirthMonth, BirthDay, FavoriteColor, Favorite, Padding0,
+    Height, Build,
+    Localonly, FaceType, FaceColor, FaceTex, FaceMake,
+    HairType, HairColor, HairFlip, Padding1,
+    EyeType, EyeColor, EyeScale, EyeAspect,
+    EyeRotate, EyeX, EyeY, Padding2,
+    EyebrowType, EyebrowColor, EyebrowScale, EyebrowAspect, Padding3,
+    EyebrowRotate, EyebrowX, EyebrowY, Padding4,
+    NoseType, NoseScale, NoseY, Padding5,
+    MouthType, MouthColor, MouthScale, MouthAspect,
+    MouthY, MustacheType, Padding6,
+    BeardType, BeardColor, BeardScale, BeardY, Padding7,
+    GlassType, GlassColor, GlassScale, GlassY,
+    MoleType, MoleScale, MoleX, MoleY, Padding8,
+    Count
+};
+
+/// Location of a field: the unit that holds it, and its bits within the unit's value.
+struct Ver3FieldDesc {
+    u8 offset; ///< Byte offset of the unit.
+    u8 size;   ///< Unit size in bytes: 1, 2 or 4.
+    u8 shift;  ///< Bit position from the LSB of the unit's value.
+    u8 width;
+};
+
+static constexpr std::array<Ver3FieldDesc, static_cast<std::size_t>(Ver3Field::Count)> Ver3FieldDescs = {{
+    // 0x00 - Lower personal fields.
+    { 0x00, 4,  0, 8 }, { 0x00, 4,  8, 1 }, { 0x00, 4,  9, 1 }, { 0x00, 4, 10, 2 }, { 0x00, 4, 12, 2 }, { 0x00, 4, 14, 2 },
+    { 0x00, 4, 16, 4 }, { 0x00, 4, 20, 4 }, { 0x00, 4, 24, 4 }, { 0x00, 4, 28, 3 }, { 0x00, 4, 31, 1 },
+    // 0x16 - reserved_2.
+    { 0x16, 1,  0, 8 }, { 0x17, 1,  0, 8 },
+    // 0x18 - Higher personal fields.
+    { 0x18, 2,  0, 1 }, { 0x18, 2,  1, 4 }, { 0x18, 2,  5, 5 }, { 0x18, 2, 10, 4 }, { 0x18, 2, 14, 1 }, { 0x18, 2, 15, 1 },
+    // 0x2E - Body.
+    { 0x2E, 1,  0, 8 }, { 0x2F, 1,  0, 8 },
+    // 0x30 - Faceline.
+    { 0x30, 2,  0, 1 }, { 0x30, 2,  1, 4 }, { 0x30, 2,  5, 3 }, { 0x30, 2,  8, 4 }, { 0x30, 2, 12, 4 },
+    // 0x32 - Hair.
+    { 0x32, 2,  0, 8 }, { 0x32, 2,  8, 3 }, { 0x32, 2, 11, 1 }, { 0x32, 2, 12, 4 },
+    // 0x34 - Eye part 1.
+    { 0x34, 2,  0, 6 }, { 0x34, 2,  6, 3 }, { 0x34, 2,  9, 4 }, { 0x34, 2, 13, 3 },
+    // 0x36 - Eye part 2.
+    { 0x36, 2,  0, 5 }, { 0x36, 2,  5, 4 }, { 0x36, 2,  9, 5 }, { 0x36, 2, 14, 2 },
+    // 0x38 - Eyebrow part 1.
+    { 0x38, 2,  0, 5 }, { 0x38, 2,  5, 3 }, { 0x38, 2,  8, 4 }, { 0x38, 2, 12, 3 }, { 0x38, 2, 15, 1 },
+    // 0x3A - Eyebrow part 2.
+    { 0x3A, 2,  0, 5 }, { 0x3A, 2,  5, 4 }, { 0x3A, 2,  9, 5 }, { 0x3A, 2, 14, 2 },
+    // 0x3C - Nose.
+    { 0x3C, 2,  0, 5 }, { 0x3C, 2,  5, 4 }, { 0x3C, 2,  9, 5 }, { 0x3C, 2, 14, 2 },
+    // 0x3E - Mouth part 1.
+    { 0x3E, 2,  0, 6 }, { 0x3E, 2,  6, 3 }, { 0x3E, 2,  9, 4 }, { 0x3E, 2, 13, 3 },
+    // 0x40 - Mouth part 2 + mustache type.
+    { 0x40, 2,  0, 5 }, { 0x40, 2,  5, 3 }, { 0x40, 2,  8, 8 },
+    // 0x42 - Beard.
+    { 0x42, 2,  0, 3 }, { 0x42, 2,  3, 3 }, { 0x42, 2,  6, 4 }, { 0x42, 2, 10, 5 }, { 0x42, 2, 15, 1 },
+    // 0x44 - Glass.
+    { 0x44, 2,  0, 4 }, { 0x44, 2,  4, 3 }, { 0x44, 2,  7, 4 }, { 0x44, 2, 11, 5 },
+    // 0x46 - Mole.
+    { 0x46, 2,  0, 1 }, { 0x46, 2,  1, 4 }, { 0x46, 2,  5, 5 }, { 0x46, 2, 10, 5 }, { 0x46, 2, 15, 1 },
+}};
+
+/// Every unit must be filled exactly by its fields.
+constexpr bool Ver3FieldDescsAreTight() {
+    u32 covered[sizeof(Ver3MiiDataCore)] = {};
+    for (const Ver3FieldDesc& desc : Ver3FieldDescs) {
+        if (desc.shift + desc.width > desc.size * 8) {
+            return false;
+        }
+        covered[desc.offset] += desc.width;
+    }
+    for (const Ver3FieldDesc& desc : Ver3FieldDescs) {
+        if (covered[desc.offset] != desc.size * 8u) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(Ver3FieldDescsAreTight(), "Ver3FieldDescs has a gap or overlap.");
+
+/**
+ * @brief Reads/writes Ver3 Mii fields directly in a raw buffer of the given byte order.
+ * @tparam Order Byte order of the 16/32-bit units in the buffer.
+ * @tparam Byte  `u8` for a writable view, `const u8` for a read-only one.
+ * @details Views are a single pointer and are meant to be passed by value.
+ *          Accessors compile down to one unit load plus a shift and mask.
+ */
+template <std::endian Order, typename Byte = u8>
+class Ver3MiiView {
+    static_assert(std::is_same_v<std::remove_const_t<Byte>, u8>);
+public:
+    explicit constexpr Ver3MiiView(Byte* data) : mData(data) {}
+    /// Writable views convert to read-only ones.
+    constexpr operator Ver3MiiView<Order, const u8>() const { return Ver3MiiView<Order, const u8>(mData); }
+
+    constexpr Byte* Data() const { return mData; }
+
+    template <Ver3Field F>
+    constexpr u32 Get() const {
+        constexpr Ver3FieldDesc desc = Ver3FieldDescs[static_cast<std::size_t>(F)];
+        return (LoadUnit<desc.size>(mData + desc.offset) >> desc.shift) & ((1u << desc.width) - 1u);
+    }
+
+    /// Bits of `value` above the field's width are discarded.
+    template <Ver3Field F>
+    constexpr void Set(u32 value) const requires (!std::is_const_v<Byte>) {
+        constexpr Ver3FieldDesc desc = Ver3FieldDescs[static_cast<std::size_t>(F)];
+        constexpr u32 mask = ((1u << desc.width) - 1u) << desc.shift;
+        const u32 unit = LoadUnit<desc.size>(mData + desc.offset);
+        StoreUnit<desc.size>(mData + desc.offset, (unit & ~mask) | ((value << desc.shift) & mask));
+    }
+
+private:
+    template <std::size_t Size>
+    static constexpr u32 LoadUnit(const u8* p) {
+        if constexpr (Size == 1) {
+            return p[0];
+        } else if constexpr (Size == 2) {
+            return Order == std::endian::little
+                ? u32(p[0]) | u32(p[1]) << 8
+                : u32(p[0]) << 8 | u32(p[1]);
+        } else {
+            return Order == std::endian::little
+                ? u32(p[0]) | u32(p[1]) << 8 | u32(p[2]) << 16 | u32(p[3]) << 24
+                : u32(p[0]) << 24 | u32(p[1]) << 16 | u32(p[2]) << 8 | u32(p[3]);
+        }
+    }
+
+    template <std::size_t Size>
+    static constexpr void StoreUnit(u8* p, u32 value) {
+        for (std::size_t i = 0; i < Size; ++i) {
+            const std::size_t byteShift = (Order == std::endian::little ? i : Size - 1 - i) * 8;
+            p[i] = static_cast<u8>(value >> byteShift);
+        }
+    }
+
+    Byte* mData;
+};
+
+/// View over the on-disk (FFSD/QR code) format.
+using Ver3MiiFileView       = Ver3MiiView<std::endian::little>;
+using Ver3MiiFileConstView  = Ver3MiiView<std::endian::little, const u8>;
+/// View over data in host memory, i.e. with the bitfield layout of Ver3MiiDataCore.
+using Ver3MiiNativeView      = Ver3MiiView<std::endian::native>;
+using Ver3MiiNativeConstView = Ver3MiiView<std::endian::native, const u8>;
+
+inline Ver3MiiNativeView ViewOf(Ver3MiiDataCore& mii) {
+    return Ver3MiiNativeView(reinterpret_cast<u8*>(&mii));
+}
+inline Ver3MiiNativeConstView ViewOf(const Ver3MiiDataCore& mii) {
+    return Ver3MiiNativeConstView(reinterpret_cast<const u8*>(&mii));
+}
+
 
 // // ---------------------------------------------------------------
 // //  Model for Ver4/NX Fields
@@ -332,6 +537,86 @@ struct NxExtensionFields {
     u8 glassType;     // 0..19
 };
 
+/// NxExtensionFields for many Miis at once, as one array per field.
+/// Used by the batch API so that each field can be processed in its own tight loop.
+struct NxExtensionFieldsSoA {
+    u8* facelineColor;
+    u8* hairColor;
+    u8* eyeColor;
+    u8* eyebrowColor;
+    u8* mouthColor;
+    u8* beardColor;
+    u8* glassColor;
+    u8* glassType;
+};
+
+/**
+ * @brief nn::mii::CharInfo, the unpacked form of a Switch Mii.
+ * @details Every field is one byte and uses the Ver4 ranges, including common colors.
+ *          The nickname is in the host's byte order (little-endian, like the Switch, on x86/wasm).
+ *          Same layout as "CharInfo" in Yuzu's mii service.
+ */
+struct NxCharInfo {
+    u8  createId[16]; ///< A UUID, unlike Ver3CreateId.
+    u16 nickname[MII_NAME_LENGTH + 1];
+    u8  fontRegion;
+    u8  favoriteColor;
+    u8  gender;
+    u8  height;
+    u8  build;
+    u8  type;
+    u8  regionMove;
+    u8  facelineType;
+    u8  facelineColor;
+    u8  facelineWrinkle;
+    u8  facelineMake;
+    u8  hairType;
+    u8  hairColor;
+    u8  hairFlip;
+    u8  eyeType;
+    u8  eyeColor;
+    u8  eyeScale;
+    u8  eyeAspect;
+    u8  eyeRotate;
+    u8  eyeX;
+    u8  eyeY;
+    u8  eyebrowType;
+    u8  eyebrowColor;
+    u8  eyebrowScale;
+    u8  eyebrowAspect;
+    u8  eyebrowRotate;
+    u8  eyebrowX;
+    u8  eyebrowY;
+    u8  noseType;
+    u8  noseScale;
+    u8  noseY;
+    u8  mouthType;
+    u8  mouthColor;
+    u8  mouthScale;
+    u8  mouthAspect;
+    u8  mouthY;
+    u8  beardColor;
+    u8  beardType;
+    u8  mustacheType;
+    u8  mustacheScale;
+    u8  mustacheY;
+    u8  glassType;
+    u8  glassColor;
+    u8  glassScale;
+    u8  glassY;
+    u8  moleType;
+    u8  moleScale;
+    u8  moleX;
+    u8  moleY;
+    u8  padding;
+};
+
+static_assert(sizeof(NxCharInfo) == 0x58);
+
+/// Sizes of records accepted by the batch API: Ver3MiiDataCore and Ver3StoreData.
+static constexpr std::size_t Ver3CoreRecordSize  = 72;
+static constexpr std::size_t Ver3StoreRecordSize = 96;
+
 
 // We construct a single contiguous bitstream from the following in order:
 //   [reserved_0:2][authorType:4][reserved_1:1][reserved_2:8+8][padding_0:1][padding_1:4]
@@ -356,6 +641,14 @@ static constexpr int CommonColor_End = 100;
 static constexpr int FacelineColor_End = 10;
 static constexpr int GlassType_End = 20;
 
+/// Whether all of the fields are within the bounds above.
+inline bool FieldsInRange(const NxExtensionFields& fields) {
+    return fields.facelineColor < FacelineColor_End && fields.hairColor < CommonColor_End &&
+           fields.eyeColor < CommonColor_End && fields.eyebrowColor < CommonColor_End &&
+           fields.mouthColor < CommonColor_End && fields.beardColor < CommonColor_End &&
+           fields.glassColor < CommonColor_End && fields.glassType < GlassType_End;
+}
+
 // Tables are originally from MiiPort: https://github.com/Genwald/MiiPort/blob/4ee38bbb8aa68a2365e9c48d59d7709f760f9b5d/include/convert_mii.h#L18
 // The values have been reordered, because the maximum "grouped index" values
 // for most part types barely exceeded 31, and after modifications, the
@@ -366,42 +659,65 @@ static constexpr int GlassType_End = 20;
 // more free index to represent placeholder for a value representing
 // to use the original Ver3 color present in the data.
 
-static constexpr auto ToVer3HairColorTable = std::array<u8, CommonColor_End>({
+inline constexpr auto ToVer3HairColorTable = std::array<u8, CommonColor_End>({
     /* 0:  */ 0, 1, 2, 3, 4, 5, 6, 7, 0, 4, 3, 5, 4, 5 /* < 13, orig. val: 4 */, 6, 2, 0, 6, 4, 3, 2, 2, 7, 3, 2, 2,
     /* 26: */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 4, 4, 4, 4, 4, 4, 4, 0, 0, 4, 4,
     /* 52: */ 4, 4, 4, 4, 0, 0, 0, 5 /* < 59, orig. val: 4 */, 4, 4, 4, 4, 4, 5, 5, 5, 4, 4, 7 /* 70, < orig. val: 4 */, 4, 4, 4, 4, 5, 7, 5,
     /* 78: */ 7, 7, 7, 7, 7, 6, 7, 7, 7, 7, 7, 3, 7, 7, 7, 7, 7, 0, 4, 4, 4, 4,
 });
 
-static constexpr auto ToVer3EyeColorTable = std::array<u8, CommonColor_End>({
+inline constexpr auto ToVer3EyeColorTable = std::array<u8, CommonColor_End>({
     /* 0:  */ 0, 2, 2, 2, 1, 3, 2, 3, 0, 1, 2, 3, 4, 5, 2, 2, 4, 2, 1, 2, 2, 2, 2, 2, 2, 2,
     /* 26: */ 2, 1 /* < 27, orig. val: 2 */, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1 /* < 37, orig. val: 2 */, 0, 0, 4, 4, 4, 4, 4, 4, 4, 1, 0, 4, 4, 4,
     /* 52: */ 4, 4, 4, 4, 0, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 3, 3, 3,
     /* 78: */ 3, 3, 3, 3, 3, 2, 2, 3, 3, 3, 3, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
 });
 
-static constexpr auto ToVer3MouthColorTable = std::array<u8, CommonColor_End>({
+inline constexpr auto ToVer3MouthColorTable = std::array<u8, CommonColor_End>({
     /* 0:  */ 4, 4, 4, 4, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4, 1, 4, 4, 4, 0, 1, 2, 3, 4, 4, 2,
     /* 26: */ 3, 3, 4, 4, 4, 4, 1, 4, 4, 2, 3, 3, 4, 4, 4, 4, 4, 4, 4, 3, 3, 3, 4, 4, 4, 3,
     /* 52: */ 3, 3, 3, 3, 4, 4, 4, 4, 4, 3, 3, 3, 3, 4, 4, 4, 4, 3, 3, 3, 3, 3, 3, 4, 4, 3,
     /* 78: */ 3, 3, 3, 3, 3, 4, 3, 3, 3, 3, 3, 4, 0, 3, 3, 3, 3, 4, 3, 3, 3, 3,
 });
 
-static constexpr auto ToVer3GlassColorTable = std::array<u8, CommonColor_End>({
+inline constexpr auto ToVer3GlassColorTable = std::array<u8, CommonColor_End>({
     /* 0:  */ 0, 1, 1, 1, 5, 1, 1, 4, 0, 5, 1, 1, 3, 5, 1, 2, 3, 4, 5, 4, 2, 2, 4, 4, 2, 2,
     /* 26: */ 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
     /* 52: */ 3, 3, 3, 3, 0, 0, 0, 5, 5, 5, 5, 5, 5, 0, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 4 /* < 77, orig. val: 5 */,
     /* 78: */ 5, 5, 5, 5, 5, 1, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5,
 });
 
-static constexpr auto ToVer3FacelineColorTable = std::array<u8, FacelineColor_End>({
+inline constexpr auto ToVer3FacelineColorTable = std::array<u8, FacelineColor_End>({
     0, 1, 2, 3, 4, 5, 0, 1, 5, 5
 });
 
-static constexpr auto ToVer3GlassTypeTable = std::array<u8, GlassType_End>({
+inline constexpr auto ToVer3GlassTypeTable = std::array<u8, GlassType_End>({
     0, 1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 1, 3, 7, 7, 6, 7, 8, 7, 7
 });
 
+// Ver3 -> Ver4 for Miis without extension fields, as nn::mii converts them.
+// Faceline colors and glass types 0-5/0-8 are the same on both.
+
+inline constexpr auto FromVer3HairColorTable  = std::array<u8, 8>({ 8, 1, 2, 3, 4, 5, 6, 7 });
+inline constexpr auto FromVer3EyeColorTable   = std::array<u8, 6>({ 8, 9, 10, 11, 12, 13 });
+inline constexpr auto FromVer3MouthColorTable = std::array<u8, 5>({ 19, 20, 21, 22, 23 });
+inline constexpr auto FromVer3GlassColorTable = std::array<u8, 6>({ 8, 14, 15, 16, 17, 18 });
+
+/// Each FromVer3 entry must convert back to the Ver3 value it came from.
+template <std::size_t N, std::size_t M>
+constexpr bool IsInverseOf(const std::array<u8, N>& fromVer3, const std::array<u8, M>& toVer3) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (toVer3[fromVer3[i]] != i) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(IsInverseOf(FromVer3HairColorTable, ToVer3HairColorTable) &&
+              IsInverseOf(FromVer3EyeColorTable, ToVer3EyeColorTable) &&
+              IsInverseOf(FromVer3MouthColorTable, ToVer3MouthColorTable) &&
+              IsInverseOf(FromVer3GlassColorTable, ToVer3GlassColorTable));
+
 // // ---------------------------------------------------------------
 // //  Compile-time utilities
 // // ---------------------------------------------------------------
@@ -462,12 +778,12 @@ static constexpr int Ver3FacelineColor_End = 6;
 static constexpr int Ver3GlassType_End = 9;
 
 // Concrete reverse maps for our tables.
-static constexpr auto RevHairColors  = BuildReverseMap<ToVer3HairColorTable.size(), Ver3HairColor_End>(ToVer3HairColorTable);
-static constexpr auto RevEyeColors   = BuildReverseMap<ToVer3EyeColorTable.size(), Ver3EyeColor_End>(ToVer3EyeColorTable);
-static constexpr auto RevMouthColors = BuildReverseMap<ToVer3MouthColorTable.size(), Ver3MouthColor_End>(ToVer3MouthColorTable);
-static constexpr auto RevGlassColors = BuildReverseMap<ToVer3GlassColorTable.size(), Ver3GlassType_End>(ToVer3GlassColorTable);
-static constexpr auto RevFaceColors  = BuildReverseMap<ToVer3FacelineColorTable.size(), Ver3FacelineColor_End>(ToVer3FacelineColorTable);
-static constexpr auto RevGlassTypes  = BuildReverseMap<ToVer3GlassTypeTable.size(), Ver3GlassType_End>(ToVer3GlassTypeTable);
+inline constexpr auto RevHairColors  = BuildReverseMap<ToVer3HairColorTable.size(), Ver3HairColor_End>(ToVer3HairColorTable);
+inline constexpr auto RevEyeColors   = BuildReverseMap<ToVer3EyeColorTable.size(), Ver3EyeColor_End>(ToVer3EyeColorTable);
+inline constexpr auto RevMouthColors = BuildReverseMap<ToVer3MouthColorTable.size(), Ver3MouthColor_End>(ToVer3MouthColorTable);
+inline constexpr auto RevGlassColors = BuildReverseMap<ToVer3GlassColorTable.size(), Ver3GlassType_End>(ToVer3GlassColorTable);
+inline constexpr auto RevFaceColors  = BuildReverseMap<ToVer3FacelineColorTable.size(), Ver3FacelineColor_End>(ToVer3FacelineColorTable);
+inline constexpr auto RevGlassTypes  = BuildReverseMap<ToVer3GlassTypeTable.size(), Ver3GlassType_End>(ToVer3GlassTypeTable);
 
 // Bit widths required by each group index (compile-time).
 static constexpr std::size_t FacelineColorBits = CeilLog2(RevFaceColors.maxGroupSize);
@@ -493,40 +809,302 @@ static constexpr std::size_t UsedIndexBits =
     FacelineColorBits + HairColorBits + EyeColorBits + EyebrowColorBits + MouthColorBits + BeardColorBits + GlassColorBits + GlassTypeBits;
 
 // // ---------------------------------------------------------------
-// //  Bit Pack/Unpack Helpers
+// //  Fused Lookup Tables
 // // ---------------------------------------------------------------
+// The reverse maps above are only used to build these. At runtime, each
+// field costs one load from `encode` when packing, and one from `decode`
+// when unpacking. They are `inline`, so there is one copy in the binary.
 
-/// Writes `width` LSBs of `value` at bit offset `bitOff` into `dst` (LSB-first).
-inline void PutBits(u8* dst, std::size_t bitOff, std::size_t width, std::uint64_t value) {
-    // We avoid branches and write byte-wise. This function is endian-independent.
-    std::size_t bit = bitOff;
-    for (std::size_t i = 0; i < width; ++i, ++bit) {
-        std::size_t byteIndex = bit >> 3;
-        std::size_t bitIndex  = bit & 7;
-        u8 mask = static_cast<u8>(1u << bitIndex);
-        if (value & (1ull << i)) {
-            dst[byteIndex] = static_cast<u8>(dst[byteIndex] | mask);
-        } else {
-            dst[byteIndex] = static_cast<u8>(dst[byteIndex] & static_cast<u8>(~mask));
+/**
+ * @brief Per-field tables for both directions, derived from a ToVer3 table.
+ * @tparam TableN    Number of Ver4 indices.
+ * @tparam GroupSize Largest bucket, i.e. the divisor of `encode`.
+ * @tparam Ver3Rows  Every value the visible Ver3 field can hold.
+ */
+template <std::size_t TableN, std::size_t GroupSize, std::size_t Ver3Rows>
+struct FusedFieldTable {
+    static constexpr std::size_t GroupBits = CeilLog2(GroupSize);
+    static constexpr std::size_t MaxGroupSize = GroupSize;
+
+    /// Per ver4 index: ver3 * GroupSize + groupIndex.
+    std::array<u8, TableN> encode{};
+    /// Ver4 index at (ver3 << GroupBits) | groupIndex. Group indices past the end of
+    /// their bucket are clamped to its last entry, and Ver3 values with no bucket use bucket 0.
+    std::array<u8, (Ver3Rows << GroupBits)> decode{};
+    /// Bucket size per Ver3 value, 0 if it has none.
+    std::array<u8, Ver3Rows> counts{};
+    /// Largest value in `encode` before narrowing, checked below.
+    u16 maxEncoded = 0;
+};
+
+template <std::size_t GroupSize, std::size_t Ver3Rows, std::size_t TableN, std::size_t Ver3MaxPlus1>
+constexpr FusedFieldTable<TableN, GroupSize, Ver3Rows>
+BuildFusedTable(const StaticReverseMap<TableN, Ver3MaxPlus1>& rev, const std::array<u8, TableN>& toVer3)
+{
+    // RevGlassColors has trailing empty buckets past Ver3Rows, so only the rows are walked.
+    using Table = FusedFieldTable<TableN, GroupSize, Ver3Rows>;
+    Table out{};
+    for (std::size_t i = 0; i < TableN; ++i) {
+        const std::size_t encoded = toVer3[i] * GroupSize + rev.positionInGroup[i];
+        out.encode[i] = static_cast<u8>(encoded);
+        if (encoded > out.maxEncoded) {
+            out.maxEncoded = static_cast<u16>(encoded);
         }
     }
-}
-
-/// Reads `width` bits at bit offset `bitOff` from `src` (LSB-first).
-inline std::uint64_t GetBits(const u8* src, std::size_t bitOff, std::size_t width) {
-    std::uint64_t out = 0;
-    std::size_t bit = bitOff;
-    for (std::size_t i = 0; i < width; ++i, ++bit) {
-        std::size_t byteIndex = bit >> 3;
-        std::size_t bitIndex  = bit & 7;
-        u8 mask = static_cast<u8>(1u << bitIndex);
-        if (src[byteIndex] & mask) {
-            out |= (1ull << i);
+    for (std::size_t v3 = 0; v3 < Ver3Rows; ++v3) {
+        const std::size_t count = v3 < Ver3MaxPlus1 ? rev.counts[v3] : 0;
+        out.counts[v3] = static_cast<u8>(count);
+        const std::size_t bucket = count != 0 ? v3 : 0;
+        const std::size_t last = rev.counts[bucket] - 1u;
+        for (std::size_t gi = 0; gi < (std::size_t(1) << Table::GroupBits); ++gi) {
+            out.decode[(v3 << Table::GroupBits) | gi] = rev.byGroup[bucket][gi < last ? gi : last];
         }
     }
     return out;
 }
 
+/// Number of values a visible Ver3 field can hold.
+constexpr std::size_t Ver3FieldRange(Ver3Field field) {
+    return std::size_t(1) << Ver3FieldDescs[static_cast<std::size_t>(field)].width;
+}
+
+inline constexpr auto FusedFaceColors  = BuildFusedTable<RevFaceColors.maxGroupSize,  Ver3FieldRange(Ver3Field::FaceColor)>(RevFaceColors, ToVer3FacelineColorTable);
+/// Shared by hair, eyebrow and beard, whose Ver3 fields are all 3 bits.
+inline constexpr auto FusedHairColors  = BuildFusedTable<RevHairColors.maxGroupSize,  Ver3FieldRange(Ver3Field::HairColor)>(RevHairColors, ToVer3HairColorTable);
+inline constexpr auto FusedEyeColors   = BuildFusedTable<RevEyeColors.maxGroupSize,   Ver3FieldRange(Ver3Field::EyeColor)>(RevEyeColors, ToVer3EyeColorTable);
+inline constexpr auto FusedMouthColors = BuildFusedTable<RevMouthColors.maxGroupSize, Ver3FieldRange(Ver3Field::MouthColor)>(RevMouthColors, ToVer3MouthColorTable);
+inline constexpr auto FusedGlassColors = BuildFusedTable<RevGlassColors.maxGroupSize, Ver3FieldRange(Ver3Field::GlassColor)>(RevGlassColors, ToVer3GlassColorTable);
+inline constexpr auto FusedGlassTypes  = BuildFusedTable<RevGlassTypes.maxGroupSize,  Ver3FieldRange(Ver3Field::GlassType)>(RevGlassTypes, ToVer3GlassTypeTable);
+
+static_assert(Ver3FieldRange(Ver3Field::EyebrowColor) == Ver3FieldRange(Ver3Field::HairColor) &&
+              Ver3FieldRange(Ver3Field::BeardColor) == Ver3FieldRange(Ver3Field::HairColor));
+static_assert(FusedFaceColors.maxEncoded <= 0xFF && FusedHairColors.maxEncoded <= 0xFF &&
+              FusedEyeColors.maxEncoded <= 0xFF && FusedMouthColors.maxEncoded <= 0xFF &&
+              FusedGlassColors.maxEncoded <= 0xFF && FusedGlassTypes.maxEncoded <= 0xFF,
+              "Fused (ver3, groupIndex) must fit in a u8.");
+
+// // ---------------------------------------------------------------
+// //  Bit Layout Schema
+// // ---------------------------------------------------------------
+// Every bit layout in this file is described once, as a constexpr array of
+// fields in LSB-first order. Offsets and masks are derived from the widths
+// at compile time, and GatherFields()/ScatterFields() unroll into constant
+// shifts and masks on a single 64-bit word. There is no per-bit loop.
+
+/// A field in a layout that is only ever read/written as a whole word.
+struct BitField {
+    u8 width;
+};
+
+/// A field in a layout that maps to a member of `Record`.
+/// The accessors are captureless lambdas, so they inline away.
+template <typename Record>
+struct SchemaField {
+    u8 width;
+    u32  (*get)(const Record&);
+    void (*set)(Record&, u32);
+};
+
+/// A field in a layout that maps to a field of a Ver3MiiView.
+struct Ver3SchemaField {
+    u8 width;
+    Ver3Field field;
+};
+
+/// Start offset of each field. offsets[N] is the total width.
+template <typename Field, std::size_t N>
+constexpr std::array<std::size_t, N + 1> BitOffsetsOf(const std::array<Field, N>& schema) {
+    std::array<std::size_t, N + 1> offsets{};
+    for (std::size_t i = 0; i < N; ++i) {
+        offsets[i + 1] = offsets[i] + schema[i].width;
+    }
+    return offsets;
+}
+
+constexpr u64 BitMask(std::size_t width) {
+    return width >= 64 ? ~u64(0) : (u64(1) << width) - 1;
+}
+
+/// Reads field I of Schema from `word`.
+template <const auto& Schema, std::size_t I>
+constexpr u64 GetField(u64 word) {
+    constexpr std::size_t offset = BitOffsetsOf(Schema)[I];
+    return (word >> offset) & BitMask(Schema[I].width);
+}
+
+/// Returns `word` with field I of Schema replaced by `value`.
+template <const auto& Schema, std::size_t I>
+constexpr u64 SetField(u64 word, u64 value) {
+    constexpr std::size_t offset = BitOffsetsOf(Schema)[I];
+    constexpr u64 mask = BitMask(Schema[I].width) << offset;
+    return (word & ~mask) | ((value << offset) & mask);
+}
+
+template <const auto& Schema, std::size_t I>
+constexpr bool IsVer3SchemaField = std::is_same_v<std::remove_cvref_t<decltype(Schema[I])>, Ver3SchemaField>;
+
+template <const auto& Schema, std::size_t I, typename Record>
+constexpr u32 ReadSchemaField(const Record& record) {
+    if constexpr (IsVer3SchemaField<Schema, I>) {
+        return record.template Get<Schema[I].field>();
+    } else {
+        return Schema[I].get(record);
+    }
+}
+
+template <const auto& Schema, std::size_t I, typename Record>
+constexpr void WriteSchemaField(Record& record, u32 value) {
+    if constexpr (IsVer3SchemaField<Schema, I>) {
+        record.template Set<Schema[I].field>(value);
+    } else {
+        Schema[I].set(record, value);
+    }
+}
+
+template <const auto& Schema, typename Record, std::size_t... I>
+constexpr u64 GatherFieldsImpl(const Record& record, std::index_sequence<I...>) {
+    return (SetField<Schema, I>(0, ReadSchemaField<Schema, I>(record)) | ... | 0);
+}
+
+template <const auto& Schema, typename Record, std::size_t... I>
+constexpr void ScatterFieldsImpl(u64 word, Record& record, std::index_sequence<I...>) {
+    (WriteSchemaField<Schema, I>(record, static_cast<u32>(GetField<Schema, I>(word))), ...);
+}
+
+/// Packs every field of `record` described by Schema into one word.
+template <const auto& Schema, typename Record>
+constexpr u64 GatherFields(const Record& record) {
+    return GatherFieldsImpl<Schema>(record, std::make_index_sequence<Schema.size()>{});
+}
+
+/// Writes every field described by Schema from `word` into `record`.
+template <const auto& Schema, typename Record>
+constexpr void ScatterFields(u64 word, Record& record) {
+    ScatterFieldsImpl<Schema>(word, record, std::make_index_sequence<Schema.size()>{});
+}
+
+/// Loads the 7-byte block as one LSB-first word.
+constexpr u64 LoadBlock(const ExtraDataBlock& block) {
+    u64 word = 0;
+    for (int i = 0; i < EXTRA_BYTES_TOTAL; ++i) {
+        word |= u64(block.data[i]) << (i * 8);
+    }
+    return word;
+}
+
+/// Stores one LSB-first word as the 7-byte block.
+constexpr void StoreBlock(u64 word, ExtraDataBlock& block) {
+    for (int i = 0; i < EXTRA_BYTES_TOTAL; ++i) {
+        block.data[i] = static_cast<u8>(word >> (i * 8));
+    }
+}
+
+// // ---------------------------------------------------------------
+// //  Layout: Ver3 Fields <-> ExtraDataBlock
+// // ---------------------------------------------------------------
+
+/// Fields of Ver3MiiDataCore that make up the ExtraDataBlock, in block order.
+enum Ver3PaddingFieldId {
+    Ver3Padding_Reserved0,
+    Ver3Padding_AuthorType,
+    Ver3Padding_Reserved1,
+    Ver3Padding_Reserved2_0,
+    Ver3Padding_Reserved2_1,
+    Ver3Padding_Padding0,
+    Ver3Padding_Padding1,
+    Ver3Padding_Padding2,
+    Ver3Padding_Padding3,
+    Ver3Padding_Padding4,
+    Ver3Padding_Padding5,
+    Ver3Padding_Padding6,
+    Ver3Padding_Padding7,
+    Ver3Padding_Padding8,
+    Ver3Padding_RoomIndex,
+    Ver3Padding_PositionInRoom,
+    Ver3Padding_Count
+};
+
+/// authorType is an unused field always unread and 0. There is even an enum
+/// for it, but it only has one value "0 = Normal". It was presumably for UGC.
+///
+/// roomIndex/positionInRoom are only used on the 3DS database.
+/// They should otherwise be unused on Wii U and in data transmission.
+/// Their max value is 9, otherwise verification fails. So, only 3 bits are used.
+/// Because these can be non-zero, they are put at the end.
+static constexpr std::array<Ver3SchemaField, Ver3Padding_Count> Ver3PaddingSchema = {{
+    { 2, Ver3Field::Reserved0 },
+    { 4, Ver3Field::AuthorType },
+    { 1, Ver3Field::Reserved1 },
+    { 8, Ver3Field::Reserved2_0 },
+    { 8, Ver3Field::Reserved2_1 },
+    { 1, Ver3Field::Padding0 },
+    { 4, Ver3Field::Padding1 },
+    { 2, Ver3Field::Padding2 },
+    { 1, Ver3Field::Padding3 },
+    { 2, Ver3Field::Padding4 },
+    { 2, Ver3Field::Padding5 },
+    { 8, Ver3Field::Padding6 },
+    { 1, Ver3Field::Padding7 },
+    { 1, Ver3Field::Padding8 },
+    { 3, Ver3Field::RoomIndex },
+    { 3, Ver3Field::PositionInRoom },
+}};
+
+static_assert(BitOffsetsOf(Ver3PaddingSchema)[Ver3Padding_Count] == EXTRA_BITS_TOTAL,
+    "Ver3PaddingSchema must cover the whole ExtraDataBlock.");
+
+// // ---------------------------------------------------------------
+// //  Layout: ExtraDataBlock Contents
+// // ---------------------------------------------------------------
+// The spare bits after the group indices mark the data as eFFSD.
+//
+// The flag and encoding bits both land in padding_6, so QuickDetect()
+// can reject ordinary Mii data with a single 16-bit load.
+// The checksum covers the group indices, the encoding, and the visible
+// Ver3 colors, so editing a color in an old editor invalidates the data.
+
+enum ExtraBlockFieldId {
+    ExtraBlock_GroupIndices,
+    ExtraBlock_Flag,
+    ExtraBlock_Encoding,
+    ExtraBlock_Checksum,
+    ExtraBlock_Reserved, ///< roomIndex/positionInRoom, must stay zero for 3DS.
+    ExtraBlock_Count
+};
+
+static constexpr std::array<BitField, ExtraBlock_Count> ExtraBlockSchema = {{
+    { static_cast<u8>(UsedIndexBits) },
+    { 1 },
+    { 2 },
+    { 6 },
+    { 6 },
+}};
+static_assert(BitOffsetsOf(ExtraBlockSchema)[ExtraBlock_Count] == EXTRA_BITS_TOTAL);
+
+static constexpr std::size_t ExtraFlagBit      = BitOffsetsOf(ExtraBlockSchema)[ExtraBlock_Flag];
+static constexpr std::size_t ExtraEncodingBit  = BitOffsetsOf(ExtraBlockSchema)[ExtraBlock_Encoding];
+static constexpr std::size_t ExtraEncodingBits = ExtraBlockSchema[ExtraBlock_Encoding].width;
+static constexpr std::size_t ExtraChecksumBit  = BitOffsetsOf(ExtraBlockSchema)[ExtraBlock_Checksum];
+static constexpr std::size_t ExtraChecksumBits = ExtraBlockSchema[ExtraBlock_Checksum].width;
+static constexpr std::size_t ExtraReservedBit  = BitOffsetsOf(ExtraBlockSchema)[ExtraBlock_Reserved];
+static_assert(ExtraReservedBit == BitOffsetsOf(Ver3PaddingSchema)[Ver3Padding_RoomIndex],
+    "Spare bits must not overlap roomIndex/positionInRoom.");
+
+/// How the group indices are stored in the block.
+enum ExtraEncoding : u8 {
+    ExtraEncoding_FixedWidth = 0, ///< Each group index has its own bit range.
+    /// The group indices are digits of two mixed-radix integers, where each radix is the
+    /// bucket size for the visible Ver3 color. The bits this saves extend the checksum.
+    ExtraEncoding_MixedRadix = 1,
+    ExtraEncoding_Count
+};
+
+/// Bit offset of padding_6 within the ExtraDataBlock.
+static constexpr std::size_t ExtraPadding6Bit = BitOffsetsOf(Ver3PaddingSchema)[Ver3Padding_Padding6];
+static_assert(ExtraFlagBit >= ExtraPadding6Bit &&
+    ExtraEncodingBit + ExtraEncodingBits <= ExtraPadding6Bit + Ver3PaddingSchema[Ver3Padding_Padding6].width,
+    "Flag and encoding must be in padding_6 for QuickDetect().");
+
 // // ---------------------------------------------------------------
 // //  ExtraDataBlock <-> Ver3 fields (contiguous).
 // // ---------------------------------------------------------------
@@ -544,40 +1122,232 @@ public:
     };
 
     // Public packing/unpacking API.
+    // These work on raw Mii data of either byte order through Ver3MiiView.
+    // The Ver3MiiDataCore overloads use the host's own layout (ViewOf()).
 
-    /// @brief Packs Ver4/NX (Switch) indices into Ver3MiiDataCore.
+    /// @brief Packs Ver4/NX (Switch) indices into Ver3 Mii data.
     /// @detail
     /// - Converts ver4 to ver3 visible indices with ToVer3 tables.
     /// - Builds group indices and packs them into the ExtraDataBlock.
-    /// - Writes the block into available fields of the Ver3 struct.
-    static void Pack(const NxExtensionFields& ver4, Ver3MiiDataCore& mii);
-    /// @brief Unpacks Ver4/NX (Switch) indices from Ver3MiiDataCore.
+    /// - Writes the block into available fields of the Ver3 data.
+    /// @param encoding How to store the group indices. Both are always accepted when unpacking.
+    template <std::endian Order>
+    static void Pack(const NxExtensionFields& ver4, Ver3MiiView<Order> mii,
+        ExtraEncoding encoding = ExtraEncoding_FixedWidth);
+    static void Pack(const NxExtensionFields& ver4, Ver3MiiDataCore& mii,
+        ExtraEncoding encoding = ExtraEncoding_FixedWidth) {
+        Pack(ver4, ViewOf(mii), encoding);
+    }
+
+    /// @brief Unpacks Ver4/NX (Switch) indices from Ver3 Mii data.
     /// @detail
     /// - Reads ExtraDataBlock from the data.
     /// - Unpacks group indices and reconstructs ver4 indices using reverse maps.
-    static void Unpack(const Ver3MiiDataCore& mii, NxExtensionFields& outVer4);
+    /// Does not check whether the data contains them, see TryUnpack().
+    template <std::endian Order>
+    static void Unpack(Ver3MiiView<Order, const u8> mii, NxExtensionFields& outVer4);
+    static void Unpack(const Ver3MiiDataCore& mii, NxExtensionFields& outVer4) {
+        Unpack(ViewOf(mii), outVer4);
+    }
 
-    /// Overload to unpack Ver4/NX (Switch) indices from Ver3MiiDataCore
+    /// Overload to unpack Ver4/NX (Switch) indices from Ver3 Mii data
     /// using an already extracted ExtraDataBlock.
-    static void Unpack(const ExtraDataBlock& inBlock, const Ver3MiiDataCore& mii, NxExtensionFields& outVer4);
+    template <std::endian Order>
+    static void Unpack(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii, NxExtensionFields& outVer4);
+    static void Unpack(const ExtraDataBlock& inBlock, const Ver3MiiDataCore& mii, NxExtensionFields& outVer4) {
+        Unpack(inBlock, ViewOf(mii), outVer4);
+    }
 
     /// @brief Extracts the contiguous 51-bit extra block from the Ver3 data into `out`.
-    /// @detail The order and widths are fixed as documented above.
-    static void ExtractExtra(const Ver3MiiDataCore& mii, ExtraDataBlock& outBlock);
-    /// @brief Writes the contiguous 51-bit extra block from `in` into the Ver3MiiDataCore fields.
+    /// @detail The order and widths are in Ver3PaddingSchema.
+    template <std::endian Order>
+    static void ExtractExtra(Ver3MiiView<Order, const u8> mii, ExtraDataBlock& outBlock);
+    static void ExtractExtra(const Ver3MiiDataCore& mii, ExtraDataBlock& outBlock) {
+        ExtractExtra(ViewOf(mii), outBlock);
+    }
+    /// @brief Writes the contiguous 51-bit extra block from `in` into the Ver3 data.
     /// @detail The last 6 bits target roomIndex/positionInRoom.
     /// Three bits are used for each for a range of 0..7 to not exceed the max of 9.
-    static void WriteExtra(Ver3MiiDataCore& mii, const ExtraDataBlock& inBlock);
+    template <std::endian Order>
+    static void WriteExtra(Ver3MiiView<Order> mii, const ExtraDataBlock& inBlock);
+    static void WriteExtra(Ver3MiiDataCore& mii, const ExtraDataBlock& inBlock) {
+        WriteExtra(ViewOf(mii), inBlock);
+    }
+
+    /// @brief Cheaply checks whether the data may contain eFFSD extension fields.
+    /// @detail Only tests the flag and encoding bits with one 16-bit load.
+    /// A true result still needs to be confirmed with Detect() or TryUnpack().
+    template <std::endian Order>
+    static bool QuickDetect(Ver3MiiView<Order, const u8> mii) {
+        const u32 padding6 = mii.template Get<Ver3Field::Padding6>();
+        constexpr u32 flagMask = 1u << (ExtraFlagBit - ExtraPadding6Bit);
+        const u32 encoding = (padding6 >> (ExtraEncodingBit - ExtraPadding6Bit)) & ((1u << ExtraEncodingBits) - 1);
+        return (padding6 & flagMask) != 0 && encoding < ExtraEncoding_Count;
+    }
+    static bool QuickDetect(const Ver3MiiDataCore& mii) {
+        return QuickDetect(ViewOf(mii));
+    }
+    /// @brief Checks that the data contains valid eFFSD extension fields.
+    /// @detail QuickDetect(), then checks the group index ranges and the checksum.
+    /// @param inBlock Block already extracted from `mii` with ExtractExtra().
+    template <std::endian Order>
+    static bool Detect(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii);
+    static bool Detect(const ExtraDataBlock& inBlock, const Ver3MiiDataCore& mii) {
+        return Detect(inBlock, ViewOf(mii));
+    }
+    /// @brief Unpacks Ver4/NX (Switch) indices only if the data contains them.
+    /// @return False if Detect() fails. `outVer4` is not modified in that case.
+    template <std::endian Order>
+    static bool TryUnpack(Ver3MiiView<Order, const u8> mii, NxExtensionFields& outVer4);
+    static bool TryUnpack(const Ver3MiiDataCore& mii, NxExtensionFields& outVer4) {
+        return TryUnpack(ViewOf(mii), outVer4);
+    }
+    /// @brief Whether the visible Ver3 colors are what `ver4` converts to, as when
+    ///        nn::mii writes a Switch Mii to an amiibo along with its extension.
+    /// @return False if any field is out of range or converts to a different color,
+    ///         e.g. the Mii was edited on a 3DS/Wii U after the extension was written.
+    template <std::endian Order>
+    static bool MatchesVisible(const NxExtensionFields& ver4, Ver3MiiView<Order, const u8> mii);
+    /// Computes the checksum stored at ExtraChecksumBit.
+    template <std::endian Order>
+    static u8 ComputeChecksum(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii);
+
+    // Batch API.
+    // Records are contiguous, `stride` bytes apart (usually 72 or 96), and only
+    // their first 72 bytes are touched. Work is done in chunks: table lookups run
+    // per field over the whole chunk, so the compiler can vectorize them as gathers.
+    // For 96-byte Ver3StoreData records, call UpdateStoreDataCrc() on each afterwards.
+
+    /// @brief Pack() for `count` records, reading field `i` from each array of `ver4`.
+    /// @detail Values in `ver4` must be in range, as with Pack().
+    template <std::endian Order>
+    static void PackBatch(const NxExtensionFieldsSoA& ver4, u8* records, std::size_t count, std::size_t stride,
+        ExtraEncoding encoding = ExtraEncoding_FixedWidth);
+    /// @brief Unpack() for `count` records into the arrays of `outVer4`.
+    /// @param outDetected Optional, receives 1 for each record that passes Detect(), otherwise 0.
+    ///                    Fields are always written, like Unpack().
+    /// @return Number of records that passed Detect().
+    template <std::endian Order>
+    static std::size_t UnpackBatch(const u8* records, std::size_t count, std::size_t stride,
+        const NxExtensionFieldsSoA& outVer4, u8* outDetected);
+
+    // Switch export.
+
+    /// @brief Converts Ver3 Mii data to a Switch CharInfo.
+    /// @detail Colors and glass type come from the extension fields if the data has them
+    ///         (TryUnpack()), otherwise from the visible Ver3 values with the FromVer3 tables.
+    ///         The create ID is derived from the Ver3 author and create IDs.
+    /// @return True if the extension fields were used.
+    template <std::endian Order>
+    static bool ToCharInfo(Ver3MiiView<Order, const u8> mii, NxCharInfo& out);
+    /// @brief ToCharInfo() for `count` records, with the extension fields already unpacked,
+    ///        e.g. by UnpackBatch(). `ver4` is only read for records where `detected` is 1.
+    template <std::endian Order>
+    static void ToCharInfoBatch(const u8* records, std::size_t count, std::size_t stride,
+        const NxExtensionFieldsSoA& ver4, const u8* detected, NxCharInfo* out);
+    /// @brief ToCharInfo() for `count` records. Unpacks in chunks on the stack, so nothing is allocated.
+    /// @return Number of records that had extension fields.
+    template <std::endian Order>
+    static std::size_t ToCharInfoBatch(const u8* records, std::size_t count, std::size_t stride, NxCharInfo* out);
 
     // Staging.
-    /// Packs the Ver4/NX (Switch) grouped indices into the ExtraDataBlock.
+    /// Encodes the group indices with the flag, encoding and checksum, and writes the block.
+    /// The visible Ver3 colors must already be written, since the checksum covers them.
+    template <std::endian Order>
+    static void WriteMarkedBlock(const GroupIndices& gi, ExtraEncoding encoding, Ver3MiiView<Order> mii);
+    /// Packs the Ver4/NX (Switch) grouped indices into the ExtraDataBlock (ExtraEncoding_FixedWidth).
     static void EncodeGroupIndices(const GroupIndices& gi, ExtraDataBlock& outBlock);
-    /// Unpacks the Ver4/NX (Switch) grouped indices from the ExtraDataBlock.
+    /// Unpacks the Ver4/NX (Switch) grouped indices from the ExtraDataBlock (ExtraEncoding_FixedWidth).
     static void DecodeGroupIndices(const ExtraDataBlock& inBlock, GroupIndices& gi);
+    /// Packs the grouped indices with ExtraEncoding_MixedRadix. The extended checksum
+    /// is added by WriteMarkedBlock(). The radices come from the visible Ver3 colors.
+    template <std::endian Order>
+    static void EncodeGroupIndicesMixedRadix(const GroupIndices& gi, Ver3MiiView<Order, const u8> mii, ExtraDataBlock& outBlock);
+    /// Unpacks the grouped indices with whichever encoding the block is marked with.
+    template <std::endian Order>
+    static void DecodeGroupIndices(const ExtraDataBlock& inBlock, Ver3MiiView<Order, const u8> mii, GroupIndices& gi);
 };
 
+// // ---------------------------------------------------------------
+// //  Layout: Group Indices
+// // ---------------------------------------------------------------
+// Packed at the start of the ExtraDataBlock (ExtraBlock_GroupIndices).
+
+#define GROUP_INDEX_FIELD(member, width) \
+    SchemaField<NxInVer3Pack::GroupIndices>{ static_cast<u8>(width), \
+        [](const NxInVer3Pack::GroupIndices& gi) -> u32 { return gi.member; }, \
+        [](NxInVer3Pack::GroupIndices& gi, u32 value) { gi.member = static_cast<u8>(value); } }
+
+static constexpr std::array GroupIndexSchema = {
+    GROUP_INDEX_FIELD(faceGI,       FacelineColorBits),
+    GROUP_INDEX_FIELD(hairGI,       HairColorBits),
+    GROUP_INDEX_FIELD(eyeGI,        EyeColorBits),
+    GROUP_INDEX_FIELD(browGI,       EyebrowColorBits),
+    GROUP_INDEX_FIELD(mouthGI,      MouthColorBits),
+    GROUP_INDEX_FIELD(beardGI,      BeardColorBits),
+    GROUP_INDEX_FIELD(glassColorGI, GlassColorBits),
+    GROUP_INDEX_FIELD(glassTypeGI,  GlassTypeBits),
+};
+
+#undef GROUP_INDEX_FIELD
+
+static_assert(BitOffsetsOf(GroupIndexSchema)[GroupIndexSchema.size()] == UsedIndexBits);
+
+// // ---------------------------------------------------------------
+// //  amiibo Import
+// // ---------------------------------------------------------------
+// Decrypted amiibo dumps hold the owner's Ver3StoreData (little-endian), and the
+// Switch writes its NfpStoreDataExtension next to it. Offsets are in tag page
+// order, which is what amiitool -d writes, not amiitool's internal order.
+
+static constexpr std::size_t AmiiboFlagsOffset     = 0x14;
+static constexpr u8          AmiiboFlagHasOwnerMii = 1 << 4;
+static constexpr std::size_t AmiiboMiiOffset       = 0xA0;
+static constexpr std::size_t AmiiboExtensionOffset = 0x110;
+/// NTAG215 dumps: without the last two pages, full, and with the 32-byte signature.
+static constexpr std::size_t AmiiboDumpSizes[] = { 532, 540, 572 };
+/// A bare Ver3StoreData followed by its NfpStoreDataExtension.
+static constexpr std::size_t StoreDataWithExtensionSize = Ver3StoreRecordSize + sizeof(NxExtensionFields);
+
+static_assert(AmiiboExtensionOffset == AmiiboMiiOffset + Ver3StoreRecordSize + 0x10);
+
+enum AmiiboImportResult {
+    AmiiboImport_Success,
+    AmiiboImport_UnknownSize,  ///< Not an amiibo dump nor StoreDataWithExtensionSize.
+    AmiiboImport_NoOwnerMii,   ///< The amiibo was never registered.
+    AmiiboImport_BadChecksum,  ///< The Mii CRC doesn't match, usually because the dump is still encrypted.
+};
+
+/**
+ * @brief Finds the owner Mii and extension in a decrypted amiibo dump,
+ *        or in a raw Ver3StoreData + NfpStoreDataExtension.
+ * @param outStoreData Receives the 96-byte Ver3StoreData, in the file format.
+ * @param outVer4      Receives the extension as stored. It can be all zeros or stale
+ *                     if the amiibo was last written by a 3DS/Wii U, see MatchesVisible().
+ */
+AmiiboImportResult ExtractAmiiboMii(const u8* data, std::size_t size,
+    u8 (&outStoreData)[Ver3StoreRecordSize], NxExtensionFields& outVer4);
+
 // C ABI wrappers.
 extern "C" {
     void NxInVer3Pack_Pack(const NxExtensionFields* in, Ver3MiiDataCore* out);
     void NxInVer3Pack_Unpack(const Ver3MiiDataCore* in, NxExtensionFields* out);
+    /// Returns 1 and fills `out` if `in` contains extension fields, otherwise 0.
+    int NxInVer3Pack_TryUnpack(const Ver3MiiDataCore* in, NxExtensionFields* out);
+
+    // Batch versions. `records` are in the little-endian file format.
+    void NxInVer3Pack_PackBatch(const NxExtensionFieldsSoA* in, u8* records, u32 count, u32 stride);
+    /// Returns the number of records containing extension fields. `outDetected` may be null.
+    u32 NxInVer3Pack_UnpackBatch(const u8* records, u32 count, u32 stride, const NxExtensionFieldsSoA* out, u8* outDetected);
+
+    // Checksums of 96-byte Ver3StoreData records. PackBatch doesn't update them.
+    void NxInVer3Pack_UpdateStoreDataCrc(u8* records, u32 count, u32 stride);
+    /// Returns the number of records whose checksum is valid.
+    u32 NxInVer3Pack_VerifyStoreDataCrc(const u8* records, u32 count, u32 stride);
+
+    /// Converts `count` records to Switch CharInfo.
+    /// Returns the number of records that had extension fields.
+    u32 NxInVer3Pack_ToCharInfoBatch(const u8* records, u32 count, u32 stride, NxCharInfo* out);
 }
+// NOTE: The C ABI takes Ver3MiiDataCore in the host's layout,
+// which for wasm/x86 is the same as the little-endian file format.
@@ -0,0 +1,166 @@
+#include "NxOverrideDb.hpp"
+#include <algorithm>
+#include <cstring>
+
+static u32 ReadLE(const u8* p, std::size_t size) {
+    u32 value = 0;
+    for (std::size_t i = size; i-- > 0;) {
+        value = value << 8 | p[i];
+    }
+    return value;
+}
+
+static void WriteLE(u8* p, std::size_t size, u32 value) {
+    for (std::size_t i = 0; i < size; ++i, value >>= 8) {
+        p[i] = static_cast<u8>(value);
+    }
+}
+
+/// FNV-1a over the create ID, then an xorshift-multiply so the low bits (the slot) depend on all of it.
+/// The last 6 bytes are the same for every Mii made on one console, so all 10 are hashed.
+static u32 HashCreateId(const u8* createId) {
+    u32 hash = 2166136261u;
+    for (std::size_t i = 0; i < sizeof(Ver3CreateId); ++i) {
+        hash = (hash ^ createId[i]) * 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x7FEB352Du;
+    hash ^= hash >> 15;
+    return hash;
+}
+
+/// FieldsInRange(), but allowing the file's custom colors.
+static bool FieldsInRange(const NxExtensionFields& fields, std::size_t colorCount) {
+    const std::size_t colorEnd = NxOverrideDbColor_Begin + colorCount;
+    return fields.facelineColor < FacelineColor_End && fields.hairColor < colorEnd &&
+           fields.eyeColor < colorEnd && fields.eyebrowColor < colorEnd &&
+           fields.mouthColor < colorEnd && fields.beardColor < colorEnd &&
+           fields.glassColor < colorEnd && fields.glassType < GlassType_End;
+}
+
+static bool CreateIdLess(const NxOverrideDbEntry& a, const NxOverrideDbEntry& b) {
+    return std::memcmp(a.createId, b.createId, sizeof(a.createId)) < 0;
+}
+
+// // ---------------------------------------------------------------
+// //  Loading
+// // ---------------------------------------------------------------
+
+NxOverrideDbResult NxOverrideDb::Load(std::vector<u8> file) {
+    Clear();
+
+    const NxOverrideDbHeader* header = reinterpret_cast<const NxOverrideDbHeader*>(file.data());
+    if (file.size() < sizeof(NxOverrideDbHeader) ||
+        std::memcmp(header->magic, NxOverrideDbMagic, sizeof(NxOverrideDbMagic)) != 0 ||
+        ReadLE(header->entrySize, sizeof(header->entrySize)) != sizeof(NxOverrideDbEntry)) {
+        return NxOverrideDb_BadHeader;
+    }
+    const u32 version = ReadLE(header->version, sizeof(header->version));
+    if (version == 0 || version > NxOverrideDbVersion) {
+        return NxOverrideDb_BadVersion;
+    }
+    const std::size_t count = ReadLE(header->count, sizeof(header->count));
+    // colorCount was reserved, and zero, in version 1.
+    const std::size_t colorCount = version >= 2 ? ReadLE(header->colorCount, sizeof(header->colorCount)) : 0;
+    if (colorCount > NxOverrideDbColor_Max) {
+        return NxOverrideDb_OutOfRange;
+    }
+    if ((file.size() - sizeof(NxOverrideDbHeader)) / sizeof(NxOverrideDbEntry) < count ||
+        file.size() - sizeof(NxOverrideDbHeader) - count * sizeof(NxOverrideDbEntry) < colorCount * sizeof(NxSrgb8)) {
+        return NxOverrideDb_Truncated;
+    }
+
+    const NxOverrideDbEntry* entries = reinterpret_cast<const NxOverrideDbEntry*>(file.data() + sizeof(NxOverrideDbHeader));
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!FieldsInRange(entries[i].fields, colorCount)) {
+            return NxOverrideDb_OutOfRange;
+        }
+        if (i != 0 && !CreateIdLess(entries[i - 1], entries[i])) {
+            return NxOverrideDb_Unsorted;
+        }
+    }
+
+    // Keep the table at most half full, so misses stop probing quickly.
+    std::size_t slotCount = 16;
+    while (slotCount < count * 2) {
+        slotCount *= 2;
+    }
+    mSlots.assign(slotCount, 0);
+    mSlotMask = static_cast<u32>(slotCount - 1);
+    for (std::size_t i = 0; i < count; ++i) {
+        u32 slot = HashCreateId(entries[i].createId) & mSlotMask;
+        while (mSlots[slot] != 0) {
+            slot = (slot + 1) & mSlotMask;
+        }
+        mSlots[slot] = static_cast<u32>(i + 1);
+    }
+
+    mFile = std::move(file);
+    mEntries = entries;
+    mCount = count;
+    mColors = reinterpret_cast<const NxSrgb8*>(mFile.data() + sizeof(NxOverrideDbHeader) + count * sizeof(NxOverrideDbEntry));
+    mColorCount = colorCount;
+    return NxOverrideDb_Success;
+}
+
+void NxOverrideDb::Clear() {
+    mFile.clear();
+    mEntries = nullptr;
+    mCount = 0;
+    mColors = nullptr;
+    mColorCount = 0;
+    mSlots.clear();
+    mSlotMask = 0;
+}
+
+const NxExtensionFields* NxOverrideDb::Find(const u8* createId) const {
+    if (mCount == 0) {
+        return nullptr;
+    }
+    for (u32 slot = HashCreateId(createId) & mSlotMask;; slot = (slot + 1) & mSlotMask) {
+        const u32 index = mSlots[slot];
+        if (index == 0) {
+            return nullptr;
+        }
+        const NxOverrideDbEntry& entry = mEntries[index - 1];
+        if (std::memcmp(entry.createId, createId, sizeof(entry.createId)) == 0) {
+            return &entry.fields;
+        }
+    }
+}
+
+// // ---------------------------------------------------------------
+// //  Building
+// // ---------------------------------------------------------------
+
+std::vector<u8> NxOverrideDb::Build(std::vector<NxOverrideDbEntry> entries,
+    const std::vector<NxSrgb8>& colors, std::size_t& duplicates) {
+    // Stable, so that of equal create IDs, the last one added ends up last.
+    std::stable_sort(entries.begin(), entries.end(), CreateIdLess);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (kept != 0 && !CreateIdLess(entries[kept - 1], entries[i])) {
+            entries[kept - 1] = entries[i];
+        } else {
+            entries[kept++] = entries[i];
+        }
+    }
+    duplicates = entries.size() - kept;
+
+    std::vector<u8> file(sizeof(NxOverrideDbHeader) + kept * sizeof(NxOverrideDbEntry) + colors.size() * sizeof(NxSrgb8));
+    NxOverrideDbHeader& header = *reinterpret_cast<NxOverrideDbHeader*>(file.data());
+    std::memcpy(header.magic, NxOverrideDbMagic, sizeof(NxOverrideDbMagic));
+    WriteLE(header.version, sizeof(header.version), NxOverrideDbVersion);
+    WriteLE(header.entrySize, sizeof(header.entrySize), sizeof(NxOverrideDbEntry));
+    WriteLE(header.count, sizeof(header.count), static_cast<u32>(kept));
+    WriteLE(header.colorCount, sizeof(header.colorCount), static_cast<u32>(colors.size()));
+    u8* p = file.data() + sizeof(NxOverrideDbHeader);
+    if (kept != 0) {
+        std::memcpy(p, entries.data(), kept * sizeof(NxOverrideDbEntry));
+        p += kept * sizeof(NxOverrideDbEntry);
+    }
+    if (!colors.empty()) {
+        std::memcpy(p, colors.data(), colors.size() * sizeof(NxSrgb8));
+    }
+    return file;
+}
@@ -0,0 +1,98 @@
+#pragma once
+/**
+ * @file NxOverrideDb.hpp
+ * @brief Database of Switch colors for Miis whose data can't be rewritten,
+ *        keyed by their Ver3 create ID.
+ *
+ * eFFSD needs the colors to be stored in the Mii data itself, which isn't
+ * possible for Miis on servers or in saves. This file format maps create IDs
+ * to NxExtensionFields instead, so a reader can apply them out of band.
+ *
+ * The file is a header, entries sorted by create ID, then any custom colors
+ * the entries use. It's read whole, and NxOverrideDb builds an open-addressed
+ * index over it on load, so each lookup is a hash and (usually) one compare,
+ * without allocating.
+ */
+
+#include "NxInVer3Pack.hpp"
+#include "NxCommonColors.hpp"
+#include <vector>
+
+// // ---------------------------------------------------------------
+// //  File Format
+// // ---------------------------------------------------------------
+
+/// "NXOV"
+static constexpr u8 NxOverrideDbMagic[4] = { 'N', 'X', 'O', 'V' };
+/// Version 2 added custom colors. Version 1 files are read as having none.
+static constexpr u16 NxOverrideDbVersion = 2;
+
+/// Color fields (other than facelineColor) at or above this refer to the
+/// file's custom colors, so up to NxOverrideDbColor_Max of them can be used.
+static constexpr int NxOverrideDbColor_Begin = CommonColor_End;
+static constexpr int NxOverrideDbColor_Max = 256 - CommonColor_End;
+
+/// File header. Integers are little-endian.
+struct NxOverrideDbHeader {
+    u8  magic[4];  ///< NxOverrideDbMagic
+    u8  version[2];
+    u8  entrySize[2]; ///< sizeof(NxOverrideDbEntry), so entries can be extended later.
+    u8  count[4];
+    u8  colorCount[4]; ///< Custom colors (NxSrgb8) after the entries.
+};
+static_assert(sizeof(NxOverrideDbHeader) == 16);
+
+/// One Mii. Entries are sorted by createId (as bytes), with no duplicates.
+struct NxOverrideDbEntry {
+    u8 createId[sizeof(Ver3CreateId)]; ///< As in the Mii data. These are bytes, so the same in either byte order.
+    NxExtensionFields fields;
+};
+static_assert(sizeof(NxOverrideDbEntry) == 18);
+
+enum NxOverrideDbResult {
+    NxOverrideDb_Success,
+    NxOverrideDb_BadHeader,    ///< Too small, wrong magic or entry size.
+    NxOverrideDb_BadVersion,
+    NxOverrideDb_Truncated,    ///< Fewer entries or colors than the header says.
+    NxOverrideDb_Unsorted,     ///< Entries out of order, or the same create ID twice.
+    NxOverrideDb_OutOfRange,   ///< An entry's fields are out of range, or too many colors.
+};
+
+// // ---------------------------------------------------------------
+// //  Loaded Database
+// // ---------------------------------------------------------------
+
+class NxOverrideDb {
+public:
+    /// Checks a database file and builds the index over it. Takes over `file`.
+    /// On failure, the database is left empty.
+    NxOverrideDbResult Load(std::vector<u8> file);
+    void Clear();
+
+    /// @param createId The 10 create ID bytes, at offset 0x0C of Ver3 Mii data.
+    /// @return The fields for this Mii, or nullptr if it has no entry.
+    const NxExtensionFields* Find(const u8* createId) const;
+
+    std::size_t Count() const { return mCount; }
+
+    /// Custom colors. Field value NxOverrideDbColor_Begin + i is Colors()[i].
+    const NxSrgb8* Colors() const { return mColors; }
+    std::size_t ColorCount() const { return mColorCount; }
+
+    /// Writes a database file. Entries are sorted, and for
+    /// duplicate create IDs, the one that comes last wins.
+    /// @param colors Custom colors used by the entries, at most NxOverrideDbColor_Max.
+    /// @param[out] duplicates Number of entries dropped as duplicates.
+    static std::vector<u8> Build(std::vector<NxOverrideDbEntry> entries,
+        const std::vector<NxSrgb8>& colors, std::size_t& duplicates);
+
+private:
+    std::vector<u8> mFile;
+    const NxOverrideDbEntry* mEntries = nullptr;
+    std::size_t mCount = 0;
+    const NxSrgb8* mColors = nullptr;
+    std::size_t mColorCount = 0;
+    /// Entry index + 1 for each slot, 0 if empty. Power-of-two sized, at most half full.
+    std::vector<u32> mSlots;
+    u32 mSlotMask = 0;
+};
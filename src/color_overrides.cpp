@@ -0,0 +1,67 @@
+#include "color_overrides.h"
+#include "ffl_colors.h"
+#include "utils/ReadFile.h"
+#include <cstddef>
+
+#ifdef __WIIU__
+#include "utils/logger.h"
+#endif
+
+static NxOverrideDb sColorOverrides;
+/// Common color index for each of the database's custom colors.
+static u8 sCustomColorIndices[NxOverrideDbColor_Max];
+
+/// Adds the database's custom colors to the pool. If it fills up, the rest use their nearest common color.
+static void addDatabaseColors() {
+    resetCustomColors();
+    for (size_t i = 0; i < sColorOverrides.ColorCount(); i++) {
+        const NxSrgb8 color = sColorOverrides.Colors()[i];
+        const int index = addCustomColor({ color.r, color.g, color.b });
+        sCustomColorIndices[i] = index >= 0
+            ? static_cast<u8>(index)
+            : FindNearestColor(color, NxColorPalette_Common);
+    }
+}
+
+void loadColorOverrides() {
+    sColorOverrides.Clear();
+
+    std::vector<u8> file;
+    if (!readWholeFile(COLOR_OVERRIDES_PATH, file)) {
+        addDatabaseColors();
+        return;
+    }
+
+    const NxOverrideDbResult result = sColorOverrides.Load(std::move(file));
+    addDatabaseColors();
+#ifdef __WIIU__
+    if (result == NxOverrideDb_Success) {
+        DEBUG_FUNCTION_LINE_INFO("Loaded %u color overrides, %u custom colors",
+            static_cast<unsigned>(sColorOverrides.Count()), static_cast<unsigned>(sColorOverrides.ColorCount()));
+    } else {
+        DEBUG_FUNCTION_LINE_ERR("Failed to load " COLOR_OVERRIDES_PATH ": %d", result);
+    }
+#else
+    (void)result;
+#endif
+}
+
+void unloadColorOverrides() {
+    sColorOverrides.Clear();
+    resetCustomColors();
+}
+
+bool findColorOverride(const void* core, NxExtensionFields& out) {
+    // The create ID is a byte string, so it's at the same place in either byte order.
+    const NxExtensionFields* fields = sColorOverrides.Find(static_cast<const u8*>(core) + offsetof(Ver3MiiDataCore, createId));
+    if (fields == nullptr) {
+        return false;
+    }
+    out = *fields;
+    for (u8* color : { &out.hairColor, &out.eyeColor, &out.eyebrowColor, &out.mouthColor, &out.beardColor, &out.glassColor }) {
+        if (*color >= NxOverrideDbColor_Begin) {
+            *color = sCustomColorIndices[*color - NxOverrideDbColor_Begin];
+        }
+    }
+    return true;
+}
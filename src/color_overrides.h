@@ -0,0 +1,18 @@
+#pragma once
+#include "../effsd/src/NxOverrideDb.hpp"
+
+/// Color override database on the SD card. See effsd/src/NxOverrideDb.hpp
+/// and the "overrides" command of the effsd CLI, which builds it.
+#define COLOR_OVERRIDES_PATH "fs:/vol/external01/wiiu/ffl_color_overrides.bin"
+
+/// (Re)loads the override database from COLOR_OVERRIDES_PATH. Having no file is fine.
+/// Its custom colors replace any in the pool (see addCustomColor() in ffl_colors.h).
+/// Not thread-safe: call this before the hooks are applied to a title.
+void loadColorOverrides();
+void unloadColorOverrides();
+
+/// Looks up the overridden colors for Ver3 Mii data, by its create ID.
+/// Custom colors are returned as their common color index in the pool.
+/// @param core Ver3MiiDataCore, in either byte order.
+/// @return False if the Mii has no entry, or no database is loaded.
+bool findColorOverride(const void* core, NxExtensionFields& out);
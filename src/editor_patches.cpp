@@ -7,10 +7,8 @@
 #include "ffl_types.h"
 #include "patches.h" // handles
 #include "ffl_colors.h" // FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK
-#if DEBUG
-#include <string>
 #include "utils/logger.h"
-#endif
+#include "utils/HookStats.h"
 
 /// Title IDs for Mii Maker / Miiスタジオ (Mii Studio).
 static constexpr std::array titleIdsMiiStudio = std::to_array<uint64_t>({
@@ -65,12 +63,14 @@ void my_FUN_02003b48(int param_1, int param_2) {
 */
 DECL_FUNCTION(int, FUN_020cdd1c, FFLiCharInfo* pInfo, uint32_t type);
 int my_FUN_020cdd1c(FFLiCharInfo* pInfo, uint32_t type) {
+    HOOK_STATS_SCOPE(FUN_020cdd1c);
     if (type == 0 && // select color for faceline
         pInfo->faceline.color > 5 // Ver3FacelineColor_Max
     ) {
         return INT_MAX; // all bits set
     }
     // otherwise, pass through
+    HOOK_STATS_FALLTHROUGH();
     return real_FUN_020cdd1c(pInfo, type);
 }
 
@@ -81,11 +81,8 @@ int my_FUN_020cdd1c(FFLiCharInfo* pInfo, uint32_t type) {
 /// If this is skipped, the buttons aren't selected.
 DECL_FUNCTION(void, FUN_020d02d8, void* param_1, int type, int index);
 void my_FUN_020d02d8(void* param_1, int type, int index) {
-#if DEBUG
-    const std::string message = "select type "+std::to_string(type)+", index "+std::to_string(index);
-    NotificationModule_AddInfoNotification(message.c_str());
-    DEBUG_FUNCTION_LINE_VERBOSE("%s", message.c_str());
-#endif
+    HOOK_STATS_SCOPE(FUN_020d02d8);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("select type %d, index %d", type, index);
     // is this using an out of bounds common color?
     // (or faceline color, set to INT_MAX)
     if ((index & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) != 0) {
@@ -96,6 +93,7 @@ void my_FUN_020d02d8(void* param_1, int type, int index) {
         return; // skip this function, do not mark any color as selected
     }
     // otherwise mark button as pressed, like usual
+    HOOK_STATS_FALLTHROUGH();
     real_FUN_020d02d8(param_1, type, index);
 }
 
@@ -141,6 +139,11 @@ void addPatchesMiiStudio() {
 
     for (function_replacement_data_t pReplacement
         : functionReplacementsForMiiStudio) {
+        if (gHandleIndex >= MAX_PATCHED_HANDLES) {
+            DEBUG_FUNCTION_LINE_ERR("No room for more patch handles (max %d), skipping %s",
+                MAX_PATCHED_HANDLES, pReplacement.ReplaceInRPX.executableName);
+            break;
+        }
         PatchedFunctionHandle handle;
         if (auto st = FunctionPatcher_AddFunctionPatch(&pReplacement, &handle, nullptr);
                     st == FUNCTION_PATCHER_RESULT_SUCCESS) {
@@ -0,0 +1,146 @@
+#include "ffl_colors.h"
+
+#include <cmath>
+
+// // ---------------------------------------------------------------
+// //  8-bit Tables
+// // ---------------------------------------------------------------
+// Only the sRGB colors are stored, the linear ones are derived in initNnMiiColorTables().
+
+// nn::mii::detail::FacelineColorTable and CommonColorTable are
+// NxFacelineColorsSrgb and NxCommonColorsSrgb in effsd's NxCommonColors.hpp,
+// which the CLI quantizes to as well.
+static_assert(NxFacelineColorsSrgb.size() == FFLI_NN_MII_FACELINE_COLOR_MAX);
+static_assert(NxCommonColorsSrgb.size() == FFLI_NN_MII_COMMON_COLOR_MAX);
+
+// nn::mii::detail::UpperLipColorTable
+// ColorElement[100], which is the same
+// as a CommonColorElement without last two ints
+// Switch Upper Lip (MouthGreen) Colors
+// Referenced by GetMouthGreenColor
+const NnMiiColor8 nnmiiUpperLipColors8[FFLI_NN_MII_COMMON_COLOR_MAX] = {
+    /*  0: */ {  23,  20,  20 }, {  32,  16,   8 }, {  46,  12,   5 }, {  74,  35,  12 },
+    /*  4: */ {  84,  84,  90 }, {  39,  31,   8 }, {  82,  53,  14 }, { 177, 128,  40 },
+    /*  8: */ {   0,   0,   0 }, {  76,  78,  78 }, {  51,  30,  22 }, {  58,  56,  29 },
+    /* 12: */ {  42,  50, 101 }, {  39,  78,  62 }, {  48,  28,   8 }, { 101,  10,   5 },
+    /* 16: */ {  16,  24,  52 }, { 118,  67,   0 }, {  84,  78,  73 }, { 130,  48,  24 },
+    /* 20: */ { 120,  12,  12 }, { 136,  32,  40 }, { 220, 120,  80 }, {  70,  30,  10 },
+    /* 24: */ {  79,  23,  23 }, { 153,  69,  61 }, { 230, 133, 133 }, { 230, 161, 155 },
+    /* 28: */ {  69,  28,  35 }, {  92,  19,  37 }, {  83,  14,  37 }, { 109,  37,  40 },
+    /* 32: */ { 119,  18,  52 }, { 106,  50,  77 }, { 119,  50,  66 }, { 175,  82, 106 },
+    /* 36: */ { 227, 140, 172 }, { 230, 171, 187 }, {  25,  14,  32 }, {  28,  20,  31 },
+    /* 40: */ {  38,  12,  39 }, {  67,  40, 107 }, {  80,  55, 110 }, { 134,  92, 143 },
+    /* 44: */ { 118, 103, 141 }, { 171, 144, 207 }, { 212, 160, 225 }, { 184, 170, 213 },
+    /* 48: */ {  13,  16,  32 }, {   9,  32,  51 }, {  29,  91, 148 }, {  50, 151, 218 },
+    /* 52: */ {  92, 173, 200 }, { 103, 134, 225 }, {  98, 159, 225 }, { 128, 199, 230 },
+    /* 56: */ {   6,  23,  27 }, {   1,  31,  30 }, {   7,  40,  45 }, {  24,  71,  69 },
+    /* 60: */ {  34,  88,  98 }, {  48, 139, 141 }, {  96, 176, 135 }, {  99, 191, 169 },
+    /* 64: */ { 105, 206, 155 }, {   5,  37,  27 }, {  40,  73,   0 }, {   1,  70,  59 },
+    /* 68: */ {  38, 107,  78 }, {  44, 138,   0 }, { 110, 153,   0 }, {  71, 179, 111 },
+    /* 72: */ { 130, 202,  31 }, { 122, 200,  96 }, { 158, 218, 140 }, { 107, 103,  30 },
+    /* 76: */ { 116, 104,  69 }, { 163, 152,  22 }, { 184, 163, 109 }, { 195, 181, 101 },
+    /* 80: */ { 191, 195,  81 }, { 189, 207, 100 }, { 188, 225, 125 }, {  75,  41,   0 },
+    /* 84: */ { 207, 161,  90 }, { 229, 198,  34 }, { 225, 195,  95 }, { 222, 208, 124 },
+    /* 88: */ { 225, 223, 122 }, { 100,  46,  18 }, { 204, 120,  10 }, { 188, 130,  76 },
+    /* 92: */ { 230, 146,  64 }, { 230, 164, 105 }, { 206, 182, 150 }, {  33,  33,  33 },
+    /* 96: */ { 124, 124, 124 }, { 171, 171, 171 }, { 198, 193, 182 }, { 217, 217, 217 }
+};
+
+// // ---------------------------------------------------------------
+// //  Float Tables
+// // ---------------------------------------------------------------
+
+// Aligned to Espresso's 32-byte cache lines.
+alignas(32) NnMiiColorTables gNnMiiColorTables;
+
+/// sRGB transfer function. nn::mii's linear colors match this to within float precision.
+static float srgbToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static void fillColorRow(FFLColor (&row)[FFLI_CONTAINER_TYPE_MAX], NnMiiColor8 color) {
+    // nn::mii passes these to its shaders with A = 0, but FFL wants 1.
+    const FFLColor srgb = {
+        static_cast<float>(color.r) / 255.0f,
+        static_cast<float>(color.g) / 255.0f,
+        static_cast<float>(color.b) / 255.0f,
+        1.0f
+    };
+    row[NN_MII_COLOR_GAMMA_SRGB] = srgb;
+    row[NN_MII_COLOR_GAMMA_LINEAR] = { srgbToLinear(srgb.r), srgbToLinear(srgb.g), srgbToLinear(srgb.b), 1.0f };
+}
+
+static void fillColorRows(FFLColor (*rows)[FFLI_CONTAINER_TYPE_MAX], const NnMiiColor8* colors, int count) {
+    for (int i = 0; i < count; i++) {
+        fillColorRow(rows[i], colors[i]);
+    }
+}
+
+void initNnMiiColorTables() {
+    fillColorRows(gNnMiiColorTables.faceline, NxFacelineColorsSrgb.data(), FFLI_NN_MII_FACELINE_COLOR_MAX);
+    fillColorRows(gNnMiiColorTables.common, NxCommonColorsSrgb.data(), FFLI_NN_MII_COMMON_COLOR_MAX);
+    fillColorRows(gNnMiiColorTables.upperLip, nnmiiUpperLipColors8, FFLI_NN_MII_COMMON_COLOR_MAX);
+    resetCustomColors();
+}
+
+// // ---------------------------------------------------------------
+// //  Custom Colors
+// // ---------------------------------------------------------------
+
+static NnMiiColor8 sCustomColors8[FFLI_NN_MII_CUSTOM_COLOR_MAX];
+/// Nearest nn::mii common color to each custom color, found when it's added.
+static uint8_t sCustomColorsNearest[FFLI_NN_MII_CUSTOM_COLOR_MAX];
+static int sCustomColorCount = 0;
+
+static bool isSameColor(NnMiiColor8 a, NnMiiColor8 b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+void resetCustomColors() {
+    sCustomColorCount = 0;
+    for (int i = 0; i < FFLI_NN_MII_CUSTOM_COLOR_MAX; i++) {
+        sCustomColors8[i] = NxCommonColorsSrgb[0];
+        sCustomColorsNearest[i] = 0;
+        fillColorRow(gNnMiiColorTables.common[FFLI_NN_MII_COMMON_COLOR_MAX + i], NxCommonColorsSrgb[0]);
+    }
+}
+
+int addCustomColor(NnMiiColor8 color) {
+    // Both searches are linear, but this is only called while loading.
+    for (int i = 0; i < FFLI_NN_MII_COMMON_COLOR_MAX; i++) {
+        if (isSameColor(NxCommonColorsSrgb[i], color)) {
+            return i;
+        }
+    }
+    for (int i = 0; i < sCustomColorCount; i++) {
+        if (isSameColor(sCustomColors8[i], color)) {
+            return FFLI_NN_MII_COMMON_COLOR_MAX + i;
+        }
+    }
+    if (sCustomColorCount == FFLI_NN_MII_CUSTOM_COLOR_MAX) {
+        return -1;
+    }
+    const int slot = sCustomColorCount++;
+    sCustomColors8[slot] = color;
+    sCustomColorsNearest[slot] = FindNearestColor(color, NxColorPalette_Common);
+    fillColorRow(gNnMiiColorTables.common[FFLI_NN_MII_COMMON_COLOR_MAX + slot], color);
+    return FFLI_NN_MII_COMMON_COLOR_MAX + slot;
+}
+
+NnMiiColor8 getCommonColor8(int colorIndex) {
+    if (colorIndex < 0 || colorIndex >= FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX) {
+        return NxCommonColorsSrgb[0];
+    }
+    return colorIndex < FFLI_NN_MII_COMMON_COLOR_MAX
+        ? NxCommonColorsSrgb[colorIndex]
+        : sCustomColors8[colorIndex - FFLI_NN_MII_COMMON_COLOR_MAX];
+}
+
+uint8_t getNearestCommonColor(int colorIndex) {
+    if (colorIndex < 0 || colorIndex >= FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX) {
+        return 0;
+    }
+    return colorIndex < FFLI_NN_MII_COMMON_COLOR_MAX
+        ? static_cast<uint8_t>(colorIndex)
+        : sCustomColorsNearest[colorIndex - FFLI_NN_MII_COMMON_COLOR_MAX];
+}
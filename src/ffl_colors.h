@@ -1,4 +1,6 @@
+#pragma once
 #include "ffl_types.h"
+#include "../effsd/src/NxCommonColors.hpp" // NxCommonColorsSrgb, NxFacelineColorsSrgb
 
 // https://github.com/ariankordi/ffl/blob/nsmbu-win-port-linux64/include/nn/ffl/FFLiColor.h
 // https://github.com/ariankordi/ffl/blob/nsmbu-win-port-linux64/src/FFLiColor.cpp
@@ -19,296 +21,79 @@
 
 #define FFLI_NN_MII_COMMON_COLOR_MAX 100
 #define FFLI_NN_MII_FACELINE_COLOR_MAX 10
+/// Custom colors take the common color indices after nn::mii's,
+/// up to 255 so that they still fit in the u8 fields of eFFSD.
+#define FFLI_NN_MII_CUSTOM_COLOR_MAX (256 - FFLI_NN_MII_COMMON_COLOR_MAX)
 
-/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/src/FFLiColor.cpp#L27
-enum FFLiContainerType
+// FFLiContainerType is in ffl_types.h.
+
+/// Columns of the nn::mii color tables below.
+/// Unlike FFL's containers, these store the linear color first, then sRGB.
+enum NnMiiColorGamma
 {
-    FFLI_CONTAINER_TYPE_NORMAL  = 0,
-    FFLI_CONTAINER_TYPE_SRGB    = 1,
-    FFLI_CONTAINER_TYPE_MAX     = 2
+    NN_MII_COLOR_GAMMA_LINEAR = 0,
+    NN_MII_COLOR_GAMMA_SRGB   = 1
 };
 
-// TODO:
-// TODO:
-// - is the container type even right? are they reversed?
-// - when we use ContainerType, do we have to swap linear and srgb table indices?
+/// Picks the nn::mii column matching the container type FFL was set up with.
+/// FFLI_CONTAINER_TYPE_SRGB is used by titles rendering in linear gamma
+/// (sRGB framebuffers), so those need the linear colors. See the note in
+/// ffl_patches.h for which titles do this.
+static constexpr NnMiiColorGamma getNnMiiColorGamma(FFLiContainerType type) {
+    return type == FFLI_CONTAINER_TYPE_SRGB
+        ? NN_MII_COLOR_GAMMA_LINEAR
+        : NN_MII_COLOR_GAMMA_SRGB;
+}
 
 
-// nn::mii::detail::FacelineColorTable
-// FacelineColorElement[10]
-// Switch Faceline Colors
+// // ---------------------------------------------------------------
+// //  nn::mii Color Tables
+// // ---------------------------------------------------------------
 
-// Note that this is placed after the
-// UpperLipColorTable in actual nn::mii but is
-// moved here for better handling of OOB values
-/*
-struct FacelineColorElement {
-    Color3   linear;
-    Color3   srgb;
-    uint32_t ver3Faceline;
-    uint32_t orderIndex;
-};
-*/
-/* Referenced by...
- * GetSkinColor
- * GetOrderIndexByFacelineColor
- * GetFacelineColorToVer3
- */
-const FFLColor nnmiiFacelineColors[FFLI_NN_MII_FACELINE_COLOR_MAX][FFLI_CONTAINER_TYPE_MAX] = {
-    // NOTE: these are passed to switch shaders with A = 0
-    { { 1.0f, 0.6514057f, 0.4178851f, 1.0f }, { 1.0f, 0.827451f, 0.6784314f, 1.0f } },
-    { { 1.0f, 0.4677839f, 0.1470273f, 1.0f }, { 1.0f, 0.7137255f, 0.4196079f, 1.0f } },
-    { { 0.7304609f, 0.1912018f, 0.05448031f, 1.0f }, { 0.8705883f, 0.4745099f, 0.2588236f, 1.0f } },
-    { { 1.0f, 0.4019778f, 0.2622508f, 1.0f }, { 1.0f, 0.6666667f, 0.5490197f, 1.0f } },
-    { { 0.4178851f, 0.08228273f, 0.0221739f, 1.0f }, { 0.6784314f, 0.3176471f, 0.1607844f, 1.0f } },
-    { { 0.1247718f, 0.02518688f, 0.00913407f, 1.0f }, { 0.3882353f, 0.1725491f, 0.0941177f, 1.0f } },
-    { { 1.0f, 0.5149179f, 0.3762622f, 1.0f }, { 1.0f, 0.7450981f, 0.6470589f, 1.0f } },
-    { { 1.0f, 0.5583405f, 0.2746774f, 1.0f }, { 1.0f, 0.7725491f, 0.5607844f, 1.0f } },
-    { { 0.2622508f, 0.04518623f, 0.0168074f, 1.0f }, { 0.5490197f, 0.2352942f, 0.137255f, 1.0f } },
-    { { 0.04518623f, 0.02624122f, 0.0168074f, 1.0f }, { 0.2352942f, 0.1764706f, 0.137255f, 1.0f } }
-};
+/// 8-bit sRGB color, as the nn::mii tables are defined.
+/// Every sRGB float in nn::mii is exactly one of these divided by 255.
+using NnMiiColor8 = NxSrgb8;
 
-// nn::mii::detail::CommonColorTable SRGB fields
-// Common colors as used in Switch Miis
-/*
-struct Color3 {
-    float r;
-    float g;
-    float b;
-};
-struct CommonColorElement {
-    Color3   linear;
-    Color3   srgb;
-    uint8_t  ver3Hair;
-    uint8_t  ver3Eye;
-    uint8_t  ver3Mouth;
-    uint8_t  ver3Glass;
-    uint32_t orderIndex;
-};
-struct CommonColorTable {
-    CommonColorElement colors[100];
+// The faceline and common colors are NxFacelineColorsSrgb and NxCommonColorsSrgb.
+extern const NnMiiColor8 nnmiiUpperLipColors8[FFLI_NN_MII_COMMON_COLOR_MAX];
+
+/// The tables above as FFL colors, in the same layout as nn::mii: each row
+/// is the linear color, then sRGB. Index the second dimension with NnMiiColorGamma.
+/// The common table continues with the custom colors, so that any
+/// common color index is a single lookup.
+struct NnMiiColorTables
+{
+    FFLColor faceline[FFLI_NN_MII_FACELINE_COLOR_MAX][FFLI_CONTAINER_TYPE_MAX];
+    FFLColor common[FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX][FFLI_CONTAINER_TYPE_MAX];
+    FFLColor upperLip[FFLI_NN_MII_COMMON_COLOR_MAX][FFLI_CONTAINER_TYPE_MAX];
 };
-*/
-/* Referenced by...
- * GetCommonColor
- * GetOrderIndexByCommonColor
- * GetHairColorToVer3
- * GetEyeColorToVer3
- * GetMouthColorToVer3
- * GetGlassColorToVer3
- * GetGlassColorToVer3
- */
 
-// NOTE: FFLiColorContainer contains the color in linear/normal gamma and THEN sRGB
-// NOTE NOTE IF YOU ARE READING: YOU WANT THE SECOND COLORS IN THESE ARRAYS
+/// Shared by all color hooks. Empty until initNnMiiColorTables() is called.
+extern NnMiiColorTables gNnMiiColorTables;
 
-const FFLColor nnmiiCommonColors[FFLI_NN_MII_COMMON_COLOR_MAX][FFLI_CONTAINER_TYPE_MAX] = {
-    { { 0.02624122f, 0.02121902f, 0.02121902f, 1.0f }, { 0.1764706f, 0.1568628f, 0.1568628f, 1.0f } },
-    { { 0.05126946f, 0.01444384f, 0.00518152f, 1.0f }, { 0.2509804f, 0.1254902f, 0.0627451f, 1.0f } },
-    { { 0.1070232f, 0.00913407f, 0.00303527f, 1.0f }, { 0.3607844f, 0.0941177f, 0.0392157f, 1.0f } },
-    { { 0.2015563f, 0.04231142f, 0.00699541f, 1.0f }, { 0.4862746f, 0.227451f, 0.0784314f, 1.0f } },
-    { { 0.1878208f, 0.1878208f, 0.2158605f, 1.0f }, { 0.4705883f, 0.4705883f, 0.5019608f, 1.0f } },
-    { { 0.07618541f, 0.04817184f, 0.00518152f, 1.0f }, { 0.3058824f, 0.2431373f, 0.0627451f, 1.0f } },
-    { { 0.2462014f, 0.09758739f, 0.00913407f, 1.0f }, { 0.5333334f, 0.3450981f, 0.0941177f, 1.0f } },
-    { { 0.6307572f, 0.3515327f, 0.06847817f, 1.0f }, { 0.8156863f, 0.627451f, 0.2901961f, 1.0f } },
-    { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } },
-    { { 0.1499599f, 0.1620294f, 0.1620294f, 1.0f }, { 0.4235295f, 0.4392157f, 0.4392157f, 1.0f } },
-    { { 0.1328683f, 0.04518623f, 0.02518688f, 1.0f }, { 0.4f, 0.2352942f, 0.1725491f, 1.0f } },
-    { { 0.1169707f, 0.1119325f, 0.02955684f, 1.0f }, { 0.3764706f, 0.3686275f, 0.1882353f, 1.0f } },
-    { { 0.0612461f, 0.08865561f, 0.3915726f, 1.0f }, { 0.2745099f, 0.3294118f, 0.6588236f, 1.0f } },
-    { { 0.03954626f, 0.1620294f, 0.09758739f, 1.0f }, { 0.2196079f, 0.4392157f, 0.3450981f, 1.0f } },
-    { { 0.1169707f, 0.03954626f, 0.00518152f, 1.0f }, { 0.3764706f, 0.2196079f, 0.0627451f, 1.0f } },
-    { { 0.3915726f, 0.00518152f, 0.00242822f, 1.0f }, { 0.6588236f, 0.0627451f, 0.0313726f, 1.0f } },
-    { { 0.01444384f, 0.02955684f, 0.1384317f, 1.0f }, { 0.1254902f, 0.1882353f, 0.4078432f, 1.0f } },
-    { { 0.3915726f, 0.1169707f, 0.0f, 1.0f }, { 0.6588236f, 0.3764706f, 0.0f, 1.0f } },
-    { { 0.1878208f, 0.1620294f, 0.1384317f, 1.0f }, { 0.4705883f, 0.4392157f, 0.4078432f, 1.0f } },
-    { { 0.6866855f, 0.08437625f, 0.00242822f, 1.0f }, { 0.8470589f, 0.3215687f, 0.0313726f, 1.0f } },
-    { { 0.8713672f, 0.00367651f, 0.00242822f, 1.0f }, { 0.9411765f, 0.0470589f, 0.0313726f, 1.0f } },
-    { { 0.9130989f, 0.0648033f, 0.0648033f, 1.0f }, { 0.9607844f, 0.282353f, 0.282353f, 1.0f } },
-    { { 0.8713672f, 0.3231433f, 0.1746474f, 1.0f }, { 0.9411765f, 0.6039216f, 0.454902f, 1.0f } },
-    { { 0.2622508f, 0.08021983f, 0.05126946f, 1.0f }, { 0.5490197f, 0.3137255f, 0.2509804f, 1.0f } },
-    { { 0.2307401f, 0.01938238f, 0.01938238f, 1.0f }, { 0.5176471f, 0.1490197f, 0.1490197f, 1.0f } },
-    { { 1.0f, 0.1714411f, 0.1328683f, 1.0f }, { 1.0f, 0.4509804f, 0.4f, 1.0f } },
-    { { 1.0f, 0.3813261f, 0.3813261f, 1.0f }, { 1.0f, 0.6509804f, 0.6509804f, 1.0f } },
-    { { 1.0f, 0.5271152f, 0.4910209f, 1.0f }, { 1.0f, 0.7529412f, 0.7294118f, 1.0f } },
-    { { 0.1714411f, 0.0273209f, 0.04373505f, 1.0f }, { 0.4509804f, 0.1803922f, 0.2313726f, 1.0f } },
-    { { 0.3185468f, 0.0137021f, 0.04666509f, 1.0f }, { 0.6f, 0.1215687f, 0.2392157f, 1.0f } },
-    { { 0.2541521f, 0.00856813f, 0.04817184f, 1.0f }, { 0.5411765f, 0.0901961f, 0.2431373f, 1.0f } },
-    { { 0.4620771f, 0.04817184f, 0.05448031f, 1.0f }, { 0.709804f, 0.2431373f, 0.2588236f, 1.0f } },
-    { { 0.571125f, 0.01298304f, 0.09305902f, 1.0f }, { 0.7803922f, 0.1176471f, 0.337255f, 1.0f } },
-    { { 0.4341537f, 0.08650047f, 0.2195262f, 1.0f }, { 0.6901961f, 0.3254902f, 0.5058824f, 1.0f } },
-    { { 0.571125f, 0.08865561f, 0.1559265f, 1.0f }, { 0.7803922f, 0.3294118f, 0.4313726f, 1.0f } },
-    { { 0.9559736f, 0.1778885f, 0.309469f, 1.0f }, { 0.9803922f, 0.4588236f, 0.5921569f, 1.0f } },
-    { { 0.9734454f, 0.4125428f, 0.5840785f, 1.0f }, { 0.9882353f, 0.6745099f, 0.7882353f, 1.0f } },
-    { { 1.0f, 0.5840785f, 0.6866855f, 1.0f }, { 1.0f, 0.7882353f, 0.8470589f, 1.0f } },
-    { { 0.03071345f, 0.01161226f, 0.05126946f, 1.0f }, { 0.1921569f, 0.109804f, 0.2509804f, 1.0f } },
-    { { 0.03820438f, 0.02121902f, 0.04666509f, 1.0f }, { 0.2156863f, 0.1568628f, 0.2392157f, 1.0f } },
-    { { 0.07227188f, 0.00913407f, 0.07421357f, 1.0f }, { 0.2980393f, 0.0941177f, 0.3019608f, 1.0f } },
-    { { 0.1589609f, 0.05448031f, 0.4507858f, 1.0f }, { 0.4352942f, 0.2588236f, 0.7019608f, 1.0f } },
-    { { 0.2345507f, 0.1070232f, 0.4793203f, 1.0f }, { 0.5215687f, 0.3607844f, 0.7215687f, 1.0f } },
-    { { 0.5271152f, 0.2269659f, 0.6038274f, 1.0f }, { 0.7529412f, 0.5137255f, 0.8f, 1.0f } },
-    { { 0.3915726f, 0.2917707f, 0.5840785f, 1.0f }, { 0.6588236f, 0.5764706f, 0.7882353f, 1.0f } },
-    { { 0.5583405f, 0.4125428f, 0.791298f, 1.0f }, { 0.7725491f, 0.6745099f, 0.9019608f, 1.0f } },
-    { { 0.8549928f, 0.5149179f, 0.9559736f, 1.0f }, { 0.9333334f, 0.7450981f, 0.9803922f, 1.0f } },
-    { { 0.6444799f, 0.5583405f, 0.8468735f, 1.0f }, { 0.8235295f, 0.7725491f, 0.9294118f, 1.0f } },
-    { { 0.00972123f, 0.0137021f, 0.05126946f, 1.0f }, { 0.0980393f, 0.1215687f, 0.2509804f, 1.0f } },
-    { { 0.00604884f, 0.0497066f, 0.1328683f, 1.0f }, { 0.0705883f, 0.2470589f, 0.4f, 1.0f } },
-    { { 0.02315337f, 0.2232281f, 0.658375f, 1.0f }, { 0.1647059f, 0.509804f, 0.8313726f, 1.0f } },
-    { { 0.09530749f, 0.4564111f, 0.8879234f, 1.0f }, { 0.3411765f, 0.7058824f, 0.9490197f, 1.0f } },
-    { { 0.1946179f, 0.5583405f, 0.7304609f, 1.0f }, { 0.4784314f, 0.7725491f, 0.8705883f, 1.0f } },
-    { { 0.2501584f, 0.3813261f, 0.9559736f, 1.0f }, { 0.537255f, 0.6509804f, 0.9803922f, 1.0f } },
-    { { 0.2307401f, 0.5088814f, 0.9559736f, 1.0f }, { 0.5176471f, 0.7411765f, 0.9803922f, 1.0f } },
-    { { 0.3564002f, 0.7681512f, 1.0f, 1.0f }, { 0.6313726f, 0.8901961f, 1.0f, 1.0f } },
-    { { 0.00334654f, 0.0273209f, 0.03688948f, 1.0f }, { 0.0431373f, 0.1803922f, 0.2117648f, 1.0f } },
-    { { 0.00030353f, 0.04666509f, 0.04373505f, 1.0f }, { 0.0039216f, 0.2392157f, 0.2313726f, 1.0f } },
-    { { 0.00402472f, 0.07818746f, 0.09989879f, 1.0f }, { 0.0509804f, 0.309804f, 0.3490197f, 1.0f } },
-    { { 0.0168074f, 0.1328683f, 0.1247718f, 1.0f }, { 0.137255f, 0.4f, 0.3882353f, 1.0f } },
-    { { 0.02955684f, 0.2086369f, 0.2622508f, 1.0f }, { 0.1882353f, 0.4941177f, 0.5490197f, 1.0f } },
-    { { 0.07818746f, 0.4232678f, 0.4341537f, 1.0f }, { 0.309804f, 0.682353f, 0.6901961f, 1.0f } },
-    { { 0.1946179f, 0.5520115f, 0.3419146f, 1.0f }, { 0.4784314f, 0.7686275f, 0.6196079f, 1.0f } },
-    { { 0.2122308f, 0.658375f, 0.5271152f, 1.0f }, { 0.4980393f, 0.8313726f, 0.7529412f, 1.0f } },
-    { { 0.2422812f, 0.783538f, 0.4677839f, 1.0f }, { 0.5294118f, 0.8980393f, 0.7137255f, 1.0f } },
-    { { 0.00303527f, 0.06847817f, 0.03560133f, 1.0f }, { 0.0392157f, 0.2901961f, 0.2078432f, 1.0f } },
-    { { 0.05612849f, 0.1946179f, 0.0f, 1.0f }, { 0.2627451f, 0.4784314f, 0.0f, 1.0f } },
-    { { 0.00060706f, 0.1778885f, 0.1221388f, 1.0f }, { 0.0078432f, 0.4588236f, 0.3843138f, 1.0f } },
-    { { 0.03688948f, 0.3185468f, 0.1620294f, 1.0f }, { 0.2117648f, 0.6f, 0.4392157f, 1.0f } },
-    { { 0.07036012f, 0.4178851f, 0.01032982f, 1.0f }, { 0.2941177f, 0.6784314f, 0.1019608f, 1.0f } },
-    { { 0.287441f, 0.5209957f, 0.00303527f, 1.0f }, { 0.5725491f, 0.7490197f, 0.0392157f, 1.0f } },
-    { { 0.1247718f, 0.571125f, 0.2462014f, 1.0f }, { 0.3882353f, 0.7803922f, 0.5333334f, 1.0f } },
-    { { 0.3419146f, 0.7454043f, 0.05448031f, 1.0f }, { 0.6196079f, 0.8784314f, 0.2588236f, 1.0f } },
-    { { 0.3049874f, 0.7304609f, 0.2086369f, 1.0f }, { 0.5882353f, 0.8705883f, 0.4941177f, 1.0f } },
-    { { 0.4969332f, 0.8879234f, 0.4019778f, 1.0f }, { 0.7333334f, 0.9490197f, 0.6666667f, 1.0f } },
-    { { 0.3185468f, 0.2917707f, 0.02415765f, 1.0f }, { 0.6f, 0.5764706f, 0.1686275f, 1.0f } },
-    { { 0.3813261f, 0.3005439f, 0.1247718f, 1.0f }, { 0.6509804f, 0.5843138f, 0.3882353f, 1.0f } },
-    { { 0.6038274f, 0.5271152f, 0.04091523f, 1.0f }, { 0.8f, 0.7529412f, 0.2235295f, 1.0f } },
-    { { 0.6038274f, 0.48515f, 0.2422812f, 1.0f }, { 0.8f, 0.7254902f, 0.5294118f, 1.0f } },
-    { { 0.6938719f, 0.6038274f, 0.2232281f, 1.0f }, { 0.8509804f, 0.8f, 0.509804f, 1.0f } },
-    { { 0.6653875f, 0.6938719f, 0.1589609f, 1.0f }, { 0.8352942f, 0.8509804f, 0.4352942f, 1.0f } },
-    { { 0.6653875f, 0.791298f, 0.2269659f, 1.0f }, { 0.8352942f, 0.9019608f, 0.5137255f, 1.0f } },
-    { { 0.6866855f, 0.9559736f, 0.3371637f, 1.0f }, { 0.8470589f, 0.9803922f, 0.6156863f, 1.0f } },
-    { { 0.2050788f, 0.05951127f, 0.0f, 1.0f }, { 0.4901961f, 0.2705883f, 0.0f, 1.0f } },
-    { { 0.791298f, 0.4969332f, 0.1946179f, 1.0f }, { 0.9019608f, 0.7333334f, 0.4784314f, 1.0f } },
-    { { 0.9911023f, 0.7605247f, 0.06847817f, 1.0f }, { 0.9960785f, 0.8862746f, 0.2901961f, 1.0f } },
-    { { 0.9559736f, 0.7304609f, 0.2232281f, 1.0f }, { 0.9803922f, 0.8705883f, 0.509804f, 1.0f } },
-    { { 0.9301111f, 0.822786f, 0.3324517f, 1.0f }, { 0.9686275f, 0.9176471f, 0.6117648f, 1.0f } },
-    { { 0.9559736f, 0.938686f, 0.3277782f, 1.0f }, { 0.9803922f, 0.9725491f, 0.6078432f, 1.0f } },
-    { { 0.3813261f, 0.07421357f, 0.01298304f, 1.0f }, { 0.6509804f, 0.3019608f, 0.1176471f, 1.0f } },
-    { { 1.0f, 0.3049874f, 0.00402472f, 1.0f }, { 1.0f, 0.5882353f, 0.0509804f, 1.0f } },
-    { { 0.6375971f, 0.3277782f, 0.1412634f, 1.0f }, { 0.8196079f, 0.6078432f, 0.4117648f, 1.0f } },
-    { { 1.0f, 0.4452013f, 0.1328683f, 1.0f }, { 1.0f, 0.6980393f, 0.4f, 1.0f } },
-    { { 1.0f, 0.5394797f, 0.2622508f, 1.0f }, { 1.0f, 0.7607844f, 0.5490197f, 1.0f } },
-    { { 0.783538f, 0.6239606f, 0.4396573f, 1.0f }, { 0.8980393f, 0.8117648f, 0.6941177f, 1.0f } },
-    { { 0.05286067f, 0.05286067f, 0.05286067f, 1.0f }, { 0.254902f, 0.254902f, 0.254902f, 1.0f } },
-    { { 0.3277782f, 0.3277782f, 0.3277782f, 1.0f }, { 0.6078432f, 0.6078432f, 0.6078432f, 1.0f } },
-    { { 0.5149179f, 0.5149179f, 0.5149179f, 1.0f }, { 0.7450981f, 0.7450981f, 0.7450981f, 1.0f } },
-    { { 0.7156936f, 0.6795427f, 0.6104956f, 1.0f }, { 0.8627451f, 0.8431373f, 0.8039216f, 1.0f } },
-    { { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } }
-};
+/// Fills gNnMiiColorTables from the 8-bit tables. Call once, before any hooks are applied.
+void initNnMiiColorTables();
 
-// nn::mii::detail::UpperLipColorTable
-// ColorElement[100], which is the same
-// as a CommonColorElement without last two ints
-// Switch Upper Lip (MouthGreen) Colors
-// Referenced by GetMouthGreenColor
-const FFLColor nnmiiUpperLipColors[FFLI_NN_MII_COMMON_COLOR_MAX][FFLI_CONTAINER_TYPE_MAX] = {
-    { { 0.00856813f, 0.00699541f, 0.00699541f, 1.0f }, { 0.0901961f, 0.0784314f, 0.0784314f, 1.0f } },
-    { { 0.01444384f, 0.00518152f, 0.00242822f, 1.0f }, { 0.1254902f, 0.0627451f, 0.0313726f, 1.0f } },
-    { { 0.0273209f, 0.00367651f, 0.00151764f, 1.0f }, { 0.1803922f, 0.0470589f, 0.0196079f, 1.0f } },
-    { { 0.06847817f, 0.0168074f, 0.00367651f, 1.0f }, { 0.2901961f, 0.137255f, 0.0470589f, 1.0f } },
-    { { 0.08865561f, 0.08865561f, 0.1022417f, 1.0f }, { 0.3294118f, 0.3294118f, 0.3529412f, 1.0f } },
-    { { 0.02028857f, 0.0137021f, 0.00242822f, 1.0f }, { 0.1529412f, 0.1215687f, 0.0313726f, 1.0f } },
-    { { 0.08437625f, 0.03560133f, 0.00439145f, 1.0f }, { 0.3215687f, 0.2078432f, 0.054902f, 1.0f } },
-    { { 0.4396573f, 0.2158605f, 0.02121902f, 1.0f }, { 0.6941177f, 0.5019608f, 0.1568628f, 1.0f } },
-    { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } },
-    { { 0.07227188f, 0.07618541f, 0.07618541f, 1.0f }, { 0.2980393f, 0.3058824f, 0.3058824f, 1.0f } },
-    { { 0.03310477f, 0.01298304f, 0.00802321f, 1.0f }, { 0.2f, 0.1176471f, 0.0862746f, 1.0f } },
-    { { 0.04231142f, 0.03954626f, 0.01228649f, 1.0f }, { 0.227451f, 0.2196079f, 0.1137255f, 1.0f } },
-    { { 0.02315337f, 0.03189605f, 0.1301365f, 1.0f }, { 0.1647059f, 0.1960785f, 0.3960785f, 1.0f } },
-    { { 0.02028857f, 0.07618541f, 0.04817184f, 1.0f }, { 0.1529412f, 0.3058824f, 0.2431373f, 1.0f } },
-    { { 0.02955684f, 0.01161226f, 0.00242822f, 1.0f }, { 0.1882353f, 0.109804f, 0.0313726f, 1.0f } },
-    { { 0.1301365f, 0.00303527f, 0.00151764f, 1.0f }, { 0.3960785f, 0.0392157f, 0.0196079f, 1.0f } },
-    { { 0.00518152f, 0.00913407f, 0.03433982f, 1.0f }, { 0.0627451f, 0.0941177f, 0.2039216f, 1.0f } },
-    { { 0.1811642f, 0.05612849f, 0.0f, 1.0f }, { 0.4627451f, 0.2627451f, 0.0f, 1.0f } },
-    { { 0.08865561f, 0.07618541f, 0.06662599f, 1.0f }, { 0.3294118f, 0.3058824f, 0.2862746f, 1.0f } },
-    { { 0.2232281f, 0.02955684f, 0.00913407f, 1.0f }, { 0.509804f, 0.1882353f, 0.0941177f, 1.0f } },
-    { { 0.1878208f, 0.00367651f, 0.00367651f, 1.0f }, { 0.4705883f, 0.0470589f, 0.0470589f, 1.0f } },
-    { { 0.2462014f, 0.01444384f, 0.02121902f, 1.0f }, { 0.5333334f, 0.1254902f, 0.1568628f, 1.0f } },
-    { { 0.7156936f, 0.1878208f, 0.08021983f, 1.0f }, { 0.8627451f, 0.4705883f, 0.3137255f, 1.0f } },
-    { { 0.0612461f, 0.01298304f, 0.00303527f, 1.0f }, { 0.2745099f, 0.1176471f, 0.0392157f, 1.0f } },
-    { { 0.07818746f, 0.00856813f, 0.00856813f, 1.0f }, { 0.309804f, 0.0901961f, 0.0901961f, 1.0f } },
-    { { 0.3185468f, 0.05951127f, 0.04666509f, 1.0f }, { 0.6f, 0.2705883f, 0.2392157f, 1.0f } },
-    { { 0.791298f, 0.2345507f, 0.2345507f, 1.0f }, { 0.9019608f, 0.5215687f, 0.5215687f, 1.0f } },
-    { { 0.791298f, 0.3564002f, 0.3277782f, 1.0f }, { 0.9019608f, 0.6313726f, 0.6078432f, 1.0f } },
-    { { 0.05951127f, 0.01161226f, 0.0168074f, 1.0f }, { 0.2705883f, 0.109804f, 0.137255f, 1.0f } },
-    { { 0.1070232f, 0.0065121f, 0.01850023f, 1.0f }, { 0.3607844f, 0.0745099f, 0.1450981f, 1.0f } },
-    { { 0.08650047f, 0.00439145f, 0.01850023f, 1.0f }, { 0.3254902f, 0.054902f, 0.1450981f, 1.0f } },
-    { { 0.1529262f, 0.01850023f, 0.02121902f, 1.0f }, { 0.427451f, 0.1450981f, 0.1568628f, 1.0f } },
-    { { 0.184475f, 0.00604884f, 0.03433982f, 1.0f }, { 0.4666667f, 0.0705883f, 0.2039216f, 1.0f } },
-    { { 0.1441285f, 0.03189605f, 0.07421357f, 1.0f }, { 0.4156863f, 0.1960785f, 0.3019608f, 1.0f } },
-    { { 0.184475f, 0.03189605f, 0.05448031f, 1.0f }, { 0.4666667f, 0.1960785f, 0.2588236f, 1.0f } },
-    { { 0.4286906f, 0.08437625f, 0.1441285f, 1.0f }, { 0.6862746f, 0.3215687f, 0.4156863f, 1.0f } },
-    { { 0.7681512f, 0.2622508f, 0.4125428f, 1.0f }, { 0.8901961f, 0.5490197f, 0.6745099f, 1.0f } },
-    { { 0.791298f, 0.4072404f, 0.4969332f, 1.0f }, { 0.9019608f, 0.6705883f, 0.7333334f, 1.0f } },
-    { { 0.00972123f, 0.00439145f, 0.01444384f, 1.0f }, { 0.0980393f, 0.054902f, 0.1254902f, 1.0f } },
-    { { 0.01161226f, 0.00699541f, 0.0137021f, 1.0f }, { 0.109804f, 0.0784314f, 0.1215687f, 1.0f } },
-    { { 0.01938238f, 0.00367651f, 0.02028857f, 1.0f }, { 0.1490197f, 0.0470589f, 0.1529412f, 1.0f } },
-    { { 0.05612849f, 0.02121902f, 0.1470273f, 1.0f }, { 0.2627451f, 0.1568628f, 0.4196079f, 1.0f } },
-    { { 0.08021983f, 0.03820438f, 0.1559265f, 1.0f }, { 0.3137255f, 0.2156863f, 0.4313726f, 1.0f } },
-    { { 0.2383976f, 0.1070232f, 0.2746774f, 1.0f }, { 0.5254902f, 0.3607844f, 0.5607844f, 1.0f } },
-    { { 0.1811642f, 0.1356334f, 0.2663557f, 1.0f }, { 0.4627451f, 0.4039216f, 0.5529412f, 1.0f } },
-    { { 0.4072404f, 0.2788943f, 0.6239606f, 1.0f }, { 0.6705883f, 0.5647059f, 0.8117648f, 1.0f } },
-    { { 0.658375f, 0.3515327f, 0.7529424f, 1.0f }, { 0.8313726f, 0.627451f, 0.882353f, 1.0f } },
-    { { 0.4793203f, 0.4019778f, 0.6653875f, 1.0f }, { 0.7215687f, 0.6666667f, 0.8352942f, 1.0f } },
-    { { 0.00402472f, 0.00518152f, 0.01444384f, 1.0f }, { 0.0509804f, 0.0627451f, 0.1254902f, 1.0f } },
-    { { 0.00273175f, 0.01444384f, 0.03310477f, 1.0f }, { 0.0352942f, 0.1254902f, 0.2f, 1.0f } },
-    { { 0.01228649f, 0.1046165f, 0.2961383f, 1.0f }, { 0.1137255f, 0.3568628f, 0.5803922f, 1.0f } },
-    { { 0.03189605f, 0.309469f, 0.7011021f, 1.0f }, { 0.1960785f, 0.5921569f, 0.854902f, 1.0f } },
-    { { 0.1070232f, 0.4178851f, 0.5775806f, 1.0f }, { 0.3607844f, 0.6784314f, 0.7843138f, 1.0f } },
-    { { 0.1356334f, 0.2383976f, 0.7529424f, 1.0f }, { 0.4039216f, 0.5254902f, 0.882353f, 1.0f } },
-    { { 0.1221388f, 0.3467042f, 0.7529424f, 1.0f }, { 0.3843138f, 0.6235295f, 0.882353f, 1.0f } },
-    { { 0.2158605f, 0.571125f, 0.791298f, 1.0f }, { 0.5019608f, 0.7803922f, 0.9019608f, 1.0f } },
-    { { 0.00182117f, 0.00856813f, 0.0109601f, 1.0f }, { 0.0235295f, 0.0901961f, 0.1058824f, 1.0f } },
-    { { 0.00030353f, 0.0137021f, 0.01298304f, 1.0f }, { 0.0039216f, 0.1215687f, 0.1176471f, 1.0f } },
-    { { 0.00212469f, 0.02121902f, 0.02624122f, 1.0f }, { 0.027451f, 0.1568628f, 0.1764706f, 1.0f } },
-    { { 0.00913407f, 0.06301002f, 0.05951127f, 1.0f }, { 0.0941177f, 0.2784314f, 0.2705883f, 1.0f } },
-    { { 0.01599631f, 0.09758739f, 0.1221388f, 1.0f }, { 0.1333334f, 0.3450981f, 0.3843138f, 1.0f } },
-    { { 0.02955684f, 0.258183f, 0.2663557f, 1.0f }, { 0.1882353f, 0.5450981f, 0.5529412f, 1.0f } },
-    { { 0.1169707f, 0.4341537f, 0.2422812f, 1.0f }, { 0.3764706f, 0.6901961f, 0.5294118f, 1.0f } },
-    { { 0.1247718f, 0.5209957f, 0.3967553f, 1.0f }, { 0.3882353f, 0.7490197f, 0.6627451f, 1.0f } },
-    { { 0.1412634f, 0.6172068f, 0.3277782f, 1.0f }, { 0.4117648f, 0.8078432f, 0.6078432f, 1.0f } },
-    { { 0.00151764f, 0.01850023f, 0.0109601f, 1.0f }, { 0.0196079f, 0.1450981f, 0.1058824f, 1.0f } },
-    { { 0.02121902f, 0.06662599f, 0.0f, 1.0f }, { 0.1568628f, 0.2862746f, 0.0f, 1.0f } },
-    { { 0.00030353f, 0.0612461f, 0.04373505f, 1.0f }, { 0.0039216f, 0.2745099f, 0.2313726f, 1.0f } },
-    { { 0.01938238f, 0.1470273f, 0.07618541f, 1.0f }, { 0.1490197f, 0.4196079f, 0.3058824f, 1.0f } },
-    { { 0.02518688f, 0.2541521f, 0.0f, 1.0f }, { 0.1725491f, 0.5411765f, 0.0f, 1.0f } },
-    { { 0.1559265f, 0.3185468f, 0.0f, 1.0f }, { 0.4313726f, 0.6f, 0.0f, 1.0f } },
-    { { 0.06301002f, 0.4507858f, 0.1589609f, 1.0f }, { 0.2784314f, 0.7019608f, 0.4352942f, 1.0f } },
-    { { 0.2232281f, 0.5906189f, 0.0137021f, 1.0f }, { 0.509804f, 0.7921569f, 0.1215687f, 1.0f } },
-    { { 0.1946179f, 0.5775806f, 0.1169707f, 1.0f }, { 0.4784314f, 0.7843138f, 0.3764706f, 1.0f } },
-    { { 0.3419146f, 0.7011021f, 0.2622508f, 1.0f }, { 0.6196079f, 0.854902f, 0.5490197f, 1.0f } },
-    { { 0.1470273f, 0.1356334f, 0.01298304f, 1.0f }, { 0.4196079f, 0.4039216f, 0.1176471f, 1.0f } },
-    { { 0.1746474f, 0.1384317f, 0.05951127f, 1.0f }, { 0.454902f, 0.4078432f, 0.2705883f, 1.0f } },
-    { { 0.3662527f, 0.3139888f, 0.00802321f, 1.0f }, { 0.6392157f, 0.5960785f, 0.0862746f, 1.0f } },
-    { { 0.4793203f, 0.3662527f, 0.1529262f, 1.0f }, { 0.7215687f, 0.6392157f, 0.427451f, 1.0f } },
-    { { 0.5457245f, 0.4620771f, 0.1301365f, 1.0f }, { 0.7647059f, 0.709804f, 0.3960785f, 1.0f } },
-    { { 0.5209957f, 0.5457245f, 0.08228273f, 1.0f }, { 0.7490197f, 0.7647059f, 0.3176471f, 1.0f } },
-    { { 0.5088814f, 0.6239606f, 0.1274377f, 1.0f }, { 0.7411765f, 0.8117648f, 0.3921569f, 1.0f } },
-    { { 0.5028866f, 0.7529424f, 0.2050788f, 1.0f }, { 0.737255f, 0.882353f, 0.4901961f, 1.0f } },
-    { { 0.07036012f, 0.0221739f, 0.0f, 1.0f }, { 0.2941177f, 0.1607844f, 0.0f, 1.0f } },
-    { { 0.6239606f, 0.3564002f, 0.1022417f, 1.0f }, { 0.8117648f, 0.6313726f, 0.3529412f, 1.0f } },
-    { { 0.783538f, 0.5647116f, 0.01599631f, 1.0f }, { 0.8980393f, 0.7764706f, 0.1333334f, 1.0f } },
-    { { 0.7529424f, 0.5457245f, 0.1144354f, 1.0f }, { 0.882353f, 0.7647059f, 0.3725491f, 1.0f } },
-    { { 0.7304609f, 0.6307572f, 0.2015563f, 1.0f }, { 0.8705883f, 0.8156863f, 0.4862746f, 1.0f } },
-    { { 0.7529424f, 0.7379106f, 0.1946179f, 1.0f }, { 0.882353f, 0.8745099f, 0.4784314f, 1.0f } },
-    { { 0.1274377f, 0.0273209f, 0.00604884f, 1.0f }, { 0.3921569f, 0.1803922f, 0.0705883f, 1.0f } },
-    { { 0.6038274f, 0.1878208f, 0.00303527f, 1.0f }, { 0.8f, 0.4705883f, 0.0392157f, 1.0f } },
-    { { 0.5028866f, 0.2232281f, 0.07227188f, 1.0f }, { 0.737255f, 0.509804f, 0.2980393f, 1.0f } },
-    { { 0.791298f, 0.287441f, 0.05126946f, 1.0f }, { 0.9019608f, 0.5725491f, 0.2509804f, 1.0f } },
-    { { 0.791298f, 0.3712377f, 0.1412634f, 1.0f }, { 0.9019608f, 0.6431373f, 0.4117648f, 1.0f } },
-    { { 0.6172068f, 0.4677839f, 0.3049874f, 1.0f }, { 0.8078432f, 0.7137255f, 0.5882353f, 1.0f } },
-    { { 0.01520852f, 0.01520852f, 0.01520852f, 1.0f }, { 0.1294118f, 0.1294118f, 0.1294118f, 1.0f } },
-    { { 0.2015563f, 0.2015563f, 0.2015563f, 1.0f }, { 0.4862746f, 0.4862746f, 0.4862746f, 1.0f } },
-    { { 0.4072404f, 0.4072404f, 0.4072404f, 1.0f }, { 0.6705883f, 0.6705883f, 0.6705883f, 1.0f } },
-    { { 0.5647116f, 0.5332766f, 0.4677839f, 1.0f }, { 0.7764706f, 0.7568628f, 0.7137255f, 1.0f } },
-    { { 0.6938719f, 0.6938719f, 0.6938719f, 1.0f }, { 0.8509804f, 0.8509804f, 0.8509804f, 1.0f } }
-};
+// // ---------------------------------------------------------------
+// //  Custom Colors
+// // ---------------------------------------------------------------
+// Colors other than nn::mii's are added to the end of gNnMiiColorTables.common.
+// Rows are never moved or changed while in use, since FFL keeps pointers to them
+// (for example in FFLModulateParam). None of these are thread-safe: only
+// call them while no hooks are running, like before a title starts.
+
+/// Removes all custom colors. Their rows are set to common color 0.
+void resetCustomColors();
+
+/// Adds a custom color. Colors that were already added, or that are
+/// nn::mii common colors, aren't added again.
+/// @return Its common color index, or -1 if the pool is full.
+int addCustomColor(NnMiiColor8 color);
+
+/// 8-bit sRGB color for a common color index, including custom colors.
+/// Indices past the custom colors give common color 0.
+NnMiiColor8 getCommonColor8(int colorIndex);
+
+/// The nn::mii common color for a common color index: itself, or for a custom
+/// color, the nearest one as found by addCustomColor(). Out of range gives 0.
+uint8_t getNearestCommonColor(int colorIndex);
@@ -1,7 +1,7 @@
 #include "ffl_patches.h"
+#include <cstring>
 
 #ifdef __WIIU__
-#include "notifications/notifications.h"
 #include "utils/logger.h"
     #ifdef DEBUG
     #include <cstdio>
@@ -9,10 +9,18 @@
 #endif
 
 #include "ffl_types.h"
-//#include "utils/base64enc.h"
+#include "ffl_verify.h"
+#include "utils/base64enc.h"
 #ifdef __WIIU__
 #include "../effsd/src/NxInVer3Pack.hpp"
+#include "../effsd/src/NxCommonColors.hpp"
+#include "color_overrides.h"
 #endif
+#include "utils/ContentHash.h"
+#include "utils/HashedResultCache.h"
+#include "utils/HookStats.h"
+#include "utils/HookTrace.h"
+#include <atomic>
 
 /// Red constant color for testing.
 static constexpr FFLColor cColorRed       { 1.0f, 0.0f, 0.0f, 1.0f };
@@ -25,122 +33,246 @@ static constexpr FFLColor cColorEyeShadow { 0.0f, 1.0f, 1.0f, 1.0f };
 
 #include "ffl_colors.h"
 
+// // ---------------------------------------------------------------
+// //  Color Gamma Binding
+// // ---------------------------------------------------------------
+
+/// Executables known to set up FFL with FFLI_CONTAINER_TYPE_SRGB (linear gamma).
+/// Everything else is assumed to use FFLI_CONTAINER_TYPE_NORMAL.
+/// @note This is a list, not detection: a linear title missing from it gets
+/// the sRGB colors. FFL's own s_ContainerType is only set once the title calls
+/// FFLInitRes, after patching, and its signature in ffl_patches.h hasn't been
+/// checked against real executables yet. Add titles here until it has.
+static constexpr std::array cLinearGammaExecutables = std::to_array<const char*>({
+    "men.rpx",   // Wii U Menu
+    "frd.rpx",   // Friend List (applet)
+    "inf.rpx",   // Notifications (applet)
+    "Turbo.rpx", // Mario Kart 8
+});
+
+/// Row stride of the nn::mii tables, which interleave linear and sRGB.
+static constexpr int cColorTableStride = FFLI_CONTAINER_TYPE_MAX;
+
+/// First element of the gNnMiiColorTables.common column used for the current title.
+/// Step through it with cColorTableStride. Defaults to sRGB like most titles.
+static const FFLColor* sCommonColorColumn = &gNnMiiColorTables.common[0][NN_MII_COLOR_GAMMA_SRGB];
+
+FFLiContainerType getContainerTypeForModule(const char* moduleName) {
+    if (moduleName == nullptr) {
+        return FFLI_CONTAINER_TYPE_NORMAL;
+    }
+    // Compare the file name only, since this may be a full path.
+    const char* baseName = strrchr(moduleName, '/');
+    baseName = (baseName != nullptr) ? baseName + 1 : moduleName;
+
+    for (const char* linearName : cLinearGammaExecutables) {
+        if (strcmp(baseName, linearName) == 0) {
+            return FFLI_CONTAINER_TYPE_SRGB;
+        }
+    }
+    return FFLI_CONTAINER_TYPE_NORMAL;
+}
+
+void bindColorHooksToContainerType(FFLiContainerType type) {
+    sCommonColorColumn = &gNnMiiColorTables.common[0][getNnMiiColorGamma(type)];
+}
+
+/// Looks up a common color in the column bound for this title.
+static inline const FFLColor* getBoundCommonColor(int colorIndex) {
+    const int i = colorIndex & FFLI_NN_MII_COMMON_COLOR_MASK;
+    return &sCommonColorColumn[i * cColorTableStride];
+}
+
 DECL_FUNCTION(const void*, FFLiGetHairColor, int colorIndex);
 // real_ pointer will be written by FunctionPatcher.
 const void* my_FFLiGetHairColor(int colorIndex) {
+    HOOK_STATS_SCOPE(FFLiGetHairColor);
+    HOOK_TRACE_CALL(FFLiGetHairColor, colorIndex);
     if ((colorIndex & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) == 0) {
+        HOOK_STATS_FALLTHROUGH();
         return real_FFLiGetHairColor(colorIndex);
     }
     // return reinterpret_cast<const void*>(&cColorRed);
 
-    const int i = colorIndex & FFLI_NN_MII_COMMON_COLOR_MASK;
-    return reinterpret_cast<const void*>(&nnmiiCommonColors[i][1]);
+    return reinterpret_cast<const void*>(getBoundCommonColor(colorIndex));
 }
 
 DECL_FUNCTION(const void*, FFLiGetGlassColor, int colorIndex);
 const void* my_FFLiGetGlassColor(int colorIndex) {
+    HOOK_STATS_SCOPE(FFLiGetGlassColor);
+    HOOK_TRACE_CALL(FFLiGetGlassColor, colorIndex);
     if ((colorIndex & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) == 0) {
+        HOOK_STATS_FALLTHROUGH();
         return real_FFLiGetGlassColor(colorIndex);
     }
+    return reinterpret_cast<const void*>(getBoundCommonColor(colorIndex));
+}
+
+DECL_FUNCTION(const void*, FFLiGetSrgbFetchEyebrowColor, int colorIndex);
+// SrgbFetch variants always need sRGB, regardless of the container type.
+const void* my_FFLiGetSrgbFetchEyebrowColor(int colorIndex) {
+    HOOK_STATS_SCOPE(FFLiGetSrgbFetchEyebrowColor);
+    HOOK_TRACE_CALL(FFLiGetSrgbFetchEyebrowColor, colorIndex);
+    if ((colorIndex & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) == 0) {
+        HOOK_STATS_FALLTHROUGH();
+        return real_FFLiGetSrgbFetchEyebrowColor(colorIndex);
+    }
     const int i = colorIndex & FFLI_NN_MII_COMMON_COLOR_MASK;
-    return reinterpret_cast<const void*>(&nnmiiCommonColors[i][1]);
+    return reinterpret_cast<const void*>(&gNnMiiColorTables.common[i][NN_MII_COLOR_GAMMA_SRGB]);
 }
 
 DECL_FUNCTION(const void*, FFLiGetFacelineColor, int colorIndex);
 const void* my_FFLiGetFacelineColor(int colorIndex) {
+    HOOK_STATS_SCOPE(FFLiGetFacelineColor);
+    HOOK_TRACE_CALL(FFLiGetFacelineColor, colorIndex);
     // Get sRGB color for now.
-    return reinterpret_cast<const void*>(&nnmiiFacelineColors[colorIndex][1]);
+    return reinterpret_cast<const void*>(&gNnMiiColorTables.faceline[colorIndex][NN_MII_COLOR_GAMMA_SRGB]);
     // return real_FFLiGetHairColor(colorIndex);
 }
 
-DECL_FUNCTION(int, FFLiVerifyCharInfoWithReason, void* pInfo, int nameCheck);
-int my_FFLiVerifyCharInfoWithReason(void* pInfo, int nameCheck) {
+/// Verify results of recently seen CharInfos, keyed by a hash of the CharInfo and nameCheck.
+/// Titles verify the same Mii on load, before creating a model, and when re-encoding.
+static HashedResultCache<256> sVerifyMemo;
+static std::atomic<uint32_t> sVerifyMemoHits{0};
+static std::atomic<uint32_t> sVerifyMemoMisses{0};
+
+/// Mixed into the key when nameCheck is set, so both results can be cached.
+static constexpr uint64_t cVerifyNameCheckSalt = 0x9E3779B97F4A7C15ull;
+
+VerifyMemoStats getVerifyMemoStats() {
+    return {
+        sVerifyMemoHits.load(std::memory_order_relaxed),
+        sVerifyMemoMisses.load(std::memory_order_relaxed)
+    };
+}
 
-    FFLiCharInfo prevInfo;
-    memcpy(&prevInfo, pInfo, sizeof(FFLiCharInfo));
+void resetVerifyMemoStats() {
+    sVerifyMemoHits.store(0, std::memory_order_relaxed);
+    sVerifyMemoMisses.store(0, std::memory_order_relaxed);
+}
 
-    FFLiCharInfo& info = *reinterpret_cast<FFLiCharInfo*>(pInfo);
-    // use placeholder colors to spoof verification process
-    info.faceline.color = 0; // white
-    info.hair.color = 4; // gray
-    info.eye.color = 1; // gray
-    info.eyebrow.color = 4; // gray
-    info.mouth.color = 0;
-    info.beard.color = 1; // gray
-    info.glass.color = 5; // dark gray
+DECL_FUNCTION(int, FFLiVerifyCharInfoWithReason, void* pInfo, int nameCheck);
+int my_FFLiVerifyCharInfoWithReason(void* pInfo, int nameCheck) {
+    HOOK_STATS_SCOPE(FFLiVerifyCharInfoWithReason);
+    HOOK_TRACE_CALL_WITH(FFLiVerifyCharInfoWithReason,
+        pInfo, pInfo != nullptr ? sizeof(FFLiCharInfo) : 0, nameCheck);
+    if (pInfo == nullptr) {
+        HOOK_STATS_FALLTHROUGH();
+        return real_FFLiVerifyCharInfoWithReason(pInfo, nameCheck);
+    }
+    const FFLiCharInfo& info = *static_cast<const FFLiCharInfo*>(pInfo);
 
-    int result = real_FFLiVerifyCharInfoWithReason(pInfo, nameCheck);
+    uint64_t key = ContentHash::hashWords(&info, sizeof(FFLiCharInfo));
+    if (nameCheck != 0) {
+        key ^= cVerifyNameCheckSalt;
+    }
+    uint64_t memoized;
+    if (sVerifyMemo.lookup(key, memoized)) {
+        sVerifyMemoHits.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<int>(memoized);
+    }
+    sVerifyMemoMisses.fetch_add(1, std::memory_order_relaxed);
+
+    int result;
+    // FFL rejects extended colors, so those Miis are verified natively.
+    // Everything else goes straight to FFL, untouched.
+    if (isExtendedCharInfo(info)) {
+        result = verifyExtendedCharInfo(info, nameCheck != 0);
+    } else {
+        HOOK_STATS_FALLTHROUGH();
+        result = real_FFLiVerifyCharInfoWithReason(pInfo, nameCheck);
+    }
+    sVerifyMemo.insert(key, static_cast<uint32_t>(result));
 #ifdef __WIIU__
     if (result != 0 &&
         result != 21 && // this is encountered when inputting null
                         // which a lot of games like to do for some reason
         result < static_cast<int>(FFLiVerifyReasonStrings.size()) // Maximum.
     ) {
-        char log[96];
-        const char* str = FFLiVerifyReasonStrings.data()[result];
-        snprintf(log, sizeof(log), "charinfo verify fail: %d (%s)", result, str);
-
-        DEBUG_FUNCTION_LINE_INFO("%s", log);
-        NotificationModule_AddErrorNotification(log);
+        DEBUG_FUNCTION_LINE_NOTIFY_DEFERRED("charinfo verify fail: %d (%s)", result, FFLiVerifyReasonStrings.data()[result]);
     }
 #endif
     // return 0; // FFLI_VERIFY_REASON_OK
 
-    memcpy(pInfo, &prevInfo, sizeof(FFLiCharInfo));
-    /*
+#if defined(__WIIU__) && defined(VERBOSE_DEBUG)
     char base64[BASE64_ENCODED_SIZE(sizeof(FFLiCharInfo))];
-    base64_encode(static_cast<const uint8_t*>(pInfo), sizeof(FFLiCharInfo), base64);
+    base64_encode(static_cast<const unsigned char*>(pInfo), sizeof(FFLiCharInfo), base64);
     DEBUG_FUNCTION_LINE_VERBOSE("charinfo after verify: %s", base64);
-    */
+#endif
     return result;
 }
 
 #ifdef __WIIU__
 void printNxExtensionFields(NxExtensionFields& ext) {
-    DEBUG_FUNCTION_LINE_VERBOSE("Faceline Color: %u", ext.facelineColor);
-    DEBUG_FUNCTION_LINE_VERBOSE("Hair Color:     %u", ext.hairColor);
-    DEBUG_FUNCTION_LINE_VERBOSE("Eye Color:      %u", ext.eyeColor);
-    DEBUG_FUNCTION_LINE_VERBOSE("Eyebrow Color:  %u", ext.eyebrowColor);
-    DEBUG_FUNCTION_LINE_VERBOSE("Mouth Color:    %u", ext.mouthColor);
-    DEBUG_FUNCTION_LINE_VERBOSE("Beard Color:    %u", ext.beardColor);
-    DEBUG_FUNCTION_LINE_VERBOSE("Glass Color:    %u", ext.glassColor);
-    DEBUG_FUNCTION_LINE_VERBOSE("Glass Type:     %u", ext.glassType);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Faceline Color: %u", ext.facelineColor);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Hair Color:     %u", ext.hairColor);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Eye Color:      %u", ext.eyeColor);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Eyebrow Color:  %u", ext.eyebrowColor);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Mouth Color:    %u", ext.mouthColor);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Beard Color:    %u", ext.beardColor);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Glass Color:    %u", ext.glassColor);
+    DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Glass Type:     %u", ext.glassType);
+}
+#endif
+
+#ifdef __WIIU__
+/// Decoded extension fields of recently seen Mii data, keyed by a hash of the core.
+/// Lists like the friend list or Mii Maker decode the same Miis over and over.
+static HashedResultCache<1024> sDecodeCache;
+
+/// Stored in sDecodeCache for data without extension fields.
+/// Every byte is out of range for NxExtensionFields, so this can't be real data.
+static constexpr uint64_t cNoExtensionMarker = UINT64_MAX;
+static_assert(sizeof(NxExtensionFields) == sizeof(uint64_t));
+
+/// Decodes the extension fields in Ver3 core data, or fetches them from sDecodeCache.
+/// @return False if the data has no extension fields.
+static bool decodeExtensionCached(const void* src, NxExtensionFields& out) {
+    // FFL's data is in the console's own (big-endian) byte order.
+    const Ver3MiiNativeConstView core(static_cast<const u8*>(src));
+    // Most Miis aren't eFFSD at all, so reject them before even hashing.
+    if (!NxInVer3Pack::QuickDetect(core)) {
+        return false;
+    }
+    const uint64_t key = ContentHash::hashWords(src, sizeof(Ver3MiiDataCore)); // 72 bytes
+
+    uint64_t packed;
+    if (!sDecodeCache.lookup(key, packed)) {
+        if (NxInVer3Pack::TryUnpack(core, out)) {
+            DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED("Detected extension data.");
+            printNxExtensionFields(out);
+            memcpy(&packed, &out, sizeof(packed));
+        } else {
+            packed = cNoExtensionMarker;
+        }
+        sDecodeCache.insert(key, packed);
+    }
+
+    if (packed == cNoExtensionMarker) {
+        return false;
+    }
+    memcpy(&out, &packed, sizeof(out));
+    return true;
 }
 #endif
 
 DECL_FUNCTION(void, FFLiMiiDataCore2CharInfo, void* dst, const void* src, char16_t* creatorName, int birthday);
 void my_FFLiMiiDataCore2CharInfo(void* dst, const void* src, char16_t* creatorName, int birthday) {
-#ifdef __WIIU__
-    /*
-    if (creatorName !== nullptr) { // official
-        //uint8_t official[92];
-        //memcpy(official, src, 92);
-        //real_FFLiStoreData_SwapEndian(official);
-        char base64[BASE64_ENCODED_SIZE(92)];
-        base64_encode(static_cast<const uint8_t*>(base64), 92, base64);
-
-        char log[192];
-        snprintf(log, sizeof(log), "mii input: %s", base64);
-        DEBUG_FUNCTION_LINE_INFO("%s", log);
-        NotificationModule_AddInfoNotification(log);
-    }
-    */
+    HOOK_STATS_SCOPE(FFLiMiiDataCore2CharInfo);
+    HOOK_TRACE_CALL_WITH(FFLiMiiDataCore2CharInfo, src, sizeof(Ver3MiiDataCore), birthday);
+#if defined(__WIIU__) && defined(VERBOSE_DEBUG)
+    // Big-endian, as FFL has it in memory. Use a Ver3MiiNativeView to read it on a PC.
+    char base64[BASE64_ENCODED_SIZE(sizeof(Ver3MiiDataCore))];
+    base64_encode(static_cast<const unsigned char*>(src), sizeof(Ver3MiiDataCore), base64);
+    DEBUG_FUNCTION_LINE_VERBOSE("mii input: %s", base64);
 #endif
 
     real_FFLiMiiDataCore2CharInfo(dst, src, creatorName, birthday);
 
 #ifdef __WIIU__
-    const Ver3MiiDataCore& core = *reinterpret_cast<const Ver3MiiDataCore*>(src);
-
-    ExtraDataBlock block{};
-    NxInVer3Pack::ExtractExtra(core, block);
-    bool hasExtensionData = (reinterpret_cast<uint32_t*>(block.data[0]) != 0);
-    if (hasExtensionData) {
-        NxExtensionFields out{};
-        NxInVer3Pack::Unpack(block, core, out);
-        DEBUG_FUNCTION_LINE_VERBOSE("Detected extension data.\n");
-        printNxExtensionFields(out);
-
+    NxExtensionFields out{};
+    // The SD card database takes precedence over the Mii's own colors.
+    if (findColorOverride(src, out) || decodeExtensionCached(src, out)) {
         FFLiCharInfo& info = *reinterpret_cast<FFLiCharInfo*>(dst);
         // These indicate all of the fields for which common colors
         // should be enabled. If a field here isn't enabled, then
@@ -156,22 +288,33 @@ void my_FFLiMiiDataCore2CharInfo(void* dst, const void* src, char16_t* creatorNa
         //info.beard.color = out.beardColor | FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK;
         info.glass.color = out.glassColor | FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK;
         // info.glass.type = out.glassType;
-        // Extended glass types require a new texture resource
-        // and probably aren't possible without more modifications.
+        // Glass types past FFLI_GLASS_TEXTURE_MAX need their texture from the
+        // glass overlay, so this waits until my_FFLiResourceLoader_LoadTexture is hooked.
+    } else {
+        HOOK_STATS_FALLTHROUGH();
     }
 #endif
 }
 
+#ifdef __WIIU__
+/// eFFSD can only store common colors, so custom colors are saved as the nearest one.
+static u8 toStoredCommonColor(int color) {
+    return getNearestCommonColor(color & FFLI_NN_MII_COMMON_COLOR_MASK);
+}
+#endif
+
 // This function needs to be patched as well, because it turns
 // out that the system will often try to decode to CharInfo
 // and then re-encode back to StoreData.
 // Happens when scanning QR codes, or, of course, editing in the editor.
 DECL_FUNCTION(void, FFLiCharInfo2MiiDataCore, void* dst, const void* src, int birthday);
 void my_FFLiCharInfo2MiiDataCore(void* dst, const void* src, int birthday) {
+    HOOK_STATS_SCOPE(FFLiCharInfo2MiiDataCore);
+    HOOK_TRACE_CALL_WITH(FFLiCharInfo2MiiDataCore, src, sizeof(FFLiCharInfo), birthday);
     real_FFLiCharInfo2MiiDataCore(dst, src, birthday);
 
 #ifdef __WIIU__
-    Ver3MiiDataCore& core = *reinterpret_cast<Ver3MiiDataCore*>(dst);
+    const Ver3MiiNativeView core(static_cast<u8*>(dst));
 
     const FFLiCharInfo& info = *reinterpret_cast<const FFLiCharInfo*>(src);
     bool hasExtensionData = (info.hair.color & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) != 0;
@@ -179,14 +322,16 @@ void my_FFLiCharInfo2MiiDataCore(void* dst, const void* src, int birthday) {
         NxExtensionFields in{};
         // All fields are casted to u8. Functional style casts are shorter.
         in.facelineColor = u8(info.faceline.color);
-        in.hairColor = u8(info.hair.color & FFLI_NN_MII_COMMON_COLOR_MASK);
-        in.eyeColor = u8(info.eye.color & FFLI_NN_MII_COMMON_COLOR_MASK);
-        in.eyebrowColor = u8(info.eyebrow.color & FFLI_NN_MII_COMMON_COLOR_MASK);
-        in.mouthColor = u8(info.mouth.color & FFLI_NN_MII_COMMON_COLOR_MASK);
-        in.beardColor = u8(info.beard.color & FFLI_NN_MII_COMMON_COLOR_MASK);
-        in.glassColor = u8(info.glass.color & FFLI_NN_MII_COMMON_COLOR_MASK);
+        in.hairColor = toStoredCommonColor(info.hair.color);
+        in.eyeColor = toStoredCommonColor(info.eye.color);
+        in.eyebrowColor = toStoredCommonColor(info.eyebrow.color);
+        in.mouthColor = toStoredCommonColor(info.mouth.color);
+        in.beardColor = toStoredCommonColor(info.beard.color);
+        in.glassColor = toStoredCommonColor(info.glass.color);
         in.glassType = u8(info.glass.type);
         NxInVer3Pack::Pack(in, core);
+    } else {
+        HOOK_STATS_FALLTHROUGH();
     }
 #endif
 }
@@ -199,7 +344,10 @@ void my_FFLiCharInfo2MiiDataCore(void* dst, const void* src, int birthday) {
 DECL_FUNCTION(void, FFLiInitModulateEye, void* pParam, int colorGB, int colorR, const void* pTexture);
 // real_ pointer will be written by FunctionPatcher.
 void my_FFLiInitModulateEye(void* pParam, int colorGB, int colorR, const void* pTexture) {
+    HOOK_STATS_SCOPE(FFLiInitModulateEye);
+    HOOK_TRACE_CALL(FFLiInitModulateEye, colorGB, colorR);
     if ((colorGB & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) == 0) {
+        HOOK_STATS_FALLTHROUGH();
         return real_FFLiInitModulateEye(pParam, colorGB, colorR, pTexture);
     }
 
@@ -219,15 +367,16 @@ void my_FFLiInitModulateEye(void* pParam, int colorGB, int colorR, const void* p
     // Color B is the inner eye color.
     // (Use colorGB for eye color index.)
     // param.pColorB = &cColorRed;
-    const int i = colorGB & FFLI_NN_MII_COMMON_COLOR_MASK;
-    // DEBUG_FUNCTION_LINE_INFO("get eye color: %u, float: %f %f %f\n", i, nnmiiCommonColors[i][1].r, nnmiiCommonColors[i][1].g, nnmiiCommonColors[i][1].b);
-    param.pColorB = &nnmiiCommonColors[i][1];
+    param.pColorB = getBoundCommonColor(colorGB);
 }
 
 DECL_FUNCTION(void, FFLiInitModulateMouth, void* pParam, int color, const void* pTexture);
 // real_ pointer will be written by FunctionPatcher.
 void my_FFLiInitModulateMouth(void* pParam, int color, const void* pTexture) {
+    HOOK_STATS_SCOPE(FFLiInitModulateMouth);
+    HOOK_TRACE_CALL(FFLiInitModulateMouth, color);
     if ((color & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) == 0) {
+        HOOK_STATS_FALLTHROUGH();
         return real_FFLiInitModulateMouth(pParam, color, pTexture);
     }
 
@@ -242,9 +391,22 @@ void my_FFLiInitModulateMouth(void* pParam, int color, const void* pTexture) {
 
     // Color R, from the common color table.
     const int i = color & FFLI_NN_MII_COMMON_COLOR_MASK;
-    param.pColorR = &nnmiiCommonColors[i][1];
+    // Mouth color R is fetched as sRGB, like the eyebrow.
+    param.pColorR = &gNnMiiColorTables.common[i][NN_MII_COLOR_GAMMA_SRGB];
     // param.pColorR = &cColorRed;
 
     // Color G, from: nn::mii::detail::UpperLipColorTable
     param.pColorG = &cColorEyeShadow; // Cyan for testing.
 }
+
+DECL_FUNCTION(int, FFLiResourceLoader_LoadTexture, void* self, void* pData, uint32_t* pSize, int partsType, uint32_t index);
+// real_ pointer will be written by FunctionPatcher.
+int my_FFLiResourceLoader_LoadTexture(void* self, void* pData, uint32_t* pSize, int partsType, uint32_t index) {
+    HOOK_STATS_SCOPE(FFLiResourceLoader_LoadTexture);
+    HOOK_TRACE_CALL(FFLiResourceLoader_LoadTexture, partsType, index);
+    // TODO: Once this has a signature and glass types past FFLI_GLASS_TEXTURE_MAX
+    // are set, copy those from loadGlassOverlayPart(), bounded by the buffer
+    // size FFL got from its resource header.
+    HOOK_STATS_FALLTHROUGH();
+    return real_FFLiResourceLoader_LoadTexture(self, pData, pSize, partsType, index);
+}
@@ -1,6 +1,7 @@
 #include <array>
 #include <function_patcher/fpatching_defines.h>
 #include "utils/SignatureScanner.h"
+#include "ffl_types.h" // FFLiContainerType
 
 /// Shortcut I'm using for making function_replacement_data_t types statically.
 /// REPLACE_FUNCTION_VIA_ADDRESS -> ... REPLACE_FUNCTION_EX (Please see fpatching_defines.h if you confused)
@@ -32,6 +33,11 @@ extern DECL_FUNCTION(void, FFLiInitModulateEye, void* pParam, int colorGB, int c
 extern DECL_FUNCTION(void, FFLiInitModulateMouth, void* pParam, int color, const void* pTexture);
 extern DECL_FUNCTION(const void*, FFLiGetFacelineColor, int colorIndex);
 extern DECL_FUNCTION(const void*, FFLiGetGlassColor, int colorIndex);
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/src/FFLiColor.cpp
+extern DECL_FUNCTION(const void*, FFLiGetSrgbFetchEyebrowColor, int colorIndex);
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/src/FFLiResourceLoader.cpp
+/// FFLiResourceLoader::LoadTexture. `self` is the FFLiResourceLoader.
+extern DECL_FUNCTION(int, FFLiResourceLoader_LoadTexture, void* self, void* pData, uint32_t* pSize, int partsType, uint32_t index);
 
 // function_replacement_data_t structures for functions above.
 
@@ -44,6 +50,36 @@ DEFINE_REPLACE_FUNC(FFLiInitModulateEye);
 [[maybe_unused]] DEFINE_REPLACE_FUNC(FFLiInitModulateMouth);
 [[maybe_unused]] DEFINE_REPLACE_FUNC(FFLiGetFacelineColor);
 DEFINE_REPLACE_FUNC(FFLiGetGlassColor);
+DEFINE_REPLACE_FUNC(FFLiGetSrgbFetchEyebrowColor);
+// No signature yet, see the glass type in my_FFLiMiiDataCore2CharInfo.
+[[maybe_unused]] DEFINE_REPLACE_FUNC(FFLiResourceLoader_LoadTexture);
+
+// // ---------------------------------------------------------------
+// //  Color Gamma Binding
+// // ---------------------------------------------------------------
+
+/// Returns the FFLiContainerType that a module is known to set up FFL with.
+/// @param moduleName Name or path of the RPX, as in OSDynLoad_NotifyData.
+/// @note Looked up by name, so unlisted linear titles are treated as sRGB.
+FFLiContainerType getContainerTypeForModule(const char* moduleName);
+
+/// Binds the color hooks to the color table column for this container type.
+/// Called once before patching, so the hooks themselves never branch on gamma.
+void bindColorHooksToContainerType(FFLiContainerType type);
+
+// // ---------------------------------------------------------------
+// //  Verification Memo
+// // ---------------------------------------------------------------
+
+/// Counters for the FFLiVerifyCharInfoWithReason memo table.
+struct VerifyMemoStats {
+    uint32_t hits;   ///< Verifications answered from the memo.
+    uint32_t misses; ///< Verifications that ran the verifier.
+};
+/// Reads the memo counters. Use these to tune the memo table size.
+VerifyMemoStats getVerifyMemoStats();
+/// Clears the counters, e.g. when a title starts. The memo itself is kept.
+void resetVerifyMemoStats();
 
 // // ---------------------------------------------------------------
 // //  Function Matching Signatures
@@ -170,8 +206,8 @@ static constexpr std::array cSignaturesFFL = std::to_array<SignatureDefinition>(
     */
     // NOTE: Eyebrow and mustache are technically using
     // the SrgbFetch variants, meaning they ALWAYS NEED TO USE sRGB
-    { // Hair color
-        .name = "FFLiGetSrgbFetchEyebrowColor", .pHookInfo = &replacement_FFLiGetHairColor,
+    { // Hair color, always sRGB
+        .name = "FFLiGetSrgbFetchEyebrowColor", .pHookInfo = &replacement_FFLiGetSrgbFetchEyebrowColor,
         .words = {
             { 0x3800000b, 0xFFFFFFFF }, // Same as hair, but 04 changed to 0b
             { 0x919E0000, 0xFFFFFFFF }, // Store in r12 instead of r31
@@ -288,3 +324,4 @@ static constexpr std::array cSignaturesFFL = std::to_array<SignatureDefinition>(
 // The following games are known to use linear colors:
 // - Wii U Menu (+ Friends List, Notifications)
 // - Mario Kart 8
+// These are listed by executable name in ffl_patches.cpp.
@@ -13,6 +13,14 @@ typedef struct alignas(16) FFLColor
 FFLColor;
 static_assert(sizeof(FFLColor) == 0x10);
 
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/src/FFLiColor.cpp#L27
+enum FFLiContainerType
+{
+    FFLI_CONTAINER_TYPE_NORMAL  = 0,
+    FFLI_CONTAINER_TYPE_SRGB    = 1,
+    FFLI_CONTAINER_TYPE_MAX     = 2
+};
+
 /// https://github.com/ariankordi/ffl/blob/97eecdf3688f92c4c95cecf5d6ab3e84c0ee42c0/include/nn/ffl/FFLModulateParam.h#L11
 typedef enum FFLModulateMode
 {
@@ -62,9 +70,8 @@ typedef struct FFLModulateParam
     const /*GX2Texture*/void*   pGX2Texture;
 }
 FFLModulateParam;
-#ifdef __WIIU__
-static_assert(sizeof(FFLModulateParam) == 0x18);
-#endif
+// Only matches FFL's layout with 32-bit pointers (not when the plugin is built for a PC).
+static_assert(sizeof(void*) != 4 || sizeof(FFLModulateParam) == 0x18);
 
 typedef struct FFLiCharInfo
 {
@@ -169,6 +176,70 @@ typedef struct FFLiCharInfo
 }
 FFLiCharInfo;
 
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/include/nn/ffl/detail/FFLiCharInfo.h
+/// Indices into FFLiVerifyReasonStrings.
+typedef enum FFLiVerifyReason
+{
+    FFLI_VERIFY_REASON_SUCCESS          =  0,
+    FFLI_VERIFY_REASON_FACELINE_TYPE    =  1,
+    FFLI_VERIFY_REASON_FACELINE_COLOR   =  2,
+    FFLI_VERIFY_REASON_FACELINE_TEXTURE =  3,
+    FFLI_VERIFY_REASON_FACELINE_MAKE    =  4,
+    FFLI_VERIFY_REASON_HAIR_TYPE        =  5,
+    FFLI_VERIFY_REASON_HAIR_COLOR       =  6,
+    FFLI_VERIFY_REASON_HAIR_FLIP        =  7,
+    FFLI_VERIFY_REASON_EYE_TYPE         =  8,
+    FFLI_VERIFY_REASON_EYE_COLOR        =  9,
+    FFLI_VERIFY_REASON_EYE_SCALE        = 10,
+    FFLI_VERIFY_REASON_EYE_ASPECT       = 11,
+    FFLI_VERIFY_REASON_EYE_ROTATE       = 12,
+    FFLI_VERIFY_REASON_EYE_X            = 13,
+    FFLI_VERIFY_REASON_EYE_Y            = 14,
+    FFLI_VERIFY_REASON_EYEBROW_TYPE     = 15,
+    FFLI_VERIFY_REASON_EYEBROW_COLOR    = 16,
+    FFLI_VERIFY_REASON_EYEBROW_SCALE    = 17,
+    FFLI_VERIFY_REASON_EYEBROW_ASPECT   = 18,
+    FFLI_VERIFY_REASON_EYEBROW_ROTATE   = 19,
+    FFLI_VERIFY_REASON_EYEBROW_X        = 20,
+    FFLI_VERIFY_REASON_EYEBROW_Y        = 21,
+    FFLI_VERIFY_REASON_NOSE_TYPE        = 22,
+    FFLI_VERIFY_REASON_NOSE_SCALE       = 23,
+    FFLI_VERIFY_REASON_NOSE_Y           = 24,
+    FFLI_VERIFY_REASON_MOUTH_TYPE       = 25,
+    FFLI_VERIFY_REASON_MOUTH_COLOR      = 26,
+    FFLI_VERIFY_REASON_MOUTH_SCALE      = 27,
+    FFLI_VERIFY_REASON_MOUTH_ASPECT     = 28,
+    FFLI_VERIFY_REASON_MOUTH_Y          = 29,
+    FFLI_VERIFY_REASON_BEARD_TYPE       = 30,
+    FFLI_VERIFY_REASON_BEARD_COLOR      = 31,
+    FFLI_VERIFY_REASON_MUSTACHE_TYPE    = 32,
+    FFLI_VERIFY_REASON_MUSTACHE_SCALE   = 33,
+    FFLI_VERIFY_REASON_MUSTACHE_Y       = 34,
+    FFLI_VERIFY_REASON_GLASS_TYPE       = 35,
+    FFLI_VERIFY_REASON_GLASS_COLOR      = 36,
+    FFLI_VERIFY_REASON_GLASS_SCALE      = 37,
+    FFLI_VERIFY_REASON_GLASS_Y          = 38,
+    FFLI_VERIFY_REASON_MOLE_TYPE        = 39,
+    FFLI_VERIFY_REASON_MOLE_SCALE       = 40,
+    FFLI_VERIFY_REASON_MOLE_X           = 41,
+    FFLI_VERIFY_REASON_MOLE_Y           = 42,
+    FFLI_VERIFY_REASON_HEIGHT           = 43,
+    FFLI_VERIFY_REASON_BUILD            = 44,
+    FFLI_VERIFY_REASON_NAME             = 45,
+    FFLI_VERIFY_REASON_CREATORNAME      = 46,
+    FFLI_VERIFY_REASON_GENDER           = 47,
+    FFLI_VERIFY_REASON_BIRTHDAY         = 48,
+    FFLI_VERIFY_REASON_FAVORITECOLOR    = 49,
+    FFLI_VERIFY_REASON_REGIONMOVE       = 50,
+    FFLI_VERIFY_REASON_FONTREGION       = 51,
+    FFLI_VERIFY_REASON_ROOM_INDEX       = 52,
+    FFLI_VERIFY_REASON_POSITION_IN_ROOM = 53,
+    FFLI_VERIFY_REASON_BIRTH_PLATFORM   = 54,
+    FFLI_VERIFY_REASON_CREATEID         = 55,
+    FFLI_VERIFY_REASON_MAX              = 56
+}
+FFLiVerifyReason;
+
 static constexpr std::array FFLiVerifyReasonStrings = std::to_array<const char*>({
     "FFLI_VERIFY_REASON_SUCCESS",
     "FFLI_VERIFY_REASON_FACELINE_TYPE",
@@ -227,3 +298,55 @@ static constexpr std::array FFLiVerifyReasonStrings = std::to_array<const char*>
     "FFLI_VERIFY_REASON_BIRTH_PLATFORM",
     "FFLI_VERIFY_REASON_CREATEID"
 });
+static_assert(FFLiVerifyReasonStrings.size() == FFLI_VERIFY_REASON_MAX);
+
+// // ---------------------------------------------------------------
+// //  Resource Parts
+// // ---------------------------------------------------------------
+
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/include/nn/ffl/FFLResult.h
+/// Only the result the hooks return themselves.
+#define FFL_RESULT_OK 0
+
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/include/nn/ffl/detail/FFLiTexturePartsType.h
+enum FFLiTexturePartsType
+{
+    FFLI_TEXTURE_PARTS_TYPE_BEARD       =  0,
+    FFLI_TEXTURE_PARTS_TYPE_CAP         =  1,
+    FFLI_TEXTURE_PARTS_TYPE_EYE         =  2,
+    FFLI_TEXTURE_PARTS_TYPE_EYEBROW     =  3,
+    FFLI_TEXTURE_PARTS_TYPE_FACELINE    =  4,
+    FFLI_TEXTURE_PARTS_TYPE_FACE_MAKEUP =  5,
+    FFLI_TEXTURE_PARTS_TYPE_GLASS       =  6,
+    FFLI_TEXTURE_PARTS_TYPE_MOLE        =  7,
+    FFLI_TEXTURE_PARTS_TYPE_MOUTH       =  8,
+    FFLI_TEXTURE_PARTS_TYPE_MUSTACHE    =  9,
+    FFLI_TEXTURE_PARTS_TYPE_NOSELINE    = 10,
+    FFLI_TEXTURE_PARTS_TYPE_MAX         = 11
+};
+
+/// Glass textures in FFL's own resources. Switch glass types past this need new textures.
+#define FFLI_GLASS_TEXTURE_MAX 9
+
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/include/nn/ffl/detail/FFLiResourceStrategy.h
+/// 0-4 are zlib's deflate strategies.
+enum FFLiResourceStrategy
+{
+    FFLI_RESOURCE_STRATEGY_UNCOMPRESSED = 5,
+    FFLI_RESOURCE_STRATEGY_MAX          = 6
+};
+
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/include/nn/ffl/detail/FFLiResourceHeader.h
+/// Where one part is in a resource file, and how it's compressed.
+/// Big-endian in the file, like the rest of FFL's resources.
+struct FFLiResourcePartsInfo
+{
+    uint32_t dataPos;
+    uint32_t dataSize;       ///< Size after inflating.
+    uint32_t compressedSize; ///< Size in the file.
+    uint8_t  compressLevel;
+    uint8_t  windowBits;     ///< 0-7: zlib 8-15, 8-15: gzip 8-15, 16+: either (auto) 8-15.
+    uint8_t  memoryLevel;
+    uint8_t  strategy;       ///< FFLiResourceStrategy
+};
+static_assert(sizeof(FFLiResourcePartsInfo) == 0x10);
@@ -0,0 +1,193 @@
+#include "ffl_verify.h"
+#include "ffl_colors.h" // FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK
+
+#include <cstddef>
+
+namespace {
+
+/// How a field in cCharInfoBounds is checked.
+enum class BoundsKind : uint8_t
+{
+    Range,         ///< min <= value <= max.
+    CommonColor,   ///< Range, or a common or custom color index when masked.
+    FacelineColor, ///< Range, or any nn::mii faceline color.
+    Name,          ///< personal.name, only when nameCheck is set.
+    CreatorName,   ///< personal.creator, only when nameCheck is set.
+    Birthday,      ///< personal.birthMonth + birthDay.
+    CreateID       ///< createID, as FFLiIsValidMiiID.
+};
+
+struct FieldBounds
+{
+    FFLiVerifyReason reason;
+    uint16_t         offset; ///< offsetof FFLiCharInfo, int fields only.
+    int16_t          min;
+    int16_t          max;
+    BoundsKind       kind;
+};
+
+#define FIELD(reason, member, min, max, kind) \
+    { FFLI_VERIFY_REASON_##reason, offsetof(FFLiCharInfo, member), min, max, BoundsKind::kind }
+
+/// Same ranges and order as FFLiVerifyCharInfoWithReason,
+/// so the first failing reason matches what FFL would return.
+/// https://github.com/aboood40091/ffl/blob/73fe9fc70c0f96ebea373122e50f6d3acc443180/src/detail/FFLiCharInfo.cpp#L28
+constexpr FieldBounds cCharInfoBounds[] = {
+    FIELD(FACELINE_TYPE,    faceline.type,            0,  11, Range),
+    FIELD(FACELINE_COLOR,   faceline.color,           0,   5, FacelineColor),
+    FIELD(FACELINE_TEXTURE, faceline.texture,         0,  11, Range),
+    FIELD(FACELINE_MAKE,    faceline.make,            0,  11, Range),
+    FIELD(HAIR_TYPE,        hair.type,                0, 131, Range),
+    FIELD(HAIR_COLOR,       hair.color,               0,   7, CommonColor),
+    FIELD(HAIR_FLIP,        hair.flip,                0,   1, Range),
+    FIELD(EYE_TYPE,         eye.type,                 0,  59, Range),
+    FIELD(EYE_COLOR,        eye.color,                0,   5, CommonColor),
+    FIELD(EYE_SCALE,        eye.scale,                0,   7, Range),
+    FIELD(EYE_ASPECT,       eye.aspect,               0,   6, Range),
+    FIELD(EYE_ROTATE,       eye.rotate,               0,   7, Range),
+    FIELD(EYE_X,            eye.x,                    0,  12, Range),
+    FIELD(EYE_Y,            eye.y,                    0,  18, Range),
+    FIELD(EYEBROW_TYPE,     eyebrow.type,             0,  23, Range),
+    FIELD(EYEBROW_COLOR,    eyebrow.color,            0,   7, CommonColor),
+    FIELD(EYEBROW_SCALE,    eyebrow.scale,            0,   8, Range),
+    FIELD(EYEBROW_ASPECT,   eyebrow.aspect,           0,   6, Range),
+    FIELD(EYEBROW_ROTATE,   eyebrow.rotate,           0,  11, Range),
+    FIELD(EYEBROW_X,        eyebrow.x,                0,  12, Range),
+    FIELD(EYEBROW_Y,        eyebrow.y,                3,  18, Range),
+    FIELD(NOSE_TYPE,        nose.type,                0,  17, Range),
+    FIELD(NOSE_SCALE,       nose.scale,               0,   8, Range),
+    FIELD(NOSE_Y,           nose.y,                   0,  18, Range),
+    FIELD(MOUTH_TYPE,       mouth.type,               0,  35, Range),
+    FIELD(MOUTH_COLOR,      mouth.color,              0,   4, CommonColor),
+    FIELD(MOUTH_SCALE,      mouth.scale,              0,   8, Range),
+    FIELD(MOUTH_ASPECT,     mouth.aspect,             0,   6, Range),
+    FIELD(MOUTH_Y,          mouth.y,                  0,  18, Range),
+    FIELD(BEARD_TYPE,       beard.type,               0,   5, Range),
+    FIELD(BEARD_COLOR,      beard.color,              0,   7, CommonColor),
+    FIELD(MUSTACHE_TYPE,    beard.mustache,           0,   5, Range),
+    FIELD(MUSTACHE_SCALE,   beard.scale,              0,   8, Range),
+    FIELD(MUSTACHE_Y,       beard.y,                  0,  16, Range),
+    FIELD(GLASS_TYPE,       glass.type,               0,   8, Range),
+    FIELD(GLASS_COLOR,      glass.color,              0,   5, CommonColor),
+    FIELD(GLASS_SCALE,      glass.scale,              0,   7, Range),
+    FIELD(GLASS_Y,          glass.y,                  0,  20, Range),
+    FIELD(MOLE_TYPE,        mole.type,                0,   1, Range),
+    FIELD(MOLE_SCALE,       mole.scale,               0,   8, Range),
+    FIELD(MOLE_X,           mole.x,                   0,  16, Range),
+    FIELD(MOLE_Y,           mole.y,                   0,  30, Range),
+    FIELD(HEIGHT,           body.height,              0, 127, Range),
+    FIELD(BUILD,            body.build,               0, 127, Range),
+    FIELD(NAME,             personal.name,            0,   0, Name),
+    FIELD(CREATORNAME,      personal.creator,         0,   0, CreatorName),
+    FIELD(GENDER,           personal.gender,          0,   1, Range),
+    FIELD(BIRTHDAY,         personal.birthMonth,      0,  12, Birthday),
+    FIELD(FAVORITECOLOR,    personal.favoriteColor,   0,  11, Range),
+    FIELD(REGIONMOVE,       personal.regionMove,      0,   3, Range),
+    FIELD(FONTREGION,       personal.fontRegion,      0,   3, Range),
+    FIELD(ROOM_INDEX,       personal.roomIndex,       0,   9, Range),
+    FIELD(POSITION_IN_ROOM, personal.positionInRoom,  0,   9, Range),
+    FIELD(BIRTH_PLATFORM,   personal.birthPlatform,   0,   7, Range),
+    FIELD(CREATEID,         createID,                 0,   0, CreateID),
+};
+
+#undef FIELD
+
+/// Color fields that may hold a masked common color, for isExtendedCharInfo.
+constexpr uint16_t cCommonColorOffsets[] = {
+    offsetof(FFLiCharInfo, hair.color),
+    offsetof(FFLiCharInfo, eye.color),
+    offsetof(FFLiCharInfo, eyebrow.color),
+    offsetof(FFLiCharInfo, mouth.color),
+    offsetof(FFLiCharInfo, beard.color),
+    offsetof(FFLiCharInfo, glass.color),
+};
+
+/// FFL's own faceline color count.
+constexpr int cFacelineColorMaxFFL = 6;
+
+inline int loadField(const FFLiCharInfo& info, uint16_t offset) {
+    return *reinterpret_cast<const int*>(reinterpret_cast<const uint8_t*>(&info) + offset);
+}
+
+inline bool isInRange(int value, int min, int max) {
+    return value >= min && value <= max;
+}
+
+/// Names must end within 10 characters. The Mii name also can't be empty.
+inline bool isValidName(const char16_t* name, bool allowEmpty) {
+    return (allowEmpty || name[0] != u'\0') && name[10] == u'\0';
+}
+
+/// Either no birthday is set, or it's a day that exists (including Feb 29).
+inline bool isValidBirthday(int month, int day) {
+    constexpr int cDaysInMonth[13] = { 0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (!isInRange(month, 0, 12) || !isInRange(day, 0, 31)) {
+        return false;
+    }
+    if (month == 0 || day == 0) {
+        return month == day;
+    }
+    return day <= cDaysInMonth[month];
+}
+
+/// FFLiIsValidMiiID: a create ID that is all zeroes was never assigned.
+inline bool isValidCreateID(const uint8_t (&createID)[10]) {
+    for (const uint8_t byte : createID) {
+        if (byte != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool isExtendedCharInfo(const FFLiCharInfo& info) {
+    if (info.faceline.color >= cFacelineColorMaxFFL) {
+        return true;
+    }
+    for (const uint16_t offset : cCommonColorOffsets) {
+        if ((loadField(info, offset) & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+FFLiVerifyReason verifyExtendedCharInfo(const FFLiCharInfo& info, bool nameCheck) {
+    for (const FieldBounds& bounds : cCharInfoBounds) {
+        bool valid = true;
+        switch (bounds.kind) {
+            case BoundsKind::Range:
+                valid = isInRange(loadField(info, bounds.offset), bounds.min, bounds.max);
+                break;
+            case BoundsKind::CommonColor: {
+                const int value = loadField(info, bounds.offset);
+                valid = (value & FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) != 0
+                    ? isInRange(value & FFLI_NN_MII_COMMON_COLOR_MASK, 0,
+                        FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX - 1)
+                    : isInRange(value, bounds.min, bounds.max);
+                break;
+            }
+            case BoundsKind::FacelineColor:
+                valid = isInRange(loadField(info, bounds.offset), 0, FFLI_NN_MII_FACELINE_COLOR_MAX - 1);
+                break;
+            case BoundsKind::Name:
+                valid = !nameCheck || isValidName(info.personal.name, false);
+                break;
+            case BoundsKind::CreatorName:
+                valid = !nameCheck || isValidName(info.personal.creator, true);
+                break;
+            case BoundsKind::Birthday:
+                valid = isValidBirthday(info.personal.birthMonth, info.personal.birthDay);
+                break;
+            case BoundsKind::CreateID:
+                valid = isValidCreateID(info.createID);
+                break;
+        }
+        if (!valid) {
+            return bounds.reason;
+        }
+    }
+    return FFLI_VERIFY_REASON_SUCCESS;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "ffl_types.h"
+
+// // ---------------------------------------------------------------
+// //  Native CharInfo Verification
+// // ---------------------------------------------------------------
+// FFL's own verifier rejects every Switch color, so Miis carrying them
+// are checked here instead. Everything else still goes to FFL.
+
+/// True if any color in the CharInfo is outside of what FFL accepts,
+/// i.e. it was decoded with NxInVer3Pack extension fields.
+bool isExtendedCharInfo(const FFLiCharInfo& info);
+
+/**
+ * @brief Equivalent of FFLiVerifyCharInfoWithReason that also accepts
+ *        common colors (FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK) and Switch faceline colors.
+ * @param info      CharInfo to verify. Not modified.
+ * @param nameCheck Whether to check the name and creator name.
+ * @return FFLI_VERIFY_REASON_SUCCESS, or the first failing reason.
+ */
+FFLiVerifyReason verifyExtendedCharInfo(const FFLiCharInfo& info, bool nameCheck);
@@ -1,3 +1,4 @@
+#include <cassert>
 #include <cstdio>
 #include <cstring>
 #include <wups.h>
@@ -11,6 +12,14 @@
 #include "utils/logger.h"
 #include "patches.h"
 #include "editor_patches.h"
+#include "ffl_colors.h" // initNnMiiColorTables
+#include "ffl_patches.h" // getVerifyMemoStats
+#include "color_overrides.h"
+#include "utils/HookStats.h"
+#include "utils/HookTrace.h"
+#ifdef HOOK_STATS
+#include <vpad/input.h>
+#endif
 
 // // ---------------------------------------------------------------
 // //  Plugin Metadata
@@ -46,7 +55,9 @@ void scanAllModulesAndPatchFFL() {
         return;
     }
 
-    for (OSDynLoad_NotifyData& module : modules) {
+    // Only the first numberOfRPLs entries were filled in.
+    for (int i = 0; i < numberOfRPLs; i++) {
+        OSDynLoad_NotifyData& module = modules[i];
         // Only scan RPX executables that plausibly embed FFL.
         // This would soon have to support scanning RPLs as well,
         // in which case it'd be a good idea to skip OS libs (coreinit.rpl, gx2.rpl)
@@ -124,12 +135,35 @@ void checkAndScanModules() {
 /// Not sure if this is actually needed.
 static bool gFunctionPatcherInitialized = false;
 
+#ifdef HOOK_STATS
+// // ---------------------------------------------------------------
+// //  Hook Stats Button Combo
+// // ---------------------------------------------------------------
+
+/// Pressed together on the GamePad to dump the hook stats while a title runs.
+static constexpr uint32_t cDumpHookStatsCombo = VPAD_BUTTON_L | VPAD_BUTTON_R | VPAD_BUTTON_MINUS;
+
+DECL_FUNCTION(int32_t, VPADRead, VPADChan chan, VPADStatus* buffers, uint32_t count, VPADReadError* outError) {
+    const int32_t result = real_VPADRead(chan, buffers, count, outError);
+    // buffers[0] is the newest sample. Only the press that completes
+    // the combo counts, so holding it doesn't dump every frame.
+    if (result > 0 && (outError == nullptr || *outError == VPAD_READ_SUCCESS) &&
+        (buffers[0].hold & cDumpHookStatsCombo) == cDumpHookStatsCombo &&
+        (buffers[0].trigger & cDumpHookStatsCombo) != 0) {
+        dumpHookStats();
+    }
+    return result;
+}
+WUPS_MUST_REPLACE(VPADRead, WUPS_LOADER_LIBRARY_VPAD, VPADRead);
+#endif
+
 // // ---------------------------------------------------------------
 // //  Plugin Lifecycle
 // // ---------------------------------------------------------------
 INITIALIZE_PLUGIN() {
     initLogging();
     initPatchHandles();
+    initNnMiiColorTables();
 
     if (auto st = NotificationModule_InitLibrary(); st != NOTIFICATION_MODULE_RESULT_SUCCESS) {
         DEBUG_FUNCTION_LINE("Notifications init failed: %s", NotificationModule_GetStatusStr(st));
@@ -143,10 +177,11 @@ INITIALIZE_PLUGIN() {
 
 DEINITIALIZE_PLUGIN() {
     deinitPatchHandles();
+    unloadColorOverrides();
     FunctionPatcher_DeInitLibrary();
-    NotificationModule_DeInitLibrary();
-
+    // Before NotificationModule goes away, since the flusher posts what's left.
     deinitLogging();
+    NotificationModule_DeInitLibrary();
 }
 
 ON_APPLICATION_START() {
@@ -157,11 +192,36 @@ ON_APPLICATION_START() {
         return;
     }
 
+    // Before any hooks are applied for this title, so the file
+    // can be edited between titles and nothing reads it while loading.
+    loadColorOverrides();
+    resetVerifyMemoStats();
+#ifdef HOOK_STATS
+    resetHookStats();
+#endif
+#ifdef HOOK_TRACE
+    resetHookTrace();
+#endif
+
     addPatchesMiiStudio();
 
     checkAndScanModules(); // Calls scanAllModulesAndPatchFFL.
 }
 
 ON_APPLICATION_ENDS() {
+#ifdef DEBUG
+    const VerifyMemoStats memo = getVerifyMemoStats();
+    DEBUG_FUNCTION_LINE("Verify memo: %u hits, %u misses", memo.hits, memo.misses);
+#endif
+#ifdef HOOK_STATS
+    dumpHookStats();
+#endif
+#ifdef HOOK_TRACE
+    // The title's threads are done with FFL by now, which saving needs.
+    saveHookTrace();
+#endif
+    // The next title is scanned and patched again, so this one's
+    // patches go now rather than filling up gHandles.
+    deinitPatchHandles();
     deinitLogging();
 }
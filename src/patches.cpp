@@ -2,12 +2,13 @@
 #include <function_patcher/fpatching_defines.h>
 #include <coreinit/dynload.h>
 #include <notifications/notifications.h>
+#include <cassert>
 #include <cstring>
 
 #if DEBUG
 #include <chrono> // Benchmarking
-#include "utils/logger.h"
 #endif
+#include "utils/logger.h"
 
 #include "utils/SignatureScanner.h"
 #include "patches.h"
@@ -27,6 +28,13 @@ static void applyPatchFromMatch(const SignatureMatch& match) {
         reinterpret_cast<function_replacement_data_t*>(def.pHookInfo);
     function_replacement_data_t repl = *tmpl;
 
+    // A patch whose handle can't be kept could never be removed.
+    if (gHandleIndex >= MAX_PATCHED_HANDLES) {
+        DEBUG_FUNCTION_LINE_ERR("No room for more patch handles (max %d), skipping %s",
+            MAX_PATCHED_HANDLES, def.name);
+        return;
+    }
+
     // Set pointers in either the original or copy.
     repl.virtualAddr = static_cast<uint32_t>(match.effectiveAddress);
     // There's a chance only one of these have to be set...
@@ -68,6 +76,13 @@ bool scanSingleModuleForPatchFFL(OSDynLoad_NotifyData& module) {
         return false;
     }
 
+    // Resolve the title's gamma once, so the color hooks don't have to.
+    const FFLiContainerType containerType = getContainerTypeForModule(module.name);
+    bindColorHooksToContainerType(containerType);
+#if DEBUG
+    DEBUG_FUNCTION_LINE("%s: using container type %d", module.name, containerType);
+#endif
+
     SignatureMatch matches[SIGSCAN_MAX_MATCHES];
 
 #if DEBUG
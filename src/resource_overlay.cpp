@@ -0,0 +1,202 @@
+#include "resource_overlay.h"
+
+#ifdef GLASS_OVERLAY
+#include "utils/ReadFile.h"
+#include <cstring>
+#include <zlib.h>
+
+#ifdef __WIIU__
+#include "utils/logger.h"
+#endif
+
+static uint32_t loadBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+/// FFLiResourceWindowBits to the windowBits argument of inflateInit2().
+/// @return 0 if invalid.
+static int toZlibWindowBits(uint8_t windowBits) {
+    if (windowBits < 8) {
+        return 8 + windowBits;             // zlib
+    } else if (windowBits < 16) {
+        return 16 + 8 + (windowBits - 8);  // gzip
+    } else if (windowBits < 24) {
+        return 32 + 8 + (windowBits - 16); // Either, detected from the header.
+    }
+    return 0;
+}
+
+// // ---------------------------------------------------------------
+// //  Loading
+// // ---------------------------------------------------------------
+
+ResourceOverlayResult ResourceOverlay::load(std::vector<uint8_t> file) {
+    clear();
+
+    const uint8_t* data = file.data();
+    if (file.size() < sizeof(ResourceOverlayHeader) ||
+        loadBE32(data + offsetof(ResourceOverlayHeader, magic)) != RESOURCE_OVERLAY_MAGIC ||
+        loadBE32(data + offsetof(ResourceOverlayHeader, version)) != RESOURCE_OVERLAY_VERSION) {
+        return RESOURCE_OVERLAY_RESULT_BAD_HEADER;
+    }
+    const uint32_t partsType    = loadBE32(data + offsetof(ResourceOverlayHeader, partsType));
+    const uint32_t firstIndex   = loadBE32(data + offsetof(ResourceOverlayHeader, firstIndex));
+    const uint32_t partsCount   = loadBE32(data + offsetof(ResourceOverlayHeader, partsCount));
+    const uint32_t partsMaxSize = loadBE32(data + offsetof(ResourceOverlayHeader, partsMaxSize));
+    if (partsType >= FFLI_TEXTURE_PARTS_TYPE_MAX ||
+        (file.size() - sizeof(ResourceOverlayHeader)) / sizeof(FFLiResourcePartsInfo) < partsCount) {
+        return RESOURCE_OVERLAY_RESULT_BAD_HEADER;
+    }
+
+    std::unique_ptr<Part[]> parts(new Part[partsCount]);
+    for (uint32_t i = 0; i < partsCount; i++) {
+        const uint8_t* p = data + sizeof(ResourceOverlayHeader) + i * sizeof(FFLiResourcePartsInfo);
+        FFLiResourcePartsInfo& info = parts[i].info;
+        info.dataPos        = loadBE32(p + offsetof(FFLiResourcePartsInfo, dataPos));
+        info.dataSize       = loadBE32(p + offsetof(FFLiResourcePartsInfo, dataSize));
+        info.compressedSize = loadBE32(p + offsetof(FFLiResourcePartsInfo, compressedSize));
+        info.compressLevel  = p[offsetof(FFLiResourcePartsInfo, compressLevel)];
+        info.windowBits     = p[offsetof(FFLiResourcePartsInfo, windowBits)];
+        info.memoryLevel    = p[offsetof(FFLiResourcePartsInfo, memoryLevel)];
+        info.strategy       = p[offsetof(FFLiResourcePartsInfo, strategy)];
+
+        if (info.dataPos > file.size() || file.size() - info.dataPos < info.compressedSize ||
+            info.dataSize == 0 || info.dataSize > partsMaxSize) {
+            return RESOURCE_OVERLAY_RESULT_BAD_PARTS;
+        }
+        if (info.strategy >= FFLI_RESOURCE_STRATEGY_MAX ||
+            (info.strategy == FFLI_RESOURCE_STRATEGY_UNCOMPRESSED
+                ? info.compressedSize != info.dataSize
+                : toZlibWindowBits(info.windowBits) == 0)) {
+            return RESOURCE_OVERLAY_RESULT_BAD_STRATEGY;
+        }
+    }
+
+    mFile = std::move(file);
+    mParts = std::move(parts);
+    mPartsCount = partsCount;
+    mPartsType = static_cast<int>(partsType);
+    mFirstIndex = firstIndex;
+    mPartsMaxSize = partsMaxSize;
+    return RESOURCE_OVERLAY_RESULT_SUCCESS;
+}
+
+void ResourceOverlay::clear() {
+    mParts.reset();
+    mPartsCount = 0;
+    mPartsType = -1;
+    mFirstIndex = 0;
+    mPartsMaxSize = 0;
+    mFile.clear();
+    mInflatedCount.store(0, std::memory_order_relaxed);
+}
+
+// // ---------------------------------------------------------------
+// //  Parts
+// // ---------------------------------------------------------------
+
+bool ResourceOverlay::inflatePart(const Part& part, uint8_t* out) const {
+    z_stream stream{};
+    stream.next_in = const_cast<Bytef*>(mFile.data() + part.info.dataPos);
+    stream.avail_in = part.info.compressedSize;
+    stream.next_out = out;
+    stream.avail_out = part.info.dataSize;
+    if (inflateInit2(&stream, toZlibWindowBits(part.info.windowBits)) != Z_OK) {
+        return false;
+    }
+    const int result = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    return result == Z_STREAM_END && stream.total_out == part.info.dataSize;
+}
+
+const uint8_t* ResourceOverlay::getPart(int partsType, uint32_t index, uint32_t& outSize) {
+    if (!hasPart(partsType, index)) {
+        return nullptr;
+    }
+    Part& part = mParts[index - mFirstIndex];
+    outSize = part.info.dataSize;
+
+    // Already inflated, or being inflated by another core.
+    const uint8_t* data = part.data.load(std::memory_order_acquire);
+    if (data != nullptr) {
+        return data;
+    }
+    std::lock_guard<std::mutex> lock(mInflateMutex);
+    data = part.data.load(std::memory_order_relaxed);
+    if (data != nullptr) {
+        return data;
+    }
+
+    if (part.info.strategy == FFLI_RESOURCE_STRATEGY_UNCOMPRESSED) {
+        // Stored parts are used straight from the file.
+        data = mFile.data() + part.info.dataPos;
+    } else {
+        std::unique_ptr<uint8_t[]> inflated(new uint8_t[part.info.dataSize]);
+        if (!inflatePart(part, inflated.get())) {
+            return nullptr;
+        }
+        data = inflated.get();
+        part.inflated = std::move(inflated);
+        mInflatedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    part.data.store(data, std::memory_order_release);
+    return data;
+}
+
+bool ResourceOverlay::copyPart(int partsType, uint32_t index, void* out, uint32_t bufferSize, uint32_t& outSize) {
+    uint32_t size = 0;
+    const uint8_t* data = getPart(partsType, index, size);
+    if (data == nullptr || size > bufferSize) {
+        return false;
+    }
+    memcpy(out, data, size);
+    outSize = size;
+    return true;
+}
+
+// // ---------------------------------------------------------------
+// //  Glass Overlay
+// // ---------------------------------------------------------------
+
+static ResourceOverlay sGlassOverlay;
+
+void loadGlassOverlay() {
+    sGlassOverlay.clear();
+
+    std::vector<uint8_t> file;
+    if (!readWholeFile(GLASS_OVERLAY_PATH, file)) {
+        return;
+    }
+
+    const ResourceOverlayResult result = sGlassOverlay.load(std::move(file));
+#ifdef __WIIU__
+    if (result == RESOURCE_OVERLAY_RESULT_SUCCESS) {
+        DEBUG_FUNCTION_LINE_INFO("Loaded glass overlay, max part size 0x%X", sGlassOverlay.partsMaxSize());
+    } else {
+        DEBUG_FUNCTION_LINE_ERR("Failed to load " GLASS_OVERLAY_PATH ": %d", result);
+    }
+#else
+    (void)result;
+#endif
+}
+
+void unloadGlassOverlay() {
+    sGlassOverlay.clear();
+}
+
+bool loadGlassOverlayPart(void* pData, uint32_t bufferSize, uint32_t* pSize, int partsType, uint32_t index) {
+    if (partsType != FFLI_TEXTURE_PARTS_TYPE_GLASS || !sGlassOverlay.hasPart(partsType, index)) {
+        return false;
+    }
+    uint32_t size = 0;
+    if (!sGlassOverlay.copyPart(partsType, index, pData, bufferSize, size)) {
+#ifdef __WIIU__
+        DEBUG_FUNCTION_LINE_ERR_DEFERRED("Glass overlay part %u failed to inflate or is bigger than 0x%X", index, bufferSize);
+#endif
+        return false;
+    }
+    *pSize = size;
+    return true;
+}
+
+#endif // GLASS_OVERLAY
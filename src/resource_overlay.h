@@ -0,0 +1,119 @@
+#pragma once
+/**
+ * @file resource_overlay.h
+ * @brief Extra texture parts for FFL, read from a side file next to its resources.
+ *
+ * FFL only has textures for the glass types that Ver3 Miis can have. The
+ * overlay file adds parts after the last one in FFL's own resource, in the
+ * same format: an FFLiResourcePartsInfo for each, then the part data, which
+ * is deflated (or stored) exactly as in FFL's resource files.
+ *
+ * The file is parsed once into an index. Parts are inflated the first time
+ * they're requested, and kept for later requests.
+ *
+ * Nothing in the plugin uses this yet, since FFLiResourceLoader::LoadTexture
+ * has no signature. It's only built with GLASS_OVERLAY, which the tests use.
+ */
+#include "ffl_types.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// // ---------------------------------------------------------------
+// //  File Format
+// // ---------------------------------------------------------------
+// All integers are big-endian, like FFL's resources.
+
+/// "FFRO"
+#define RESOURCE_OVERLAY_MAGIC 0x4646524Fu
+#define RESOURCE_OVERLAY_VERSION 1
+
+/// Followed by FFLiResourcePartsInfo[partsCount], then the part data.
+struct ResourceOverlayHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t partsType;    ///< FFLiTexturePartsType
+    uint32_t firstIndex;   ///< Parts index of the first part, after FFL's own.
+    uint32_t partsCount;
+    uint32_t partsMaxSize; ///< Largest dataSize. Must fit in FFL's buffer for this type.
+};
+static_assert(sizeof(ResourceOverlayHeader) == 0x18);
+
+enum ResourceOverlayResult
+{
+    RESOURCE_OVERLAY_RESULT_SUCCESS,
+    RESOURCE_OVERLAY_RESULT_BAD_HEADER,  ///< Too small, wrong magic or version.
+    RESOURCE_OVERLAY_RESULT_BAD_PARTS,   ///< A part is outside the file, or bigger than partsMaxSize.
+    RESOURCE_OVERLAY_RESULT_BAD_STRATEGY ///< A part's strategy or window bits aren't ones FFL knows.
+};
+
+// // ---------------------------------------------------------------
+// //  Overlay
+// // ---------------------------------------------------------------
+
+class ResourceOverlay {
+public:
+    /// Parses an overlay file and takes it over. On failure, the overlay is left empty.
+    /// Not thread-safe with getPart().
+    ResourceOverlayResult load(std::vector<uint8_t> file);
+    void clear();
+
+    /// Whether this overlay has the part. It covers [firstIndex, firstIndex + partsCount).
+    bool hasPart(int partsType, uint32_t index) const {
+        return partsType == mPartsType && index - mFirstIndex < mPartsCount;
+    }
+
+    /// Returns a part's data, inflating it if this is the first request.
+    /// Safe to call from any core.
+    /// @return Null if the overlay doesn't have it, or it doesn't inflate.
+    const uint8_t* getPart(int partsType, uint32_t index, uint32_t& outSize);
+
+    /// Copies a part into `out`, which is `bufferSize` bytes.
+    /// @return False if getPart() would fail, or the part is bigger than `bufferSize`.
+    bool copyPart(int partsType, uint32_t index, void* out, uint32_t bufferSize, uint32_t& outSize);
+
+    uint32_t partsMaxSize() const { return mPartsMaxSize; }
+    /// How many parts have been inflated, for tests and logging.
+    uint32_t inflatedCount() const { return mInflatedCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Part {
+        FFLiResourcePartsInfo info; ///< In host byte order.
+        /// Inflated data, or the data in mFile if stored. Null until first requested.
+        std::atomic<const uint8_t*> data{nullptr};
+        std::unique_ptr<uint8_t[]> inflated;
+    };
+
+    /// Inflates `part` into `out`, which is info.dataSize bytes.
+    bool inflatePart(const Part& part, uint8_t* out) const;
+
+    std::vector<uint8_t> mFile;
+    std::unique_ptr<Part[]> mParts; ///< Not a vector, since Part can't be moved.
+    uint32_t mPartsCount = 0;
+    int mPartsType = -1;
+    uint32_t mFirstIndex = 0;
+    uint32_t mPartsMaxSize = 0;
+    std::mutex mInflateMutex;
+    std::atomic<uint32_t> mInflatedCount{0};
+};
+
+// // ---------------------------------------------------------------
+// //  Glass Overlay
+// // ---------------------------------------------------------------
+
+/// Extra glass textures, after the FFLI_GLASS_TEXTURE_MAX in FFL's resource.
+#define GLASS_OVERLAY_PATH "fs:/vol/external01/wiiu/ffl_glass_overlay.bin"
+
+/// (Re)loads the glass overlay from GLASS_OVERLAY_PATH. Having no file is fine.
+/// Not thread-safe: call this before the hooks are applied to a title.
+void loadGlassOverlay();
+void unloadGlassOverlay();
+
+/// Copies a texture part from the glass overlay, in place of FFL's resource.
+/// @param pData FFL's buffer for the part.
+/// @param bufferSize Size of pData. partsMaxSize comes from the file, so it isn't trusted.
+/// @param[out] pSize Size of the part.
+/// @return False if the overlay doesn't have this part or it doesn't fit, so FFL should load it.
+bool loadGlassOverlayPart(void* pData, uint32_t bufferSize, uint32_t* pSize, int partsType, uint32_t index);
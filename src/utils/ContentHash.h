@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * @file ContentHash.h
+ * @brief Fast 64-bit content hash for small fixed-size structs (Mii data, CharInfo).
+ *
+ * This is meant for cache keys, not for security. It runs two 32-bit
+ * lanes over whole words since 64-bit multiplies are slow on Espresso.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ContentHash {
+
+static constexpr uint32_t cPrime1 = 0x9E3779B1u;
+static constexpr uint32_t cPrime2 = 0x85EBCA77u;
+static constexpr uint32_t cPrime3 = 0xC2B2AE3Du;
+static constexpr uint32_t cPrime4 = 0x27D4EB2Fu;
+
+constexpr uint32_t rotl32(uint32_t x, int r) {
+    return (x << r) | (x >> (32 - r));
+}
+
+/// Final avalanche from MurmurHash3.
+constexpr uint32_t fmix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= cPrime2;
+    h ^= h >> 13;
+    h *= cPrime3;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * @brief Hashes a buffer whose size is a multiple of 4 bytes.
+ * @param data Pointer to the data. Does not need to be aligned.
+ * @param size Size in bytes. Trailing bytes past the last whole word are ignored.
+ * @return 64-bit hash, made of two independent 32-bit lanes.
+ */
+inline uint64_t hashWords(const void* data, std::size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const std::size_t wordCount = size / sizeof(uint32_t);
+
+    uint32_t a = cPrime4 ^ static_cast<uint32_t>(size);
+    uint32_t b = cPrime1 + static_cast<uint32_t>(size);
+    for (std::size_t i = 0; i < wordCount; ++i) {
+        uint32_t w;
+        std::memcpy(&w, p + (i * sizeof(uint32_t)), sizeof(w)); // Single word load.
+
+        // Lane A: MurmurHash3 round.
+        uint32_t k = rotl32(w * cPrime3, 15) * cPrime2;
+        a = rotl32(a ^ k, 13) * 5 + 0xE6546B64u;
+        // Lane B: xxHash32 round.
+        b = rotl32(b + w * cPrime2, 13) * cPrime1;
+    }
+    return (uint64_t(fmix32(a)) << 32) | fmix32(b ^ a);
+}
+
+} // namespace ContentHash
@@ -0,0 +1,89 @@
+#pragma once
+/**
+ * @file HashedResultCache.h
+ * @brief Fixed-size, allocation-free cache mapping a 64-bit content hash to a 64-bit result.
+ *
+ * Each slot is a small seqlock made of 32-bit atomics, so it stays lock-free
+ * on Espresso (no 64-bit atomics) and is safe to use from all three cores.
+ * Lookups never block. Inserts are skipped if another core is writing the
+ * same slot, since losing a cache entry is harmless.
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <std::size_t Capacity>
+class HashedResultCache {
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0,
+        "Capacity must be a power of two.");
+
+public:
+    /// Looks up `key`. On a hit, writes the stored value to `outValue`.
+    bool lookup(uint64_t key, uint64_t& outValue) const {
+        const Slot& slot = mSlots[indexOf(key)];
+
+        const uint32_t seqBefore = slot.seq.load(std::memory_order_acquire);
+        // Zero means never written, odd means a write is in progress.
+        if (seqBefore == 0 || (seqBefore & 1) != 0) {
+            return false;
+        }
+        const uint32_t keyHi   = slot.keyHi.load(std::memory_order_relaxed);
+        const uint32_t keyLo   = slot.keyLo.load(std::memory_order_relaxed);
+        const uint32_t valueHi = slot.valueHi.load(std::memory_order_relaxed);
+        const uint32_t valueLo = slot.valueLo.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) != seqBefore) {
+            return false; // Torn read, treat as a miss.
+        }
+
+        if (keyHi != static_cast<uint32_t>(key >> 32) ||
+            keyLo != static_cast<uint32_t>(key)) {
+            return false;
+        }
+        outValue = (uint64_t(valueHi) << 32) | valueLo;
+        return true;
+    }
+
+    /// Stores `value` for `key`, replacing whatever was in its slot.
+    void insert(uint64_t key, uint64_t value) {
+        Slot& slot = mSlots[indexOf(key)];
+
+        uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+        if ((seq & 1) != 0 ||
+            !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+            return; // Another core is writing this slot.
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.keyHi.store(static_cast<uint32_t>(key >> 32), std::memory_order_relaxed);
+        slot.keyLo.store(static_cast<uint32_t>(key), std::memory_order_relaxed);
+        slot.valueHi.store(static_cast<uint32_t>(value >> 32), std::memory_order_relaxed);
+        slot.valueLo.store(static_cast<uint32_t>(value), std::memory_order_relaxed);
+
+        // Even again, and never zero since seq started at an even number.
+        slot.seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Drops every entry. Only call while no other core is using the cache.
+    void clear() {
+        for (Slot& slot : mSlots) {
+            slot.seq.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> seq{0};
+        std::atomic<uint32_t> keyHi{0};
+        std::atomic<uint32_t> keyLo{0};
+        std::atomic<uint32_t> valueHi{0};
+        std::atomic<uint32_t> valueLo{0};
+    };
+
+    static constexpr std::size_t indexOf(uint64_t key) {
+        // Low bits of the hash pick the slot (direct-mapped).
+        return static_cast<std::size_t>(key) & (Capacity - 1);
+    }
+
+    Slot mSlots[Capacity];
+};
@@ -0,0 +1,176 @@
+#include "HookStats.h"
+
+static const char* const cHookNames[HOOK_STATS_ID_MAX] = {
+#define HOOK_STATS_NAME(name) #name,
+    HOOK_STATS_HOOKS(HOOK_STATS_NAME)
+#undef HOOK_STATS_NAME
+};
+
+const char* getHookStatsName(HookStatsId id) {
+    return cHookNames[id];
+}
+
+#ifdef HOOK_STATS
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdio>
+
+#ifdef __WIIU__
+#include <coreinit/core.h> // OSGetCoreId
+#include <coreinit/time.h>
+#include "logger.h"
+#define HOOK_STATS_LOG(FMT, ARGS...) DEBUG_FUNCTION_LINE_INFO(FMT, ##ARGS)
+#else
+#include <chrono>
+#include <functional>
+#include <thread>
+#define HOOK_STATS_LOG(FMT, ARGS...) printf(FMT "\n", ##ARGS)
+#endif
+
+#ifdef __WIIU__
+/// Espresso's L1 and L2 line size.
+static constexpr std::size_t cCacheLineSize = 32;
+#else
+static constexpr std::size_t cCacheLineSize = 64;
+#endif
+
+/// Only written from one core. Still atomic, since threads on that core can preempt each other.
+struct HookCounters {
+    std::atomic<uint32_t> calls;
+    std::atomic<uint32_t> fallthroughs;
+    std::atomic<uint32_t> buckets[HOOK_STATS_BUCKET_COUNT];
+};
+
+struct alignas(cCacheLineSize) CoreCounters {
+    HookCounters hooks[HOOK_STATS_ID_MAX];
+};
+
+static CoreCounters sCores[HOOK_STATS_CORE_COUNT];
+/// When the counters were last reset, in OSTime (or steady_clock) nanoseconds.
+static uint64_t sResetTime;
+
+// // ---------------------------------------------------------------
+// //  Time and Cores
+// // ---------------------------------------------------------------
+
+/// The low 32 bits of the time base are enough for one call, and cheaper to read.
+static inline uint32_t readTicks() {
+#ifdef __WIIU__
+    return static_cast<uint32_t>(OSGetSystemTick());
+#else
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+}
+
+static uint64_t readTimeNanoseconds() {
+#ifdef __WIIU__
+    return static_cast<uint64_t>(OSTicksToNanoseconds(OSGetSystemTime()));
+#else
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+}
+
+static inline HookCounters& countersFor(HookStatsId id) {
+#ifdef __WIIU__
+    const uint32_t core = OSGetCoreId();
+#else
+    // Spread a PC's threads over the same number of slots.
+    static thread_local const uint32_t core = static_cast<uint32_t>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) % HOOK_STATS_CORE_COUNT);
+#endif
+    return sCores[core].hooks[id];
+}
+
+// // ---------------------------------------------------------------
+// //  Recording
+// // ---------------------------------------------------------------
+
+HookStatsScope::HookStatsScope(HookStatsId id)
+    : mId(id), mStart(readTicks()) {}
+
+HookStatsScope::~HookStatsScope() {
+    const uint32_t elapsed = readTicks() - mStart;
+    const int bucket = std::min(static_cast<int>(std::bit_width(elapsed)), HOOK_STATS_BUCKET_COUNT - 1);
+    HookCounters& counters = countersFor(mId);
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void HookStatsScope::fallThrough() {
+    countersFor(mId).fallthroughs.fetch_add(1, std::memory_order_relaxed);
+}
+
+// // ---------------------------------------------------------------
+// //  Reading
+// // ---------------------------------------------------------------
+
+void resetHookStats() {
+    for (CoreCounters& core : sCores) {
+        for (HookCounters& counters : core.hooks) {
+            counters.calls.store(0, std::memory_order_relaxed);
+            counters.fallthroughs.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint32_t>& bucket : counters.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    sResetTime = readTimeNanoseconds();
+}
+
+HookStatsSnapshot getHookStats(HookStatsId id) {
+    HookStatsSnapshot snapshot{};
+    for (int core = 0; core < HOOK_STATS_CORE_COUNT; core++) {
+        const HookCounters& counters = sCores[core].hooks[id];
+        const uint32_t calls = counters.calls.load(std::memory_order_relaxed);
+        snapshot.coreCalls[core] = calls;
+        snapshot.calls += calls;
+        snapshot.fallthroughs += counters.fallthroughs.load(std::memory_order_relaxed);
+        for (int i = 0; i < HOOK_STATS_BUCKET_COUNT; i++) {
+            snapshot.buckets[i] += counters.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+uint64_t getHookStatsBucketNanoseconds(int bucket) {
+    if (bucket == 0) {
+        return 0;
+    }
+    const uint64_t ticks = uint64_t(1) << (bucket - 1);
+#ifdef __WIIU__
+    return static_cast<uint64_t>(OSTicksToNanoseconds(ticks));
+#else
+    return ticks;
+#endif
+}
+
+void dumpHookStats() {
+    const uint64_t elapsedMs = (readTimeNanoseconds() - sResetTime) / 1000000;
+    HOOK_STATS_LOG("Hook stats over %llu ms:", static_cast<unsigned long long>(elapsedMs));
+    for (int id = 0; id < HOOK_STATS_ID_MAX; id++) {
+        const HookStatsSnapshot stats = getHookStats(static_cast<HookStatsId>(id));
+        if (stats.calls == 0) {
+            continue;
+        }
+        HOOK_STATS_LOG("  %s: %u calls (cores %u/%u/%u), %u fell through",
+            cHookNames[id], stats.calls, stats.coreCalls[0], stats.coreCalls[1], stats.coreCalls[2],
+            stats.fallthroughs);
+
+        // Only the buckets that were hit, as ">=lower bound: count".
+        char histogram[384] = "";
+        size_t length = 0;
+        for (int i = 0; i < HOOK_STATS_BUCKET_COUNT && length < sizeof(histogram); i++) {
+            if (stats.buckets[i] != 0) {
+                const int written = snprintf(histogram + length, sizeof(histogram) - length, " >=%lluns:%u",
+                    static_cast<unsigned long long>(getHookStatsBucketNanoseconds(i)), stats.buckets[i]);
+                length += static_cast<size_t>(written > 0 ? written : 0);
+            }
+        }
+        HOOK_STATS_LOG("   %s", histogram);
+    }
+}
+
+#endif // HOOK_STATS
@@ -0,0 +1,92 @@
+#pragma once
+/**
+ * @file HookStats.h
+ * @brief Call counters and latency histograms for the my_ hooks. Build with HOOK_STATS=1.
+ *
+ * Each hook starts with HOOK_STATS_SCOPE(name), which counts the call and
+ * times it until the hook returns, including any call to real_. Hooks mark
+ * calls they pass on to real_ untouched with HOOK_STATS_FALLTHROUGH().
+ *
+ * Counters are kept per core, each on its own cache line, so hooks running
+ * on all three cores don't contend. Latencies go in log2 buckets of time base
+ * ticks (steady_clock nanoseconds on a PC). Without HOOK_STATS, the macros
+ * are empty and none of this is compiled.
+ */
+
+/// Every hook that can be measured, as X(name) for my_name.
+#define HOOK_STATS_HOOKS(X)                \
+    X(FFLiGetHairColor)                    \
+    X(FFLiGetGlassColor)                   \
+    X(FFLiGetSrgbFetchEyebrowColor)        \
+    X(FFLiGetFacelineColor)                \
+    X(FFLiVerifyCharInfoWithReason)        \
+    X(FFLiMiiDataCore2CharInfo)            \
+    X(FFLiCharInfo2MiiDataCore)            \
+    X(FFLiInitModulateEye)                 \
+    X(FFLiInitModulateMouth)               \
+    X(FFLiResourceLoader_LoadTexture)      \
+    X(FUN_020cdd1c)                        \
+    X(FUN_020d02d8)
+
+/// Also identifies hooks in HookTrace.h, so new hooks go at the end.
+enum HookStatsId
+{
+#define HOOK_STATS_ENUM(name) HOOK_STATS_ID_##name,
+    HOOK_STATS_HOOKS(HOOK_STATS_ENUM)
+#undef HOOK_STATS_ENUM
+    HOOK_STATS_ID_MAX
+};
+
+/// The hook's name without my_, e.g. "FFLiGetHairColor".
+const char* getHookStatsName(HookStatsId id);
+
+#ifdef HOOK_STATS
+
+#include <atomic>
+#include <cstdint>
+
+/// Espresso's cores.
+#define HOOK_STATS_CORE_COUNT 3
+/// Bucket i holds calls that took [2^(i-1), 2^i) ticks. The last one holds anything longer.
+#define HOOK_STATS_BUCKET_COUNT 24
+
+/// Totals over all cores, for dumping and tests.
+struct HookStatsSnapshot
+{
+    uint32_t calls;
+    uint32_t fallthroughs;
+    uint32_t coreCalls[HOOK_STATS_CORE_COUNT];
+    uint32_t buckets[HOOK_STATS_BUCKET_COUNT];
+};
+
+/// Times one hook call. Use HOOK_STATS_SCOPE() rather than this.
+class HookStatsScope {
+public:
+    explicit HookStatsScope(HookStatsId id);
+    ~HookStatsScope();
+    void fallThrough();
+
+private:
+    HookStatsId mId;
+    uint32_t mStart;
+};
+
+#define HOOK_STATS_SCOPE(name)   HookStatsScope hookStatsScope_(HOOK_STATS_ID_##name)
+#define HOOK_STATS_FALLTHROUGH() hookStatsScope_.fallThrough()
+
+/// Clears all counters, e.g. when a title starts.
+void resetHookStats();
+HookStatsSnapshot getHookStats(HookStatsId id);
+/// Lower bound of a bucket, in nanoseconds.
+uint64_t getHookStatsBucketNanoseconds(int bucket);
+/// Logs every hook that was called since the last reset.
+/// Slow, so don't call it from the FFL hooks. The plugin calls it when a title
+/// ends, and from VPADRead when L + R + Minus are pressed.
+void dumpHookStats();
+
+#else
+
+#define HOOK_STATS_SCOPE(name)   do {} while (0)
+#define HOOK_STATS_FALLTHROUGH() do {} while (0)
+
+#endif // HOOK_STATS
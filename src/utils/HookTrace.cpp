@@ -0,0 +1,244 @@
+#include "HookTrace.h"
+#include <cstring>
+
+static constexpr uint32_t alignUp4(uint32_t size) {
+    return (size + 3) & ~3u;
+}
+
+// // ---------------------------------------------------------------
+// //  Parsing
+// // ---------------------------------------------------------------
+
+bool parseHookTrace(const std::vector<uint8_t>& file, std::vector<HookTraceEvent>& outEvents, bool& outSwapped) {
+    outEvents.clear();
+    HookTraceHeader header;
+    if (file.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, file.data(), sizeof(header));
+    if (header.byteOrderMark == HOOK_TRACE_BYTE_ORDER_MARK) {
+        outSwapped = false;
+    } else if (__builtin_bswap32(header.byteOrderMark) == HOOK_TRACE_BYTE_ORDER_MARK) {
+        outSwapped = true;
+    } else {
+        return false;
+    }
+    const bool swapped = outSwapped;
+    const auto load32 = [swapped](uint32_t value) { return swapped ? __builtin_bswap32(value) : value; };
+    const auto load16 = [swapped](uint16_t value) { return swapped ? __builtin_bswap16(value) : value; };
+
+    const uint32_t hookCount = load32(header.hookCount);
+    const uint32_t recordCount = load32(header.recordCount);
+    const uint32_t dataSize = load32(header.dataSize);
+    if (load32(header.magic) != HOOK_TRACE_MAGIC || load32(header.version) != HOOK_TRACE_VERSION ||
+        dataSize > file.size() - sizeof(header)) {
+        return false;
+    }
+
+    const uint8_t* data = file.data() + sizeof(header);
+    size_t pos = 0;
+    outEvents.reserve(recordCount);
+    for (uint32_t i = 0; i < recordCount; i++) {
+        HookTraceRecord record;
+        if (dataSize - pos < sizeof(record)) {
+            return false;
+        }
+        memcpy(&record, data + pos, sizeof(record));
+        pos += sizeof(record);
+
+        HookTraceEvent event;
+        event.ticks = load32(record.ticks);
+        event.argCount = record.argCount;
+        event.payloadSize = load16(record.payloadSize);
+        if (record.hook >= hookCount || record.hook >= HOOK_STATS_ID_MAX ||
+            event.argCount > HOOK_TRACE_MAX_ARGS || dataSize - pos < alignUp4(event.payloadSize)) {
+            return false;
+        }
+        event.hook = static_cast<HookStatsId>(record.hook);
+        for (uint32_t a = 0; a < HOOK_TRACE_MAX_ARGS; a++) {
+            event.args[a] = load32(record.args[a]);
+        }
+        event.payload = event.payloadSize != 0 ? data + pos : nullptr;
+        pos += alignUp4(event.payloadSize);
+        outEvents.push_back(event);
+    }
+    return true;
+}
+
+// // ---------------------------------------------------------------
+// //  Capture
+// // ---------------------------------------------------------------
+
+#ifdef HOOK_TRACE
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef __WIIU__
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include "logger.h"
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+alignas(4) static uint8_t sTraceBuffer[HOOK_TRACE_BUFFER_SIZE];
+/// Bytes reserved by hooks. Can pass the end of the buffer once it's full.
+static std::atomic<uint32_t> sTraceUsed{0};
+/// Offset of the first reservation that didn't fit. Everything before it is complete.
+static std::atomic<uint32_t> sTraceEnd{HOOK_TRACE_BUFFER_SIZE};
+static std::atomic<uint32_t> sTraceRecords{0};
+static std::atomic<uint32_t> sTraceDropped{0};
+
+static inline uint32_t readTicks() {
+#ifdef __WIIU__
+    return static_cast<uint32_t>(OSGetSystemTick());
+#else
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+}
+
+void recordHookCall(HookStatsId hook, const void* payload, uint16_t payloadSize,
+    const uint32_t* args, uint32_t argCount) {
+    // Once full, stop adding to sTraceUsed, so it can't wrap around.
+    if (sTraceUsed.load(std::memory_order_relaxed) >= HOOK_TRACE_BUFFER_SIZE) {
+        sTraceDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const uint32_t size = sizeof(HookTraceRecord) + alignUp4(payloadSize);
+    const uint32_t offset = sTraceUsed.fetch_add(size, std::memory_order_relaxed);
+    if (offset > HOOK_TRACE_BUFFER_SIZE - size) {
+        uint32_t end = sTraceEnd.load(std::memory_order_relaxed);
+        while (offset < end && !sTraceEnd.compare_exchange_weak(end, offset, std::memory_order_relaxed)) {}
+        sTraceDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    HookTraceRecord record{};
+    record.hook = static_cast<uint8_t>(hook);
+    record.argCount = static_cast<uint8_t>(argCount);
+    record.payloadSize = payloadSize;
+    record.ticks = readTicks();
+    memcpy(record.args, args, argCount * sizeof(uint32_t));
+    uint8_t* out = sTraceBuffer + offset;
+    memcpy(out, &record, sizeof(record));
+    if (payloadSize != 0) {
+        memcpy(out + sizeof(record), payload, payloadSize);
+        memset(out + sizeof(record) + payloadSize, 0, alignUp4(payloadSize) - payloadSize);
+    }
+    sTraceRecords.fetch_add(1, std::memory_order_relaxed);
+}
+
+void resetHookTrace() {
+    sTraceUsed.store(0, std::memory_order_relaxed);
+    sTraceEnd.store(HOOK_TRACE_BUFFER_SIZE, std::memory_order_relaxed);
+    sTraceRecords.store(0, std::memory_order_relaxed);
+    sTraceDropped.store(0, std::memory_order_relaxed);
+}
+
+/// Only consistent when no hooks are running: dataSize covers every
+/// reservation, and recordCount only the records that were finished.
+static HookTraceHeader makeHookTraceHeader() {
+    uint32_t dataSize = sTraceUsed.load(std::memory_order_acquire);
+    if (dataSize > sTraceEnd.load(std::memory_order_relaxed)) {
+        dataSize = sTraceEnd.load(std::memory_order_relaxed);
+    }
+
+    HookTraceHeader header{};
+    header.magic = HOOK_TRACE_MAGIC;
+    header.version = HOOK_TRACE_VERSION;
+    header.byteOrderMark = HOOK_TRACE_BYTE_ORDER_MARK;
+    header.hookCount = HOOK_STATS_ID_MAX;
+    header.recordCount = sTraceRecords.load(std::memory_order_relaxed);
+    header.dataSize = dataSize;
+    header.dropped = sTraceDropped.load(std::memory_order_relaxed);
+    return header;
+}
+
+/// Copies `size` bytes at `offset` in the trace file: `header`, then the records in sTraceBuffer.
+static void readHookTrace(const HookTraceHeader& header, size_t offset, uint8_t* out, size_t size) {
+    if (offset < sizeof(header)) {
+        const size_t headerPart = std::min(size, sizeof(header) - offset);
+        memcpy(out, reinterpret_cast<const uint8_t*>(&header) + offset, headerPart);
+        out += headerPart;
+        offset += headerPart;
+        size -= headerPart;
+    }
+    memcpy(out, sTraceBuffer + (offset - sizeof(header)), size);
+}
+
+std::vector<uint8_t> buildHookTrace() {
+    const HookTraceHeader header = makeHookTraceHeader();
+    std::vector<uint8_t> file(sizeof(header) + header.dataSize);
+    readHookTrace(header, 0, file.data(), file.size());
+    return file;
+}
+
+#ifdef HOOK_TRACE_UDP
+/// Broadcasts the trace in HOOK_TRACE_UDP_CHUNK pieces. The receiver puts them back together by offset.
+static bool sendHookTrace(const HookTraceHeader& header) {
+    const int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        return false;
+    }
+    const int broadcast = 1;
+    setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &broadcast, sizeof(broadcast));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(HOOK_TRACE_UDP_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_BROADCAST);
+
+    const size_t fileSize = sizeof(header) + header.dataSize;
+    uint8_t datagram[sizeof(HookTraceDatagram) + HOOK_TRACE_UDP_CHUNK];
+    bool ok = true;
+    for (size_t offset = 0; offset < fileSize && ok; offset += HOOK_TRACE_UDP_CHUNK) {
+        const size_t chunk = std::min<size_t>(HOOK_TRACE_UDP_CHUNK, fileSize - offset);
+        const HookTraceDatagram prefix = { HOOK_TRACE_MAGIC, static_cast<uint32_t>(offset), static_cast<uint32_t>(fileSize) };
+        memcpy(datagram, &prefix, sizeof(prefix));
+        readHookTrace(header, offset, datagram + sizeof(prefix), chunk);
+        ok = sendto(sock, datagram, sizeof(prefix) + chunk, 0,
+            reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) >= 0;
+        // Don't outrun the receiver.
+#ifdef __WIIU__
+        OSSleepTicks(OSMillisecondsToTicks(1));
+#else
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+    }
+    close(sock);
+    return ok;
+}
+#endif
+
+void saveHookTrace() {
+    // Written straight from the capture buffer, which is too big to copy.
+    const HookTraceHeader header = makeHookTraceHeader();
+#ifdef HOOK_TRACE_UDP
+    const bool ok = sendHookTrace(header);
+#else
+    FILE* f = fopen(HOOK_TRACE_PATH, "wb");
+    const bool ok = f != nullptr && fwrite(&header, sizeof(header), 1, f) == 1 &&
+        fwrite(sTraceBuffer, 1, header.dataSize, f) == header.dataSize;
+    if (f != nullptr) {
+        fclose(f);
+    }
+#endif
+#ifdef __WIIU__
+    if (ok) {
+        DEBUG_FUNCTION_LINE_INFO("Saved hook trace: %u calls, %u bytes, %u dropped",
+            header.recordCount, static_cast<unsigned>(sizeof(header) + header.dataSize), header.dropped);
+    } else {
+        DEBUG_FUNCTION_LINE_ERR("Failed to save the hook trace");
+    }
+#else
+    (void)ok;
+#endif
+}
+
+#endif // HOOK_TRACE
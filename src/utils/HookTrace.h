@@ -0,0 +1,126 @@
+#pragma once
+/**
+ * @file HookTrace.h
+ * @brief Records hook calls into a binary trace, to replay them on a PC. Build with HOOK_TRACE=1.
+ *
+ * Hooks record their scalar arguments with HOOK_TRACE_CALL(), and the
+ * decode/encode hooks also copy the Mii data they were given. Records go into
+ * a fixed buffer with one atomic add each, and the whole trace is written out
+ * when the title ends: to HOOK_TRACE_PATH, or with HOOK_TRACE=udp, broadcast
+ * to HOOK_TRACE_UDP_PORT. tests/HookTraceReplay reads either one and feeds
+ * the calls through the my_ hooks again.
+ *
+ * The file format and parser are always compiled, so host tools can use them.
+ */
+#include "HookStats.h" // HookStatsId
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// // ---------------------------------------------------------------
+// //  File Format
+// // ---------------------------------------------------------------
+// Everything is in the byte order of the console that wrote it, see byteOrderMark.
+
+/// "FFHT"
+#define HOOK_TRACE_MAGIC 0x46464854u
+#define HOOK_TRACE_VERSION 1
+/// Written as a native uint32_t, so a reader can tell if it needs to swap.
+#define HOOK_TRACE_BYTE_ORDER_MARK 0x01020304u
+#define HOOK_TRACE_MAX_ARGS 4
+
+struct HookTraceHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t hookCount;   ///< HOOK_STATS_ID_MAX of the writer.
+    uint32_t recordCount;
+    uint32_t dataSize;    ///< Bytes of records after the header.
+    uint32_t dropped;     ///< Calls not recorded because the buffer was full.
+    uint32_t reserved;
+};
+static_assert(sizeof(HookTraceHeader) == 0x20);
+
+/// Followed by `payloadSize` bytes of payload, padded to 4 bytes.
+struct HookTraceRecord
+{
+    uint8_t  hook;        ///< HookStatsId
+    uint8_t  argCount;
+    uint16_t payloadSize;
+    uint32_t ticks;       ///< Time base (low 32 bits) when the hook was called.
+    uint32_t args[HOOK_TRACE_MAX_ARGS];
+};
+static_assert(sizeof(HookTraceRecord) == 0x18);
+
+#define HOOK_TRACE_UDP_PORT 4406
+/// Each datagram is a HookTraceDatagram and up to this many bytes of the file.
+#define HOOK_TRACE_UDP_CHUNK 1024
+
+/// Prefix of each UDP datagram, in the writer's byte order.
+struct HookTraceDatagram
+{
+    uint32_t magic;     ///< HOOK_TRACE_MAGIC
+    uint32_t offset;    ///< Of this chunk in the file.
+    uint32_t totalSize; ///< Of the whole file.
+};
+
+/// One call read back from a trace, in the reader's byte order (except the payload).
+struct HookTraceEvent
+{
+    HookStatsId hook;
+    uint32_t ticks;
+    uint32_t argCount;
+    uint32_t args[HOOK_TRACE_MAX_ARGS];
+    const uint8_t* payload; ///< Into the trace file. Still in the writer's byte order.
+    uint16_t payloadSize;
+};
+
+/// Reads every record in a trace file.
+/// @param[out] outSwapped Whether the writer's byte order differs from this one.
+/// @return False if the header is wrong or a record runs past the end.
+bool parseHookTrace(const std::vector<uint8_t>& file, std::vector<HookTraceEvent>& outEvents, bool& outSwapped);
+
+// // ---------------------------------------------------------------
+// //  Capture
+// // ---------------------------------------------------------------
+
+#ifdef HOOK_TRACE
+
+#define HOOK_TRACE_PATH "fs:/vol/external01/wiiu/ffl_hook_trace.bin"
+/// Size of the capture buffer. Calls past this are counted as dropped.
+#define HOOK_TRACE_BUFFER_SIZE (2 * 1024 * 1024)
+
+void recordHookCall(HookStatsId hook, const void* payload, uint16_t payloadSize,
+    const uint32_t* args, uint32_t argCount);
+
+/// Converts each argument to uint32_t. Use HOOK_TRACE_CALL() rather than this.
+template <typename... Args>
+inline void traceHookCall(HookStatsId hook, const void* payload, uint16_t payloadSize, Args... args) {
+    static_assert(sizeof...(Args) <= HOOK_TRACE_MAX_ARGS);
+    const uint32_t values[sizeof...(Args) + 1] = { static_cast<uint32_t>(args)..., 0 };
+    recordHookCall(hook, payload, payloadSize, values, sizeof...(Args));
+}
+
+#define HOOK_TRACE_CALL(name, ARGS...) \
+    traceHookCall(HOOK_STATS_ID_##name, nullptr, 0, ##ARGS)
+/// Also copies `size` bytes at `payload`, e.g. the Mii data a hook was given.
+#define HOOK_TRACE_CALL_WITH(name, payload, size, ARGS...) \
+    traceHookCall(HOOK_STATS_ID_##name, payload, size, ##ARGS)
+
+/// Empties the capture buffer, e.g. when a title starts.
+void resetHookTrace();
+/// Copies the capture buffer into a trace file, for tests. Hooks must not be running.
+std::vector<uint8_t> buildHookTrace();
+/// Writes the trace to HOOK_TRACE_PATH, or sends it over UDP with HOOK_TRACE_UDP.
+/// Hooks must not be running: a record is counted once it's written, but its
+/// space is reserved before, so a hook still writing one would be saved half
+/// done. The plugin only calls this from ON_APPLICATION_ENDS.
+void saveHookTrace();
+
+#else
+
+#define HOOK_TRACE_CALL(name, ARGS...)                     do {} while (0)
+#define HOOK_TRACE_CALL_WITH(name, payload, size, ARGS...) do {} while (0)
+
+#endif // HOOK_TRACE
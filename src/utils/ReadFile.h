@@ -0,0 +1,29 @@
+#pragma once
+/**
+ * @file ReadFile.h
+ * @brief Reads a whole file into memory, in a single read.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/// @return False if the file can't be opened or read, or is empty.
+inline bool readWholeFile(const char* path, std::vector<uint8_t>& out) {
+    out.clear();
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    long size = -1;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        size = ftell(f);
+    }
+    if (size > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        out.resize(static_cast<size_t>(size));
+        if (fread(out.data(), 1, out.size(), f) != out.size()) {
+            out.clear();
+        }
+    }
+    fclose(f);
+    return !out.empty();
+}
@@ -1,11 +1,17 @@
 /**
  * @file base64enc.h
- * @brief Simple Base64 encoder utility.
+ * @brief Base64 and hex encoders/decoders.
  *
- * When calling base64_encode, you must allocate the
- * output buffer yourself. The size can be calculated
- * using BASE64_ENCODED_SIZE(strlen("string")).
+ * When calling the encoders and decoders, you must allocate the
+ * output buffer yourself. The sizes can be calculated using
+ * BASE64_ENCODED_SIZE(), BASE64_DECODED_SIZE(), HEX_ENCODED_SIZE()
+ * and HEX_DECODED_SIZE().
+ *
+ * All of these work on whole buffers. The main loops only do table
+ * lookups, with invalid input characters collected in one flag that
+ * is checked at the end instead of branching on every character.
  */
+#pragma once
 
 #include <stddef.h>
 
@@ -18,50 +24,183 @@
  */
 #define BASE64_ENCODED_SIZE(n) ((((n) + 2) / 3) * 4 + 1)
 
+/**
+ * @brief Calculates the maximum decoded length for a given number of Base64 characters.
+ * @param n Number of input characters.
+ * @return Maximum required output size in bytes.
+ */
+#define BASE64_DECODED_SIZE(n) (((n) / 4) * 3)
+
+/// Hex encoded length for a given number of bytes, plus 1 for the null terminator.
+#define HEX_ENCODED_SIZE(n) ((n) * 2 + 1)
+/// Decoded length for a given number of hex characters.
+#define HEX_DECODED_SIZE(n) ((n) / 2)
+
+static const char cBase64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789+/";
+
+static const char cHexDigits[] = "0123456789abcdef";
+
+/// Value of each Base64 character, or 0x80 if it isn't one. '=' is handled separately.
+static const unsigned char cBase64Values[256] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3E, 0x80, 0x80, 0x80, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
+
+/// Value of each hex digit (either case), or 0x80 if it isn't one.
+static const unsigned char cHexValues[256] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
+
 /**
  * @brief Encodes a binary buffer into Base64 text.
  * @param input Pointer to raw input bytes.
  * @param len Number of bytes in input.
  * @param output Pointer to destination buffer (must be at least BASE64_ENCODED_SIZE(len)).
  */
-static void base64_encode(const unsigned char* input, size_t len, char* output) {
-    static const char cBase64Alphabet[] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
-
+static inline void base64_encode(const unsigned char* input, size_t len, char* output) {
+    const size_t whole = len - len % 3;
     size_t outIndex = 0;
-    size_t i = 0;
 
-    while (i + 2 < len) {
+    for (size_t i = 0; i < whole; i += 3) {
         // Take 3 bytes and split into 4 groups of 6 bits.
-        int triple = (input[i] << 16) | (input[i + 1] << 8) | input[i + 2];
-        output[outIndex++] = cBase64Alphabet[(triple >> 18) & 0x3F];
-        output[outIndex++] = cBase64Alphabet[(triple >> 12) & 0x3F];
-        output[outIndex++] = cBase64Alphabet[(triple >> 6)  & 0x3F];
-        output[outIndex++] = cBase64Alphabet[triple & 0x3F];
-        i += 3;
+        const unsigned long triple = ((unsigned long)input[i] << 16) | ((unsigned long)input[i + 1] << 8) | input[i + 2];
+        output[outIndex + 0] = cBase64Alphabet[(triple >> 18) & 0x3F];
+        output[outIndex + 1] = cBase64Alphabet[(triple >> 12) & 0x3F];
+        output[outIndex + 2] = cBase64Alphabet[(triple >> 6)  & 0x3F];
+        output[outIndex + 3] = cBase64Alphabet[triple & 0x3F];
+        outIndex += 4;
     }
 
     // Handle remaining 1 or 2 bytes with padding.
-    if (i < len) {
-        int triple = input[i] << 16;
-        if (i + 1 < len) {
-            triple |= input[i + 1] << 8;
-        }
-
+    if (whole < len) {
+        const int two = whole + 1 < len;
+        const unsigned long triple = ((unsigned long)input[whole] << 16) |
+                                     (two ? (unsigned long)input[whole + 1] << 8 : 0);
         output[outIndex++] = cBase64Alphabet[(triple >> 18) & 0x3F];
         output[outIndex++] = cBase64Alphabet[(triple >> 12) & 0x3F];
-
-        if (i + 1 < len) {
-            output[outIndex++] = cBase64Alphabet[(triple >> 6) & 0x3F];
-            output[outIndex++] = '=';
-        } else {
-            output[outIndex++] = '=';
-            output[outIndex++] = '=';
-        }
+        output[outIndex++] = two ? cBase64Alphabet[(triple >> 6) & 0x3F] : '=';
+        output[outIndex++] = '=';
     }
 
     // Null terminate.
     output[outIndex] = '\0';
 }
+
+/**
+ * @brief Decodes Base64 text into a binary buffer.
+ * @param input Pointer to Base64 characters. Does not need to be null terminated.
+ * @param len Number of characters in input. Must be a multiple of 4.
+ * @param output Pointer to destination buffer (must be at least BASE64_DECODED_SIZE(len)).
+ * @return Number of bytes written, or -1 if the input is not valid Base64.
+ */
+static inline long base64_decode(const char* input, size_t len, unsigned char* output) {
+    if (len % 4 != 0) {
+        return -1;
+    }
+    if (len == 0) {
+        return 0;
+    }
+
+    const unsigned char* in = (const unsigned char*)input;
+    // Only the last quad may have padding.
+    const size_t padding = in[len - 1] == '=' ? 1 + (in[len - 2] == '=') : 0;
+    const size_t whole = len - 4;
+    unsigned int invalid = 0;
+    size_t outIndex = 0;
+
+    for (size_t i = 0; i < whole; i += 4) {
+        const unsigned int a = cBase64Values[in[i]], b = cBase64Values[in[i + 1]];
+        const unsigned int c = cBase64Values[in[i + 2]], d = cBase64Values[in[i + 3]];
+        invalid |= a | b | c | d;
+        const unsigned long triple = ((unsigned long)a << 18) | ((unsigned long)b << 12) | (c << 6) | d;
+        output[outIndex + 0] = (unsigned char)(triple >> 16);
+        output[outIndex + 1] = (unsigned char)(triple >> 8);
+        output[outIndex + 2] = (unsigned char)triple;
+        outIndex += 3;
+    }
+
+    // Last quad: padding characters count as zero.
+    unsigned int last[4];
+    for (size_t j = 0; j < 4; ++j) {
+        const int isPadding = j >= 4 - padding;
+        last[j] = isPadding ? 0 : cBase64Values[in[whole + j]];
+        invalid |= last[j];
+    }
+    if ((invalid & 0x80) != 0) {
+        return -1;
+    }
+    const unsigned long triple = ((unsigned long)last[0] << 18) | ((unsigned long)last[1] << 12) | (last[2] << 6) | last[3];
+    output[outIndex++] = (unsigned char)(triple >> 16);
+    if (padding < 2) {
+        output[outIndex++] = (unsigned char)(triple >> 8);
+    }
+    if (padding < 1) {
+        output[outIndex++] = (unsigned char)triple;
+    }
+    return (long)outIndex;
+}
+
+/**
+ * @brief Encodes a binary buffer into lowercase hex.
+ * @param output Pointer to destination buffer (must be at least HEX_ENCODED_SIZE(len)).
+ */
+static inline void hex_encode(const unsigned char* input, size_t len, char* output) {
+    for (size_t i = 0; i < len; ++i) {
+        output[i * 2]     = cHexDigits[input[i] >> 4];
+        output[i * 2 + 1] = cHexDigits[input[i] & 0xF];
+    }
+    output[len * 2] = '\0';
+}
+
+/**
+ * @brief Decodes hex (either case) into a binary buffer.
+ * @param len Number of characters in input. Must be even.
+ * @param output Pointer to destination buffer (must be at least HEX_DECODED_SIZE(len)).
+ * @return Number of bytes written, or -1 if the input is not valid hex.
+ */
+static inline long hex_decode(const char* input, size_t len, unsigned char* output) {
+    if (len % 2 != 0) {
+        return -1;
+    }
+    const unsigned char* in = (const unsigned char*)input;
+    unsigned int invalid = 0;
+    for (size_t i = 0; i < len / 2; ++i) {
+        const unsigned int hi = cHexValues[in[i * 2]];
+        const unsigned int lo = cHexValues[in[i * 2 + 1]];
+        invalid |= hi | lo;
+        output[i] = (unsigned char)((hi << 4) | (lo & 0xF));
+    }
+    return (invalid & 0x80) != 0 ? -1 : (long)(len / 2);
+}
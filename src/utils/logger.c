@@ -1,5 +1,24 @@
-#ifdef DEBUG
+#include "logger.h"
+#include <stdarg.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include <notifications/notifications.h>
+
+/// How often the flusher wakes up to write records and post notifications.
+#define LOG_FLUSH_INTERVAL_MS 10
+
+#ifdef DEBUG
+/// Lines written by the flusher.
+#define FLUSHER_PRINTF(FMT, ARGS...) WHBLogPrintf(FMT, ##ARGS)
+#else
+#define FLUSHER_PRINTF(FMT, ARGS...) OSReport(FMT "\n", ##ARGS)
+#endif
+
+#ifdef DEBUG
+#include <stdatomic.h>
 #include <whb/log_cafe.h>
 #include <whb/log_module.h>
 #include <whb/log_udp.h>
@@ -7,18 +26,259 @@
 BOOL moduleLogInit = false;
 BOOL cafeLogInit   = false;
 BOOL udpLogInit    = false;
+
+// // ---------------------------------------------------------------
+// //  Deferred Log
+// // ---------------------------------------------------------------
+// A bounded multi-producer queue (Vyukov's), with one consumer: the flusher thread.
+// Each record has a sequence number saying whose turn it is. Producers claim a
+// position with one CAS, fill in the record, then publish it by bumping its sequence.
+
+/// Records in the ring. A power of two.
+#define LOG_RING_SIZE 256
+
+typedef struct {
+    /// Equal to the position when free for a producer, position + 1 when ready to flush.
+    _Atomic uint32_t sequence;
+    int line;
+    int argCount;
+    const char *level;
+    const char *file;
+    const char *function;
+    const char *format;
+    uintptr_t args[LOG_DEFERRED_MAX_ARGS];
+} LogRecord;
+
+static LogRecord sLogRing[LOG_RING_SIZE];
+/// Next position for producers to claim.
+static _Atomic uint32_t sLogRingHead;
+/// Next position to flush. Only touched by the flusher (or deinitLogging() once it's stopped).
+static uint32_t sLogRingTail;
+/// Records dropped because the ring was full, reported by the flusher.
+static _Atomic uint32_t sLogRingDropped;
+
+static void initLogRing() {
+    // The ring is always empty once the flusher stops, so this only has to happen once.
+    static bool sInitialized = false;
+    if (sInitialized) {
+        return;
+    }
+    sInitialized = true;
+    for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+        atomic_store_explicit(&sLogRing[i].sequence, i, memory_order_relaxed);
+    }
+}
+
+void logDeferred(const char *level, const char *file, const char *function, int line, const char *format, int argCount, ...) {
+    uint32_t pos = atomic_load_explicit(&sLogRingHead, memory_order_relaxed);
+    LogRecord *record;
+    for (;;) {
+        record            = &sLogRing[pos & (LOG_RING_SIZE - 1)];
+        const int32_t lag = (int32_t) (atomic_load_explicit(&record->sequence, memory_order_acquire) - pos);
+        if (lag == 0) {
+            if (atomic_compare_exchange_weak_explicit(&sLogRingHead, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // The flusher hasn't caught up with the record a lap behind.
+            atomic_fetch_add_explicit(&sLogRingDropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&sLogRingHead, memory_order_relaxed);
+        }
+    }
+
+    record->line     = line;
+    record->argCount = argCount;
+    record->level    = level;
+    record->file     = file;
+    record->function = function;
+    record->format   = format;
+    va_list args;
+    va_start(args, argCount);
+    for (int i = 0; i < argCount; i++) {
+        record->args[i] = va_arg(args, uintptr_t);
+    }
+    va_end(args);
+    atomic_store_explicit(&record->sequence, pos + 1, memory_order_release);
+}
+
+static void writeLogRecord(const LogRecord *record) {
+    const uintptr_t *a = record->args;
+    char message[256];
+    // Extra arguments are ignored by snprintf, so every record can pass all of them.
+    snprintf(message, sizeof(message), record->format, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+
+    const char *fileName = strrchr(record->file, '/');
+    fileName             = fileName ? fileName + 1 : record->file;
+    WHBLogPrintf("[(%s)%18s][%23s]%30s@L%04d: %s%s", LOG_APP_TYPE, LOG_APP_NAME,
+                 fileName, record->function, record->line, record->level, message);
+}
+
+/// Writes every record that's ready. Only one thread may call this at a time.
+static void flushLogRing() {
+    for (;;) {
+        LogRecord *record = &sLogRing[sLogRingTail & (LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&record->sequence, memory_order_acquire) != sLogRingTail + 1) {
+            break;
+        }
+        writeLogRecord(record);
+        // Free it for the producer one lap ahead.
+        atomic_store_explicit(&record->sequence, sLogRingTail + LOG_RING_SIZE, memory_order_release);
+        sLogRingTail++;
+    }
+
+    const uint32_t dropped = atomic_exchange_explicit(&sLogRingDropped, 0, memory_order_relaxed);
+    if (dropped != 0) {
+        WHBLogPrintf("[(%s)%18s] ##WARN ## Dropped %u log records, the ring was full", LOG_APP_TYPE, LOG_APP_NAME, dropped);
+    }
+}
+
 #endif // DEBUG
 
+// // ---------------------------------------------------------------
+// //  Deferred Notifications
+// // ---------------------------------------------------------------
+// Posted by the flusher in every build, since NotificationModule calls are too
+// slow for the game's threads. There are few, so producers just take the first
+// free slot, and they may be posted out of order. Slots use the __atomic
+// builtins rather than stdatomic.h, so this also builds as C++ on a PC.
+
+/// Notifications waiting to be posted.
+#define NOTIFY_QUEUE_SIZE 8
+
+enum {
+    NOTIFY_SLOT_FREE,
+    NOTIFY_SLOT_WRITING,
+    NOTIFY_SLOT_READY
+};
+
+typedef struct {
+    uint32_t state;
+    int line;
+    int argCount;
+    const char *file;
+    const char *function;
+    const char *format;
+    uintptr_t args[LOG_DEFERRED_MAX_ARGS];
+} NotifyRecord;
+
+static NotifyRecord sNotifyQueue[NOTIFY_QUEUE_SIZE];
+/// Notifications dropped because every slot was taken, reported by the flusher.
+static uint32_t sNotifyDropped;
+
+void notifyDeferred(const char *file, const char *function, int line, const char *format, int argCount, ...) {
+    for (int i = 0; i < NOTIFY_QUEUE_SIZE; i++) {
+        NotifyRecord *record = &sNotifyQueue[i];
+        uint32_t expected    = NOTIFY_SLOT_FREE;
+        if (!__atomic_compare_exchange_n(&record->state, &expected, NOTIFY_SLOT_WRITING, false,
+                                         __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            continue;
+        }
+        record->line     = line;
+        record->argCount = argCount;
+        record->file     = file;
+        record->function = function;
+        record->format   = format;
+        va_list args;
+        va_start(args, argCount);
+        for (int a = 0; a < argCount; a++) {
+            record->args[a] = va_arg(args, uintptr_t);
+        }
+        va_end(args);
+        __atomic_store_n(&record->state, NOTIFY_SLOT_READY, __ATOMIC_RELEASE);
+        return;
+    }
+    __atomic_fetch_add(&sNotifyDropped, 1, __ATOMIC_RELAXED);
+}
+
+/// Logs and posts every notification that's ready. Only the flusher calls this.
+static void postNotifications() {
+    for (int i = 0; i < NOTIFY_QUEUE_SIZE; i++) {
+        NotifyRecord *record = &sNotifyQueue[i];
+        if (__atomic_load_n(&record->state, __ATOMIC_ACQUIRE) != NOTIFY_SLOT_READY) {
+            continue;
+        }
+        const uintptr_t *a = record->args;
+        char message[256];
+        snprintf(message, sizeof(message), record->format, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+        __atomic_store_n(&record->state, NOTIFY_SLOT_FREE, __ATOMIC_RELEASE);
+
+        const char *fileName = strrchr(record->file, '/');
+        fileName             = fileName ? fileName + 1 : record->file;
+        FLUSHER_PRINTF("[(%s)%18s][%23s]%30s@L%04d: ##ERROR## %s", LOG_APP_TYPE, LOG_APP_NAME,
+                       fileName, record->function, record->line, message);
+        NotificationModule_AddErrorNotification(message);
+    }
+
+    const uint32_t dropped = __atomic_exchange_n(&sNotifyDropped, 0, __ATOMIC_RELAXED);
+    if (dropped != 0) {
+        FLUSHER_PRINTF("[(%s)%18s] ##WARN ## Dropped %u notifications, the queue was full", LOG_APP_TYPE, LOG_APP_NAME, dropped);
+    }
+}
+
+// // ---------------------------------------------------------------
+// //  Flusher Thread
+// // ---------------------------------------------------------------
+
+static OSThread sFlushThread __attribute__((aligned(16)));
+static uint8_t sFlushThreadStack[0x4000] __attribute__((aligned(16)));
+static bool sFlushThreadRunning;
+
+static int flushThreadMain(int argc, const char **argv) {
+    (void) argc;
+    (void) argv;
+    while (__atomic_load_n(&sFlushThreadRunning, __ATOMIC_RELAXED)) {
+#ifdef DEBUG
+        flushLogRing();
+#endif
+        postNotifications();
+        OSSleepTicks(OSMillisecondsToTicks(LOG_FLUSH_INTERVAL_MS));
+    }
+    return 0;
+}
+
+static void startFlushThread() {
+    // initLogging() is called by both INITIALIZE_PLUGIN and ON_APPLICATION_START.
+    if (__atomic_exchange_n(&sFlushThreadRunning, true, __ATOMIC_RELAXED)) {
+        return;
+    }
+    // Lowest priority, so it never competes with the game's threads.
+    if (!OSCreateThread(&sFlushThread, flushThreadMain, 0, NULL,
+                        sFlushThreadStack + sizeof(sFlushThreadStack), sizeof(sFlushThreadStack),
+                        31, OS_THREAD_ATTRIB_AFFINITY_ANY)) {
+        __atomic_store_n(&sFlushThreadRunning, false, __ATOMIC_RELAXED);
+        return;
+    }
+    OSSetThreadName(&sFlushThread, "FFL patcher log flusher");
+    OSResumeThread(&sFlushThread);
+}
+
+static void stopFlushThread() {
+    if (!__atomic_exchange_n(&sFlushThreadRunning, false, __ATOMIC_RELAXED)) {
+        return;
+    }
+    OSJoinThread(&sFlushThread, NULL);
+    // Anything logged after its last pass.
+#ifdef DEBUG
+    flushLogRing();
+#endif
+    postNotifications();
+}
+
 void initLogging() {
 #ifdef DEBUG
     if (!(moduleLogInit = WHBLogModuleInit())) {
         cafeLogInit = WHBLogCafeInit();
         udpLogInit  = WHBLogUdpInit();
     }
+    initLogRing();
 #endif // DEBUG
+    startFlushThread();
 }
 
 void deinitLogging() {
+    stopFlushThread();
 #ifdef DEBUG
     if (moduleLogInit) {
         WHBLogModuleDeinit();
@@ -33,4 +293,4 @@ void deinitLogging() {
         udpLogInit = false;
     }
 #endif // DEBUG
-}
\ No newline at end of file
+}
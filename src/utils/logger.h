@@ -47,6 +47,24 @@ extern "C" {
 
 #define DEBUG_FUNCTION_LINE_ERR_LAMBDA(FILENAME, FUNCTION, LINE, FMT, ARGS...) LOG_EX(FILENAME, FUNCTION, LINE, WHBLogPrintf, "##ERROR## ", "", FMT, ##ARGS);
 
+// Deferred logging, for hooks on the game's own threads. A call only copies
+// its arguments into a ring buffer, and a background thread formats and
+// writes them later. Arguments must be integers or pointers of at most 32 bits
+// (no floats or 64-bit values), at most LOG_DEFERRED_MAX_ARGS of them, and
+// strings for %s must outlive the call (literals, or tables like FFLiVerifyReasonStrings).
+#define LOG_DEFERRED(LOG_LEVEL, FMT, ARGS...) \
+    logDeferred(LOG_LEVEL, __FILE__, __FUNCTION__, __LINE__, FMT, LOG_DEFERRED_NARGS(ARGS), ##ARGS)
+
+#ifdef VERBOSE_DEBUG
+#define DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED(FMT, ARGS...)                     LOG_DEFERRED("", FMT, ##ARGS)
+#else
+#define DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED(FMT, ARGS...)                     while (0)
+#endif
+
+#define DEBUG_FUNCTION_LINE_DEFERRED(FMT, ARGS...)                             LOG_DEFERRED("", FMT, ##ARGS)
+#define DEBUG_FUNCTION_LINE_ERR_DEFERRED(FMT, ARGS...)                         LOG_DEFERRED("##ERROR## ", FMT, ##ARGS)
+#define DEBUG_FUNCTION_LINE_INFO_DEFERRED(FMT, ARGS...)                        LOG_DEFERRED("##INFO ## ", FMT, ##ARGS)
+
 #else
 
 #define DEBUG_FUNCTION_LINE_VERBOSE_EX(FMT, ARGS...)                           while (0)
@@ -63,10 +81,36 @@ extern "C" {
 
 #define DEBUG_FUNCTION_LINE_ERR_LAMBDA(FILENAME, FUNCTION, LINE, FMT, ARGS...) LOG_EX(FILENAME, FUNCTION, LINE, OSReport, "##ERROR## ", "\n", FMT, ##ARGS);
 
+// Without DEBUG the flusher only posts notifications, and errors are rare enough to report right away.
+#define DEBUG_FUNCTION_LINE_VERBOSE_DEFERRED(FMT, ARGS...)                     while (0)
+#define DEBUG_FUNCTION_LINE_DEFERRED(FMT, ARGS...)                             while (0)
+#define DEBUG_FUNCTION_LINE_ERR_DEFERRED(FMT, ARGS...)                         DEBUG_FUNCTION_LINE_ERR(FMT, ##ARGS)
+#define DEBUG_FUNCTION_LINE_INFO_DEFERRED(FMT, ARGS...)                        DEBUG_FUNCTION_LINE_INFO(FMT, ##ARGS)
+
 #endif
 
+// Shows the message as an error notification, and logs it, in every build.
+// Like deferred logging, a call only copies its arguments, and the flusher
+// thread posts the notification later. Same rules for the arguments.
+#define DEBUG_FUNCTION_LINE_NOTIFY_DEFERRED(FMT, ARGS...) \
+    notifyDeferred(__FILE__, __FUNCTION__, __LINE__, FMT, LOG_DEFERRED_NARGS(ARGS), ##ARGS)
+
+#define LOG_DEFERRED_MAX_ARGS 8
+#define LOG_DEFERRED_NARGS(ARGS...)                                 LOG_DEFERRED_NARGS_(0, ##ARGS, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_DEFERRED_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+
+/// Adds a record to the deferred log. Never blocks: if the ring is full, the record is dropped and counted.
+/// All strings must outlive the call. Use the DEBUG_FUNCTION_LINE_*_DEFERRED macros instead.
+void logDeferred(const char *level, const char *file, const char *function, int line, const char *format, int argCount, ...);
+
+/// Adds a notification for the flusher to post. Never blocks: if the queue is full, it's dropped and counted.
+/// All strings must outlive the call. Use DEBUG_FUNCTION_LINE_NOTIFY_DEFERRED instead.
+void notifyDeferred(const char *file, const char *function, int line, const char *format, int argCount, ...);
+
+/// Also starts the flusher thread, which writes the deferred log (in DEBUG builds) and posts notifications.
 void initLogging();
 
+/// Stops the flusher thread after writing what's left in the deferred log and notification queue.
 void deinitLogging();
 
 #ifdef __cplusplus
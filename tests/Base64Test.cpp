@@ -0,0 +1,142 @@
+#include "../src/utils/base64enc.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string Encode(const std::string& data) {
+    std::vector<char> out(BASE64_ENCODED_SIZE(data.size()));
+    base64_encode(reinterpret_cast<const unsigned char*>(data.data()), data.size(), out.data());
+    return out.data();
+}
+
+/// Returns the decoded bytes, or "<invalid>" if base64_decode fails.
+static std::string Decode(const std::string& text) {
+    std::vector<unsigned char> out(BASE64_DECODED_SIZE(text.size()) + 1);
+    const long size = base64_decode(text.data(), text.size(), out.data());
+    if (size < 0) {
+        return "<invalid>";
+    }
+    EXPECT_LE(static_cast<size_t>(size), BASE64_DECODED_SIZE(text.size()));
+    return std::string(reinterpret_cast<const char*>(out.data()), static_cast<size_t>(size));
+}
+
+static std::string HexEncode(const std::string& data) {
+    std::vector<char> out(HEX_ENCODED_SIZE(data.size()));
+    hex_encode(reinterpret_cast<const unsigned char*>(data.data()), data.size(), out.data());
+    return out.data();
+}
+
+static std::string HexDecode(const std::string& text) {
+    std::vector<unsigned char> out(HEX_DECODED_SIZE(text.size()) + 1);
+    const long size = hex_decode(text.data(), text.size(), out.data());
+    if (size < 0) {
+        return "<invalid>";
+    }
+    return std::string(reinterpret_cast<const char*>(out.data()), static_cast<size_t>(size));
+}
+
+// https://www.rfc-editor.org/rfc/rfc4648#section-10
+static const std::pair<const char*, const char*> cRfc4648Base64[] = {
+    { "", "" },
+    { "f", "Zg==" },
+    { "fo", "Zm8=" },
+    { "foo", "Zm9v" },
+    { "foob", "Zm9vYg==" },
+    { "fooba", "Zm9vYmE=" },
+    { "foobar", "Zm9vYmFy" },
+};
+
+TEST(Base64, Rfc4648Vectors)
+{
+    for (const auto& [data, text] : cRfc4648Base64) {
+        EXPECT_EQ(Encode(data), text) << data;
+        EXPECT_EQ(Decode(text), data) << text;
+    }
+}
+
+TEST(Base64, AllCharactersDecode)
+{
+    // Every value once, in both the main loop and the last quad.
+    const std::string text = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const std::string data = Decode(text);
+    ASSERT_EQ(data.size(), 48u);
+    EXPECT_EQ(Encode(data), text);
+    EXPECT_EQ(Encode(Decode("+/+/")), "+/+/");
+}
+
+TEST(Base64, Padding)
+{
+    // Padding only in the last quad, and only one or two characters of it.
+    EXPECT_EQ(Decode("Zg=="), "f");
+    EXPECT_EQ(Decode("Zm8="), "fo");
+    EXPECT_EQ(Decode("Zg==Zm9v"), "<invalid>");
+    EXPECT_EQ(Decode("Zm8=Zm9v"), "<invalid>");
+    EXPECT_EQ(Decode("Z==="), "<invalid>");
+    EXPECT_EQ(Decode("===="), "<invalid>");
+    EXPECT_EQ(Decode("Zm=v"), "<invalid>");
+    EXPECT_EQ(Decode("Z=8="), "<invalid>");
+    // Padding has to be there.
+    EXPECT_EQ(Decode("Zg"), "<invalid>");
+    EXPECT_EQ(Decode("Zm8"), "<invalid>");
+}
+
+TEST(Base64, InvalidCharacters)
+{
+    for (const char* text : { "Zm9v!mFy", "Zm9vYmF-", "Zm9v Fy=", "_m9vYmFy", "Zm9vYmF\n", "Zm9\x80YmFy" }) {
+        EXPECT_EQ(Decode(text), "<invalid>") << text;
+    }
+    // A NUL isn't the end of the input.
+    EXPECT_EQ(Decode(std::string("Zm9v\0mFy", 8)), "<invalid>");
+}
+
+TEST(Base64, BadLengths)
+{
+    for (const char* text : { "Z", "Zm", "Zm9", "Zm9vY", "Zm9vYm", "Zm9vYmF" }) {
+        EXPECT_EQ(Decode(text), "<invalid>") << text;
+    }
+}
+
+TEST(Base64, RoundTrip)
+{
+    std::mt19937 random(1);
+    for (size_t size = 0; size <= 100; size++) {
+        std::string data(size, '\0');
+        for (char& c : data) {
+            c = static_cast<char>(random());
+        }
+        const std::string text = Encode(data);
+        EXPECT_EQ(text.size(), BASE64_ENCODED_SIZE(size) - 1);
+        EXPECT_EQ(Decode(text), data) << "size " << size;
+    }
+}
+
+// https://www.rfc-editor.org/rfc/rfc4648#section-10
+TEST(Hex, Rfc4648Vectors)
+{
+    EXPECT_EQ(HexEncode(""), "");
+    EXPECT_EQ(HexEncode("f"), "66");
+    EXPECT_EQ(HexEncode("foobar"), "666f6f626172");
+    EXPECT_EQ(HexDecode("666F6F626172"), "foobar");
+    EXPECT_EQ(HexDecode("666f6F626172"), "foobar");
+    EXPECT_EQ(HexDecode(""), "");
+}
+
+TEST(Hex, InvalidInput)
+{
+    for (const char* text : { "6", "666", "66f", "6g", "g6", " 6", "6:", "@6", "6G", "0x" }) {
+        EXPECT_EQ(HexDecode(text), "<invalid>") << text;
+    }
+    EXPECT_EQ(HexDecode(std::string("6\0", 2)), "<invalid>");
+}
+
+TEST(Hex, RoundTrip)
+{
+    std::string data(256, '\0');
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i);
+    }
+    const std::string text = HexEncode(data);
+    EXPECT_EQ(text.size(), HEX_ENCODED_SIZE(data.size()) - 1);
+    EXPECT_EQ(HexDecode(text), data);
+}
@@ -0,0 +1,119 @@
+#include "../src/ffl_verify.h"
+#include "../src/ffl_colors.h"
+#include <gtest/gtest.h>
+#include <cstring>
+
+/// Returns a CharInfo that FFL itself would accept.
+static FFLiCharInfo GetValidCharInfo() {
+    FFLiCharInfo info;
+    std::memset(&info, 0, sizeof(info));
+    info.miiVersion = 3;
+    info.eyebrow.y = 10; // Minimum is 3.
+    info.personal.name[0] = u'A';
+    info.personal.birthMonth = 2;
+    info.personal.birthDay = 29;
+    info.createID[0] = 0x80; // Normal Mii.
+    return info;
+}
+
+TEST(CharInfoVerify, Unextended_IsNotExtended)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    EXPECT_FALSE(isExtendedCharInfo(info));
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_SUCCESS);
+}
+
+TEST(CharInfoVerify, CommonColors_Accepted)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.hair.color    = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 99;
+    info.eye.color     = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 0;
+    info.eyebrow.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 47;
+    info.mouth.color   = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 19;
+    info.beard.color   = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 73;
+    info.glass.color   = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 3;
+    info.faceline.color = FFLI_NN_MII_FACELINE_COLOR_MAX - 1;
+
+    EXPECT_TRUE(isExtendedCharInfo(info));
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_SUCCESS);
+}
+
+TEST(CharInfoVerify, CustomColor_Accepted)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.glass.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | FFLI_NN_MII_COMMON_COLOR_MAX;
+    info.hair.color  = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | (FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX - 1);
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_SUCCESS);
+}
+
+TEST(CharInfoVerify, CommonColor_OutOfRange)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.glass.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | (FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX);
+    EXPECT_TRUE(isExtendedCharInfo(info));
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_GLASS_COLOR);
+}
+
+TEST(CharInfoVerify, UnmaskedColor_UsesFFLRange)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.hair.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 5;
+    info.mouth.color = 5; // FFL allows 0-4.
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_MOUTH_COLOR);
+}
+
+TEST(CharInfoVerify, FacelineColor_OutOfRange)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.faceline.color = FFLI_NN_MII_FACELINE_COLOR_MAX;
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_FACELINE_COLOR);
+}
+
+TEST(CharInfoVerify, FirstFailingReason)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.hair.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 1;
+    info.eyebrow.y = 0;
+    info.personal.gender = 2;
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_EYEBROW_Y);
+}
+
+TEST(CharInfoVerify, Name_OnlyWithNameCheck)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.hair.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 1;
+    info.personal.name[0] = u'\0';
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_NAME);
+    EXPECT_EQ(verifyExtendedCharInfo(info, false), FFLI_VERIFY_REASON_SUCCESS);
+}
+
+TEST(CharInfoVerify, Birthday)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.personal.birthMonth = 4;
+    info.personal.birthDay = 31;
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_BIRTHDAY);
+
+    info.personal.birthMonth = 0;
+    info.personal.birthDay = 0;
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_SUCCESS);
+
+    info.personal.birthDay = 1;
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_BIRTHDAY);
+}
+
+TEST(CharInfoVerify, CreateID)
+{
+    FFLiCharInfo info = GetValidCharInfo();
+    info.hair.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 99;
+    std::memset(info.createID, 0, sizeof(info.createID));
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_CREATEID);
+
+    info.createID[9] = 1;
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_SUCCESS);
+
+    // Checked last, like FFL.
+    std::memset(info.createID, 0, sizeof(info.createID));
+    info.personal.birthPlatform = 8;
+    EXPECT_EQ(verifyExtendedCharInfo(info, true), FFLI_VERIFY_REASON_BIRTH_PLATFORM);
+}
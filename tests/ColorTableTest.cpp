@@ -0,0 +1,105 @@
+#include "../src/ffl_colors.h"
+#include <gtest/gtest.h>
+
+/// Rows of the nn::mii tables as they were stored in floats, before ffl_colors.cpp derived them.
+struct ReferenceRow {
+    const FFLColor (*table)[FFLI_CONTAINER_TYPE_MAX];
+    int index;
+    FFLColor linear;
+    FFLColor srgb;
+};
+
+static void ExpectColorNear(const FFLColor& actual, const FFLColor& expected, const char* what, int index) {
+    constexpr float tolerance = 1e-6f;
+    EXPECT_NEAR(actual.r, expected.r, tolerance) << what << " " << index;
+    EXPECT_NEAR(actual.g, expected.g, tolerance) << what << " " << index;
+    EXPECT_NEAR(actual.b, expected.b, tolerance) << what << " " << index;
+    EXPECT_EQ(actual.a, expected.a) << what << " " << index;
+}
+
+class ColorTableTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() { initNnMiiColorTables(); }
+};
+
+TEST_F(ColorTableTest, MatchesOriginalFloats)
+{
+    const ReferenceRow rows[] = {
+        { gNnMiiColorTables.faceline, 0, { 1.0f, 0.6514057f, 0.4178851f, 1.0f }, { 1.0f, 0.827451f, 0.6784314f, 1.0f } },
+        { gNnMiiColorTables.faceline, 8, { 0.2622508f, 0.04518623f, 0.0168074f, 1.0f }, { 0.5490197f, 0.2352942f, 0.137255f, 1.0f } },
+        { gNnMiiColorTables.common, 0, { 0.02624122f, 0.02121902f, 0.02121902f, 1.0f }, { 0.1764706f, 0.1568628f, 0.1568628f, 1.0f } },
+        { gNnMiiColorTables.common, 19, { 0.6866855f, 0.08437625f, 0.00242822f, 1.0f }, { 0.8470589f, 0.3215687f, 0.0313726f, 1.0f } },
+        { gNnMiiColorTables.common, 99, { 1.0f, 1.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+        { gNnMiiColorTables.upperLip, 5, { 0.02028857f, 0.0137021f, 0.00242822f, 1.0f }, { 0.1529412f, 0.1215687f, 0.0313726f, 1.0f } },
+        { gNnMiiColorTables.upperLip, 99, { 0.6938719f, 0.6938719f, 0.6938719f, 1.0f }, { 0.8509804f, 0.8509804f, 0.8509804f, 1.0f } },
+    };
+    for (const ReferenceRow& row : rows) {
+        ExpectColorNear(row.table[row.index][NN_MII_COLOR_GAMMA_LINEAR], row.linear, "linear", row.index);
+        ExpectColorNear(row.table[row.index][NN_MII_COLOR_GAMMA_SRGB], row.srgb, "sRGB", row.index);
+    }
+}
+
+TEST_F(ColorTableTest, LinearIsDarkerThanSrgb)
+{
+    for (int i = 0; i < FFLI_NN_MII_COMMON_COLOR_MAX; i++) {
+        const FFLColor& linear = gNnMiiColorTables.common[i][NN_MII_COLOR_GAMMA_LINEAR];
+        const FFLColor& srgb = gNnMiiColorTables.common[i][NN_MII_COLOR_GAMMA_SRGB];
+        EXPECT_LE(linear.r, srgb.r) << i;
+        EXPECT_LE(linear.g, srgb.g) << i;
+        EXPECT_LE(linear.b, srgb.b) << i;
+        EXPECT_EQ(srgb.r, static_cast<float>(NxCommonColorsSrgb[i].r) / 255.0f) << i;
+    }
+}
+
+TEST_F(ColorTableTest, TablesAreAligned)
+{
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&gNnMiiColorTables) % 32, 0u);
+}
+
+TEST_F(ColorTableTest, CustomColorsAreDeduplicated)
+{
+    resetCustomColors();
+    const NnMiiColor8 teal = { 0, 128, 128 };
+    const int index = addCustomColor(teal);
+    EXPECT_EQ(index, FFLI_NN_MII_COMMON_COLOR_MAX);
+    EXPECT_EQ(addCustomColor(teal), index);
+    // nn::mii's own colors resolve to their index.
+    EXPECT_EQ(addCustomColor(NxCommonColorsSrgb[42]), 42);
+
+    const FFLColor& srgb = gNnMiiColorTables.common[index][NN_MII_COLOR_GAMMA_SRGB];
+    EXPECT_EQ(srgb.g, 128.0f / 255.0f);
+    EXPECT_EQ(getCommonColor8(index).g, 128);
+    resetCustomColors();
+}
+
+TEST_F(ColorTableTest, CustomColorPoolFillsUp)
+{
+    resetCustomColors();
+    // The first slot keeps its address and color as the pool grows.
+    const FFLColor* first = &gNnMiiColorTables.common[FFLI_NN_MII_COMMON_COLOR_MAX][0];
+    for (int i = 0; i < FFLI_NN_MII_CUSTOM_COLOR_MAX; i++) {
+        const NnMiiColor8 color = { static_cast<uint8_t>(i), 1, 255 };
+        ASSERT_EQ(addCustomColor(color), FFLI_NN_MII_COMMON_COLOR_MAX + i);
+    }
+    EXPECT_EQ(addCustomColor({ 1, 2, 3 }), -1);
+    EXPECT_EQ(addCustomColor({ 5, 1, 255 }), FFLI_NN_MII_COMMON_COLOR_MAX + 5);
+    EXPECT_EQ(first[NN_MII_COLOR_GAMMA_SRGB].g, 1.0f / 255.0f);
+    resetCustomColors();
+}
+
+TEST_F(ColorTableTest, NearestCommonColorOfCustomColors)
+{
+    resetCustomColors();
+    EXPECT_EQ(getNearestCommonColor(42), 42);
+    // A shade off of common color 99 (white).
+    const int index = addCustomColor({ 254, 254, 254 });
+    EXPECT_EQ(getNearestCommonColor(index), FindNearestColor({ 254, 254, 254 }, NxColorPalette_Common));
+    EXPECT_EQ(getNearestCommonColor(index), 99);
+
+    // Out of range indices don't read past the pool.
+    const int past = FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX;
+    EXPECT_EQ(getNearestCommonColor(past), 0);
+    EXPECT_EQ(getNearestCommonColor(-1), 0);
+    EXPECT_EQ(getCommonColor8(past).r, NxCommonColorsSrgb[0].r);
+    resetCustomColors();
+}
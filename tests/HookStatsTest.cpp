@@ -0,0 +1,94 @@
+#include "../src/utils/HookStats.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/// Stands in for a hook: counted, and passed on to "real_" when asked.
+static int fakeHook(bool fallThrough, std::chrono::microseconds work = {}) {
+    HOOK_STATS_SCOPE(FFLiGetHairColor);
+    if (fallThrough) {
+        HOOK_STATS_FALLTHROUGH();
+        return 0;
+    }
+    if (work.count() != 0) {
+        std::this_thread::sleep_for(work);
+    }
+    return 1;
+}
+
+class HookStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override { resetHookStats(); }
+};
+
+TEST_F(HookStatsTest, CountsCallsAndFallthroughs)
+{
+    for (int i = 0; i < 10; i++) {
+        fakeHook(i % 2 == 0);
+    }
+    const HookStatsSnapshot stats = getHookStats(HOOK_STATS_ID_FFLiGetHairColor);
+    EXPECT_EQ(stats.calls, 10u);
+    EXPECT_EQ(stats.fallthroughs, 5u);
+
+    uint32_t bucketTotal = 0;
+    for (uint32_t count : stats.buckets) {
+        bucketTotal += count;
+    }
+    EXPECT_EQ(bucketTotal, stats.calls);
+    // Others are untouched.
+    EXPECT_EQ(getHookStats(HOOK_STATS_ID_FFLiGetGlassColor).calls, 0u);
+}
+
+TEST_F(HookStatsTest, SlowCallsLandInHigherBuckets)
+{
+    fakeHook(false, std::chrono::microseconds(2000));
+    const HookStatsSnapshot stats = getHookStats(HOOK_STATS_ID_FFLiGetHairColor);
+    ASSERT_EQ(stats.calls, 1u);
+    for (int i = 0; i < HOOK_STATS_BUCKET_COUNT; i++) {
+        if (stats.buckets[i] != 0) {
+            // At least 2 ms, so the bucket's upper bound must be above that.
+            EXPECT_GT(getHookStatsBucketNanoseconds(i) * 2, 2000000u) << "bucket " << i;
+        }
+    }
+}
+
+TEST_F(HookStatsTest, BucketBoundsDouble)
+{
+    EXPECT_EQ(getHookStatsBucketNanoseconds(0), 0u);
+    for (int i = 2; i < HOOK_STATS_BUCKET_COUNT; i++) {
+        EXPECT_EQ(getHookStatsBucketNanoseconds(i), getHookStatsBucketNanoseconds(i - 1) * 2);
+    }
+}
+
+TEST_F(HookStatsTest, CountsFromManyThreads)
+{
+    constexpr int cThreads = 6;
+    constexpr int cCallsPerThread = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < cThreads; t++) {
+        threads.emplace_back([] {
+            for (int i = 0; i < cCallsPerThread; i++) {
+                fakeHook(i % 4 == 0);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const HookStatsSnapshot stats = getHookStats(HOOK_STATS_ID_FFLiGetHairColor);
+    EXPECT_EQ(stats.calls, uint32_t(cThreads * cCallsPerThread));
+    EXPECT_EQ(stats.fallthroughs, uint32_t(cThreads * cCallsPerThread / 4));
+    uint32_t coreTotal = 0;
+    for (uint32_t calls : stats.coreCalls) {
+        coreTotal += calls;
+    }
+    EXPECT_EQ(coreTotal, stats.calls);
+}
+
+TEST_F(HookStatsTest, NamesMatchHooks)
+{
+    EXPECT_STREQ(getHookStatsName(HOOK_STATS_ID_FFLiGetHairColor), "FFLiGetHairColor");
+    EXPECT_STREQ(getHookStatsName(HOOK_STATS_ID_FUN_020d02d8), "FUN_020d02d8");
+}
@@ -0,0 +1,356 @@
+/**
+ * @file HookTraceReplay.cpp
+ * @brief Feeds a hook trace from the console (see src/utils/HookTrace.h) through the my_ hooks, and reports how fast they ran.
+ *
+ * Usage:
+ *   HookTraceReplay <trace.bin> [iterations]
+ *   HookTraceReplay --listen [iterations]   (waits for a HOOK_TRACE=udp build to send one)
+ *
+ * The hooks are built with __WIIU__ against the stand-ins in host/, so they
+ * take the same paths as on the console. real_ functions are stubs that do
+ * as little as possible, so the times are only the plugin's own work.
+ * Iterations after the first run with warm decode and verify caches, like
+ * a title going over the same Miis again.
+ */
+#include "../src/ffl_patches.h"
+#include "../src/ffl_types.h"
+#include "../src/utils/HookTrace.h"
+#include "../effsd/src/NxInVer3Pack.hpp"
+#include "../src/utils/ReadFile.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// // ---------------------------------------------------------------
+// //  Stub real_ Functions
+// // ---------------------------------------------------------------
+
+static constexpr FFLColor cStubColor { 0.5f, 0.5f, 0.5f, 1.0f };
+
+static const void* stubGetColor(int /* colorIndex */) { return &cStubColor; }
+static int stubVerifyCharInfoWithReason(void* /* pInfo */, int /* nameCheck */) { return 0; }
+static void stubMiiDataCore2CharInfo(void* dst, const void* /* src */, char16_t* /* creatorName */, int /* birthday */) {
+    memset(dst, 0, sizeof(FFLiCharInfo));
+}
+static void stubCharInfo2MiiDataCore(void* dst, const void* /* src */, int /* birthday */) {
+    memset(dst, 0, sizeof(Ver3MiiDataCore));
+}
+static void stubInitModulateEye(void* /* pParam */, int /* colorGB */, int /* colorR */, const void* /* pTexture */) {}
+static void stubInitModulateMouth(void* /* pParam */, int /* color */, const void* /* pTexture */) {}
+static int stubLoadTexture(void* /* self */, void* /* pData */, uint32_t* /* pSize */, int /* partsType */, uint32_t /* index */) {
+    return FFL_RESULT_OK;
+}
+
+static void installStubs() {
+    real_FFLiGetHairColor = stubGetColor;
+    real_FFLiGetGlassColor = stubGetColor;
+    real_FFLiGetSrgbFetchEyebrowColor = stubGetColor;
+    real_FFLiGetFacelineColor = stubGetColor;
+    real_FFLiVerifyCharInfoWithReason = stubVerifyCharInfoWithReason;
+    real_FFLiMiiDataCore2CharInfo = stubMiiDataCore2CharInfo;
+    real_FFLiCharInfo2MiiDataCore = stubCharInfo2MiiDataCore;
+    real_FFLiInitModulateEye = stubInitModulateEye;
+    real_FFLiInitModulateMouth = stubInitModulateMouth;
+    real_FFLiResourceLoader_LoadTexture = stubLoadTexture;
+}
+
+// // ---------------------------------------------------------------
+// //  Byte Order
+// // ---------------------------------------------------------------
+// Payloads are in the console's byte order. The hooks expect this one's.
+
+static void swapUnit(uint8_t* p, size_t size) {
+    std::reverse(p, p + size);
+}
+
+static void swapUnits(uint8_t* p, size_t begin, size_t end, size_t size) {
+    for (size_t offset = begin; offset < end; offset += size) {
+        swapUnit(p + offset, size);
+    }
+}
+
+/// Same units as Ver3MiiNativeView reads, plus the name.
+static void swapMiiDataCore(uint8_t* core) {
+    size_t lastOffset = SIZE_MAX;
+    for (const Ver3FieldDesc& desc : Ver3FieldDescs) {
+        if (desc.offset != lastOffset && desc.size > 1) {
+            swapUnit(core + desc.offset, desc.size);
+        }
+        lastOffset = desc.offset;
+    }
+    swapUnits(core, offsetof(Ver3MiiDataCore, name), offsetof(Ver3MiiDataCore, name) + sizeof(Ver3MiiDataCore::name), 2);
+}
+
+static void swapCharInfo(uint8_t* info) {
+    swapUnits(info, 0, offsetof(FFLiCharInfo, personal.name), 4);
+    swapUnits(info, offsetof(FFLiCharInfo, personal.name), offsetof(FFLiCharInfo, personal.gender), 2);
+    swapUnits(info, offsetof(FFLiCharInfo, personal.gender), offsetof(FFLiCharInfo, personal.favorite), 4);
+    // favorite, copyable, ngWord and localonly are bytes.
+    swapUnits(info, offsetof(FFLiCharInfo, personal.regionMove), offsetof(FFLiCharInfo, createID), 4);
+    swapUnit(info + offsetof(FFLiCharInfo, padding_0), 2);
+    swapUnit(info + offsetof(FFLiCharInfo, authorType), 4);
+}
+
+// // ---------------------------------------------------------------
+// //  Replaying
+// // ---------------------------------------------------------------
+
+/// A trace event with its payload copied out and in this byte order.
+struct ReplayCall
+{
+    HookStatsId hook;
+    uint32_t args[HOOK_TRACE_MAX_ARGS];
+    std::vector<uint8_t> payload;
+};
+
+/// Output of the hooks, so the compiler can't drop them.
+static uintptr_t sSink;
+
+/// @return False if the hook isn't replayable, or its payload is the wrong size.
+static bool replayCall(ReplayCall& call) {
+    const auto arg = [&call](int i) { return static_cast<int>(call.args[i]); };
+    switch (call.hook) {
+    case HOOK_STATS_ID_FFLiGetHairColor:
+        sSink += reinterpret_cast<uintptr_t>(my_FFLiGetHairColor(arg(0)));
+        return true;
+    case HOOK_STATS_ID_FFLiGetGlassColor:
+        sSink += reinterpret_cast<uintptr_t>(my_FFLiGetGlassColor(arg(0)));
+        return true;
+    case HOOK_STATS_ID_FFLiGetSrgbFetchEyebrowColor:
+        sSink += reinterpret_cast<uintptr_t>(my_FFLiGetSrgbFetchEyebrowColor(arg(0)));
+        return true;
+    case HOOK_STATS_ID_FFLiGetFacelineColor:
+        sSink += reinterpret_cast<uintptr_t>(my_FFLiGetFacelineColor(arg(0)));
+        return true;
+    case HOOK_STATS_ID_FFLiVerifyCharInfoWithReason:
+        if (!call.payload.empty() && call.payload.size() != sizeof(FFLiCharInfo)) {
+            return false;
+        }
+        sSink += static_cast<uintptr_t>(my_FFLiVerifyCharInfoWithReason(
+            call.payload.empty() ? nullptr : call.payload.data(), arg(0)));
+        return true;
+    case HOOK_STATS_ID_FFLiMiiDataCore2CharInfo: {
+        if (call.payload.size() != sizeof(Ver3MiiDataCore)) {
+            return false;
+        }
+        FFLiCharInfo info;
+        char16_t creatorName[MII_CREATORNAME_LENGTH + 1] = {};
+        my_FFLiMiiDataCore2CharInfo(&info, call.payload.data(), creatorName, arg(0));
+        sSink += static_cast<uintptr_t>(info.hair.color);
+        return true;
+    }
+    case HOOK_STATS_ID_FFLiCharInfo2MiiDataCore: {
+        if (call.payload.size() != sizeof(FFLiCharInfo)) {
+            return false;
+        }
+        uint8_t core[sizeof(Ver3MiiDataCore)];
+        my_FFLiCharInfo2MiiDataCore(core, call.payload.data(), arg(0));
+        sSink += core[0];
+        return true;
+    }
+    case HOOK_STATS_ID_FFLiInitModulateEye: {
+        FFLModulateParam param{};
+        my_FFLiInitModulateEye(&param, arg(0), arg(1), nullptr);
+        sSink += reinterpret_cast<uintptr_t>(param.pColorB);
+        return true;
+    }
+    case HOOK_STATS_ID_FFLiInitModulateMouth: {
+        FFLModulateParam param{};
+        my_FFLiInitModulateMouth(&param, arg(0), nullptr);
+        sSink += reinterpret_cast<uintptr_t>(param.pColorR);
+        return true;
+    }
+    case HOOK_STATS_ID_FFLiResourceLoader_LoadTexture: {
+        uint32_t size = 0;
+        sSink += static_cast<uintptr_t>(my_FFLiResourceLoader_LoadTexture(
+            nullptr, nullptr, &size, arg(0), call.args[1]));
+        return true;
+    }
+    default:
+        // The Mii Maker hooks take the editor's own objects, which aren't in the trace.
+        return false;
+    }
+}
+
+static std::vector<ReplayCall> prepareCalls(const std::vector<HookTraceEvent>& events, bool swapped) {
+    std::vector<ReplayCall> calls;
+    calls.reserve(events.size());
+    for (const HookTraceEvent& event : events) {
+        ReplayCall call;
+        call.hook = event.hook;
+        memcpy(call.args, event.args, sizeof(call.args));
+        call.payload.assign(event.payload, event.payload + event.payloadSize);
+        if (swapped) {
+            if (call.payload.size() == sizeof(Ver3MiiDataCore) && event.hook == HOOK_STATS_ID_FFLiMiiDataCore2CharInfo) {
+                swapMiiDataCore(call.payload.data());
+            } else if (call.payload.size() == sizeof(FFLiCharInfo)) {
+                swapCharInfo(call.payload.data());
+            }
+        }
+        calls.push_back(std::move(call));
+    }
+    return calls;
+}
+
+// // ---------------------------------------------------------------
+// //  Receiving
+// // ---------------------------------------------------------------
+
+/// Puts together a trace sent by a HOOK_TRACE=udp build.
+static bool receiveTrace(std::vector<uint8_t>& out) {
+    const int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        perror("socket");
+        return false;
+    }
+    const int reuse = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(HOOK_TRACE_UDP_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(sock, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        perror("bind");
+        close(sock);
+        return false;
+    }
+    fprintf(stderr, "Waiting for a trace on UDP port %d...\n", HOOK_TRACE_UDP_PORT);
+
+    std::vector<bool> received;
+    size_t missing = 0;
+    uint8_t datagram[sizeof(HookTraceDatagram) + HOOK_TRACE_UDP_CHUNK];
+    while (received.empty() || missing != 0) {
+        const ssize_t length = recv(sock, datagram, sizeof(datagram), 0);
+        if (length < 0) {
+            fprintf(stderr, "Gave up with %zu of %zu chunks missing\n", missing, received.size());
+            close(sock);
+            return false;
+        }
+        HookTraceDatagram prefix;
+        if (static_cast<size_t>(length) < sizeof(prefix)) {
+            continue;
+        }
+        memcpy(&prefix, datagram, sizeof(prefix));
+        if (prefix.magic != HOOK_TRACE_MAGIC) {
+            if (__builtin_bswap32(prefix.magic) != HOOK_TRACE_MAGIC) {
+                continue;
+            }
+            prefix.offset = __builtin_bswap32(prefix.offset);
+            prefix.totalSize = __builtin_bswap32(prefix.totalSize);
+        }
+        if (received.empty()) {
+            out.assign(prefix.totalSize, 0);
+            received.assign((prefix.totalSize + HOOK_TRACE_UDP_CHUNK - 1) / HOOK_TRACE_UDP_CHUNK, false);
+            missing = received.size();
+            // Once it starts, the rest should follow right away.
+            const timeval timeout = { 5, 0 };
+            setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        }
+        const size_t chunk = static_cast<size_t>(length) - sizeof(prefix);
+        const size_t index = prefix.offset / HOOK_TRACE_UDP_CHUNK;
+        if (prefix.totalSize != out.size() || prefix.offset % HOOK_TRACE_UDP_CHUNK != 0 ||
+            index >= received.size() || chunk > out.size() - prefix.offset || received[index]) {
+            continue;
+        }
+        memcpy(out.data() + prefix.offset, datagram + sizeof(prefix), chunk);
+        received[index] = true;
+        missing--;
+    }
+    close(sock);
+    return true;
+}
+
+// // ---------------------------------------------------------------
+// //  Main
+// // ---------------------------------------------------------------
+
+static double nanosecondsSince(Clock::time_point start) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <trace.bin | --listen> [iterations]\n", argv[0]);
+        return 1;
+    }
+    const int iterations = argc >= 3 ? std::max(1, atoi(argv[2])) : 100;
+
+    std::vector<uint8_t> file;
+    const bool loaded = strcmp(argv[1], "--listen") == 0
+        ? receiveTrace(file)
+        : readWholeFile(argv[1], file);
+    std::vector<HookTraceEvent> events;
+    bool swapped = false;
+    if (!loaded || !parseHookTrace(file, events, swapped)) {
+        fprintf(stderr, "Couldn't read a hook trace from %s\n", argv[1]);
+        return 1;
+    }
+    HookTraceHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    const uint32_t dropped = swapped ? __builtin_bswap32(header.dropped) : header.dropped;
+    printf("%zu calls in trace (%s byte order), %u dropped while capturing\n",
+        events.size(), swapped ? "swapped" : "native", dropped);
+
+    installStubs();
+    std::vector<ReplayCall> calls = prepareCalls(events, swapped);
+
+    // Check every call once, and leave out the ones that can't be replayed.
+    uint32_t skipped[HOOK_STATS_ID_MAX] = {};
+    std::vector<ReplayCall> replayable;
+    for (ReplayCall& call : calls) {
+        if (replayCall(call)) {
+            replayable.push_back(std::move(call));
+        } else {
+            skipped[call.hook]++;
+        }
+    }
+
+    // The whole stream in order, as the title made the calls.
+    const Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (ReplayCall& call : replayable) {
+            replayCall(call);
+        }
+    }
+    const double totalNs = nanosecondsSince(start);
+    const double totalCalls = static_cast<double>(replayable.size()) * iterations;
+    printf("Replayed %zu calls x %d: %.1f ms, %.0f calls/s, %.1f ns/call\n",
+        replayable.size(), iterations, totalNs / 1e6,
+        totalNs > 0 ? totalCalls * 1e9 / totalNs : 0.0, totalCalls > 0 ? totalNs / totalCalls : 0.0);
+
+    // Then each hook's calls on their own.
+    printf("%-32s %10s %10s %12s %14s\n", "hook", "calls", "skipped", "ns/call", "calls/s");
+    for (int id = 0; id < HOOK_STATS_ID_MAX; id++) {
+        std::vector<ReplayCall*> hookCalls;
+        for (ReplayCall& call : replayable) {
+            if (call.hook == id) {
+                hookCalls.push_back(&call);
+            }
+        }
+        if (hookCalls.empty() && skipped[id] == 0) {
+            continue;
+        }
+        const Clock::time_point hookStart = Clock::now();
+        for (int i = 0; i < iterations; i++) {
+            for (ReplayCall* call : hookCalls) {
+                replayCall(*call);
+            }
+        }
+        const double hookNs = nanosecondsSince(hookStart);
+        const double hookTotal = static_cast<double>(hookCalls.size()) * iterations;
+        printf("%-32s %10zu %10u %12.1f %14.0f\n", getHookStatsName(static_cast<HookStatsId>(id)),
+            hookCalls.size(), skipped[id],
+            hookTotal > 0 ? hookNs / hookTotal : 0.0, hookNs > 0 ? hookTotal * 1e9 / hookNs : 0.0);
+    }
+    return sSink == 0x5A5A5A5A ? 2 : 0; // Never, but keeps sSink alive.
+}
@@ -0,0 +1,160 @@
+#include "../src/utils/HookTrace.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+class HookTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override { resetHookTrace(); }
+
+    static HookTraceHeader headerOf(const std::vector<uint8_t>& file) {
+        HookTraceHeader header;
+        memcpy(&header, file.data(), sizeof(header));
+        return header;
+    }
+};
+
+TEST_F(HookTraceTest, RoundTripsArgsAndPayloads)
+{
+    const uint8_t payload[5] = { 1, 2, 3, 4, 5 }; // Padded to 8.
+    HOOK_TRACE_CALL(FFLiGetHairColor, 0x80000003);
+    HOOK_TRACE_CALL_WITH(FFLiCharInfo2MiiDataCore, payload, sizeof(payload), 1);
+    HOOK_TRACE_CALL(FFLiInitModulateEye, -1, 7);
+
+    const std::vector<uint8_t> file = buildHookTrace();
+    std::vector<HookTraceEvent> events;
+    bool swapped = true;
+    ASSERT_TRUE(parseHookTrace(file, events, swapped));
+    EXPECT_FALSE(swapped);
+    ASSERT_EQ(events.size(), 3u);
+
+    EXPECT_EQ(events[0].hook, HOOK_STATS_ID_FFLiGetHairColor);
+    EXPECT_EQ(events[0].argCount, 1u);
+    EXPECT_EQ(events[0].args[0], 0x80000003u);
+    EXPECT_EQ(events[0].payload, nullptr);
+
+    EXPECT_EQ(events[1].hook, HOOK_STATS_ID_FFLiCharInfo2MiiDataCore);
+    ASSERT_EQ(events[1].payloadSize, sizeof(payload));
+    EXPECT_EQ(memcmp(events[1].payload, payload, sizeof(payload)), 0);
+    EXPECT_EQ(events[1].args[0], 1u);
+
+    EXPECT_EQ(events[2].argCount, 2u);
+    EXPECT_EQ(static_cast<int>(events[2].args[0]), -1);
+    EXPECT_EQ(events[2].args[1], 7u);
+}
+
+TEST_F(HookTraceTest, ReadsTheOtherByteOrder)
+{
+    const uint8_t payload[4] = { 0xAA, 0xBB, 0xCC, 0xDD };
+    HOOK_TRACE_CALL_WITH(FFLiMiiDataCore2CharInfo, payload, sizeof(payload), 0x01020304);
+    std::vector<uint8_t> file = buildHookTrace();
+
+    // Swap every header and record field, as a big-endian console would have written them.
+    const auto swap32 = [&file](size_t offset) {
+        std::reverse(file.begin() + static_cast<std::ptrdiff_t>(offset), file.begin() + static_cast<std::ptrdiff_t>(offset + 4));
+    };
+    for (size_t offset = 0; offset < sizeof(HookTraceHeader); offset += 4) {
+        swap32(offset);
+    }
+    const size_t record = sizeof(HookTraceHeader);
+    std::swap(file[record + offsetof(HookTraceRecord, payloadSize)], file[record + offsetof(HookTraceRecord, payloadSize) + 1]);
+    swap32(record + offsetof(HookTraceRecord, ticks));
+    for (size_t a = 0; a < HOOK_TRACE_MAX_ARGS; a++) {
+        swap32(record + offsetof(HookTraceRecord, args) + a * 4);
+    }
+
+    std::vector<HookTraceEvent> events;
+    bool swapped = false;
+    ASSERT_TRUE(parseHookTrace(file, events, swapped));
+    EXPECT_TRUE(swapped);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].hook, HOOK_STATS_ID_FFLiMiiDataCore2CharInfo);
+    EXPECT_EQ(events[0].args[0], 0x01020304u);
+    ASSERT_EQ(events[0].payloadSize, sizeof(payload));
+    // Payloads are left as they were.
+    EXPECT_EQ(memcmp(events[0].payload, payload, sizeof(payload)), 0);
+}
+
+TEST_F(HookTraceTest, RejectsBrokenFiles)
+{
+    HOOK_TRACE_CALL(FFLiGetGlassColor, 1);
+    const std::vector<uint8_t> good = buildHookTrace();
+    std::vector<HookTraceEvent> events;
+    bool swapped;
+
+    std::vector<uint8_t> file = good;
+    file[0] ^= 0xFF; // Magic
+    EXPECT_FALSE(parseHookTrace(file, events, swapped));
+
+    file = good;
+    file[offsetof(HookTraceHeader, byteOrderMark)] = 0x55;
+    EXPECT_FALSE(parseHookTrace(file, events, swapped));
+
+    file = good;
+    file.pop_back(); // Shorter than dataSize.
+    EXPECT_FALSE(parseHookTrace(file, events, swapped));
+
+    file = good;
+    file[sizeof(HookTraceHeader) + offsetof(HookTraceRecord, hook)] = HOOK_STATS_ID_MAX;
+    EXPECT_FALSE(parseHookTrace(file, events, swapped));
+
+    file = good;
+    file[sizeof(HookTraceHeader) + offsetof(HookTraceRecord, payloadSize)] = 0x40; // Past the end.
+    EXPECT_FALSE(parseHookTrace(file, events, swapped));
+
+    file.resize(sizeof(HookTraceHeader) - 1);
+    EXPECT_FALSE(parseHookTrace(file, events, swapped));
+}
+
+TEST_F(HookTraceTest, CountsDroppedCallsWhenFull)
+{
+    const size_t callsToFill = HOOK_TRACE_BUFFER_SIZE / sizeof(HookTraceRecord);
+    for (size_t i = 0; i < callsToFill + 100; i++) {
+        HOOK_TRACE_CALL(FFLiGetHairColor, i);
+    }
+    const std::vector<uint8_t> file = buildHookTrace();
+    const HookTraceHeader header = headerOf(file);
+    EXPECT_EQ(header.recordCount, callsToFill);
+    EXPECT_EQ(header.dropped, 100u);
+
+    std::vector<HookTraceEvent> events;
+    bool swapped;
+    ASSERT_TRUE(parseHookTrace(file, events, swapped));
+    EXPECT_EQ(events.back().args[0], callsToFill - 1);
+}
+
+TEST_F(HookTraceTest, RecordsFromManyThreads)
+{
+    constexpr int cThreads = 6;
+    constexpr uint32_t cCallsPerThread = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < cThreads; t++) {
+        threads.emplace_back([t] {
+            const uint8_t payload[3] = { uint8_t(t), uint8_t(t), uint8_t(t) };
+            for (uint32_t i = 0; i < cCallsPerThread; i++) {
+                HOOK_TRACE_CALL_WITH(FFLiVerifyCharInfoWithReason, payload, sizeof(payload), t, i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const std::vector<uint8_t> file = buildHookTrace();
+    std::vector<HookTraceEvent> events;
+    bool swapped;
+    ASSERT_TRUE(parseHookTrace(file, events, swapped));
+    EXPECT_EQ(events.size() + headerOf(file).dropped, size_t(cThreads) * cCallsPerThread);
+
+    // Each thread's calls are all there and in order, until the buffer filled up.
+    std::vector<uint32_t> next(cThreads, 0);
+    for (const HookTraceEvent& event : events) {
+        ASSERT_LT(event.args[0], uint32_t(cThreads));
+        EXPECT_EQ(event.payload[0], event.args[0]);
+        EXPECT_GE(event.args[1], next[event.args[0]]);
+        next[event.args[0]] = event.args[1] + 1;
+    }
+}
@@ -0,0 +1,217 @@
+#include "../src/resource_overlay.h"
+#include <gtest/gtest.h>
+#include <zlib.h>
+#include <cstring>
+
+/// A part to put in a sample overlay file.
+struct SamplePart {
+    std::vector<uint8_t> data;
+    uint8_t windowBits; ///< FFLiResourceWindowBits
+    uint8_t strategy;   ///< FFLiResourceStrategy
+};
+
+static void storeBE32(uint8_t* p, uint32_t value) {
+    p[0] = uint8_t(value >> 24);
+    p[1] = uint8_t(value >> 16);
+    p[2] = uint8_t(value >> 8);
+    p[3] = uint8_t(value);
+}
+
+/// Deflates `data` the way FFL's resource tool does for these settings.
+static std::vector<uint8_t> deflatePart(const std::vector<uint8_t>& data, uint8_t windowBits, uint8_t strategy) {
+    const int zlibWindowBits = windowBits < 8 ? 8 + windowBits : 16 + 8 + (windowBits - 8);
+    z_stream stream{};
+    EXPECT_EQ(deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, zlibWindowBits, 8, strategy), Z_OK);
+    std::vector<uint8_t> out(deflateBound(&stream, uLong(data.size())) + 32);
+    stream.next_in = const_cast<Bytef*>(data.data());
+    stream.avail_in = uInt(data.size());
+    stream.next_out = out.data();
+    stream.avail_out = uInt(out.size());
+    EXPECT_EQ(deflate(&stream, Z_FINISH), Z_STREAM_END);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+static std::vector<uint8_t> buildOverlay(uint32_t partsType, uint32_t firstIndex,
+    const std::vector<SamplePart>& parts, uint32_t partsMaxSize) {
+    std::vector<uint8_t> file(sizeof(ResourceOverlayHeader) + parts.size() * sizeof(FFLiResourcePartsInfo));
+    storeBE32(&file[offsetof(ResourceOverlayHeader, magic)], RESOURCE_OVERLAY_MAGIC);
+    storeBE32(&file[offsetof(ResourceOverlayHeader, version)], RESOURCE_OVERLAY_VERSION);
+    storeBE32(&file[offsetof(ResourceOverlayHeader, partsType)], partsType);
+    storeBE32(&file[offsetof(ResourceOverlayHeader, firstIndex)], firstIndex);
+    storeBE32(&file[offsetof(ResourceOverlayHeader, partsCount)], uint32_t(parts.size()));
+    storeBE32(&file[offsetof(ResourceOverlayHeader, partsMaxSize)], partsMaxSize);
+
+    for (size_t i = 0; i < parts.size(); i++) {
+        const SamplePart& part = parts[i];
+        const std::vector<uint8_t> stored = part.strategy == FFLI_RESOURCE_STRATEGY_UNCOMPRESSED
+            ? part.data : deflatePart(part.data, part.windowBits, part.strategy);
+        const size_t info = sizeof(ResourceOverlayHeader) + i * sizeof(FFLiResourcePartsInfo);
+        storeBE32(&file[info + offsetof(FFLiResourcePartsInfo, dataPos)], uint32_t(file.size()));
+        storeBE32(&file[info + offsetof(FFLiResourcePartsInfo, dataSize)], uint32_t(part.data.size()));
+        storeBE32(&file[info + offsetof(FFLiResourcePartsInfo, compressedSize)], uint32_t(stored.size()));
+        file[info + offsetof(FFLiResourcePartsInfo, compressLevel)] = 9;
+        file[info + offsetof(FFLiResourcePartsInfo, windowBits)] = part.windowBits;
+        file[info + offsetof(FFLiResourcePartsInfo, memoryLevel)] = 8;
+        file[info + offsetof(FFLiResourcePartsInfo, strategy)] = part.strategy;
+        file.insert(file.end(), stored.begin(), stored.end());
+    }
+    return file;
+}
+
+/// Stands in for a texture: a header and a repeating pattern, so it compresses.
+static std::vector<uint8_t> sampleTexture(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = uint8_t(i < 64 ? i * 7 + seed : (i / 16) % 5 + seed);
+    }
+    return data;
+}
+
+class ResourceOverlayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        mParts = {
+            { sampleTexture(0x800, 1), 7, 0 },   // zlib, default strategy
+            { sampleTexture(0x1000, 2), 15, 1 }, // gzip, filtered
+            { sampleTexture(0x400, 3), 0, FFLI_RESOURCE_STRATEGY_UNCOMPRESSED },
+        };
+        mFile = buildOverlay(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX, mParts, 0x1000);
+    }
+
+    std::vector<SamplePart> mParts;
+    std::vector<uint8_t> mFile;
+    ResourceOverlay mOverlay;
+};
+
+TEST_F(ResourceOverlayTest, IndexCoversOnlyItsParts)
+{
+    ASSERT_EQ(mOverlay.load(mFile), RESOURCE_OVERLAY_RESULT_SUCCESS);
+    EXPECT_EQ(mOverlay.partsMaxSize(), 0x1000u);
+    EXPECT_FALSE(mOverlay.hasPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX - 1));
+    EXPECT_TRUE(mOverlay.hasPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX));
+    EXPECT_TRUE(mOverlay.hasPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX + 2));
+    EXPECT_FALSE(mOverlay.hasPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX + 3));
+    EXPECT_FALSE(mOverlay.hasPart(FFLI_TEXTURE_PARTS_TYPE_MOLE, FFLI_GLASS_TEXTURE_MAX));
+
+    uint32_t size = 0;
+    EXPECT_EQ(mOverlay.getPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, 0, size), nullptr);
+}
+
+TEST_F(ResourceOverlayTest, PartsInflateToOriginal)
+{
+    ASSERT_EQ(mOverlay.load(mFile), RESOURCE_OVERLAY_RESULT_SUCCESS);
+    for (size_t i = 0; i < mParts.size(); i++) {
+        uint32_t size = 0;
+        const uint8_t* data = mOverlay.getPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, uint32_t(FFLI_GLASS_TEXTURE_MAX + i), size);
+        ASSERT_NE(data, nullptr) << "part " << i;
+        ASSERT_EQ(size, mParts[i].data.size()) << "part " << i;
+        EXPECT_EQ(std::memcmp(data, mParts[i].data.data(), size), 0) << "part " << i;
+    }
+    // The stored part isn't copied.
+    EXPECT_EQ(mOverlay.inflatedCount(), 2u);
+}
+
+TEST_F(ResourceOverlayTest, PartsInflateOnce)
+{
+    ASSERT_EQ(mOverlay.load(mFile), RESOURCE_OVERLAY_RESULT_SUCCESS);
+    EXPECT_EQ(mOverlay.inflatedCount(), 0u);
+
+    uint32_t size = 0;
+    const uint8_t* first = mOverlay.getPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX + 1, size);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(mOverlay.inflatedCount(), 1u);
+    const uint8_t* second = mOverlay.getPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX + 1, size);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(mOverlay.inflatedCount(), 1u);
+
+    mOverlay.clear();
+    EXPECT_FALSE(mOverlay.hasPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX));
+    EXPECT_EQ(mOverlay.inflatedCount(), 0u);
+}
+
+TEST_F(ResourceOverlayTest, RejectsBadHeader)
+{
+    EXPECT_EQ(mOverlay.load({}), RESOURCE_OVERLAY_RESULT_BAD_HEADER);
+
+    std::vector<uint8_t> file = mFile;
+    file[0] = 'X';
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_HEADER);
+
+    file = mFile;
+    storeBE32(&file[offsetof(ResourceOverlayHeader, version)], RESOURCE_OVERLAY_VERSION + 1);
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_HEADER);
+
+    file = mFile;
+    storeBE32(&file[offsetof(ResourceOverlayHeader, partsCount)], 0x10000000);
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_HEADER);
+
+    // A failed load leaves the previous overlay unloaded.
+    ASSERT_EQ(mOverlay.load(mFile), RESOURCE_OVERLAY_RESULT_SUCCESS);
+    file = mFile;
+    storeBE32(&file[offsetof(ResourceOverlayHeader, partsType)], FFLI_TEXTURE_PARTS_TYPE_MAX);
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_HEADER);
+    EXPECT_FALSE(mOverlay.hasPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX));
+}
+
+TEST_F(ResourceOverlayTest, RejectsBadParts)
+{
+    const size_t info = sizeof(ResourceOverlayHeader) + sizeof(FFLiResourcePartsInfo);
+
+    // Part data past the end of the file.
+    std::vector<uint8_t> file = mFile;
+    file.resize(file.size() - 1);
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_PARTS);
+
+    // Bigger than FFL's buffer.
+    file = buildOverlay(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX, mParts, 0xFFF);
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_PARTS);
+
+    file = mFile;
+    file[info + offsetof(FFLiResourcePartsInfo, strategy)] = FFLI_RESOURCE_STRATEGY_MAX;
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_STRATEGY);
+
+    file = mFile;
+    file[info + offsetof(FFLiResourcePartsInfo, windowBits)] = 24;
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_STRATEGY);
+
+    // A stored part must be its full size.
+    file = mFile;
+    const size_t storedInfo = sizeof(ResourceOverlayHeader) + 2 * sizeof(FFLiResourcePartsInfo);
+    storeBE32(&file[storedInfo + offsetof(FFLiResourcePartsInfo, compressedSize)], 0x3FF);
+    EXPECT_EQ(mOverlay.load(file), RESOURCE_OVERLAY_RESULT_BAD_STRATEGY);
+}
+
+TEST_F(ResourceOverlayTest, CorruptPartFailsWithoutCaching)
+{
+    // Damage the deflate stream of the first part, after its zlib header.
+    const size_t info = sizeof(ResourceOverlayHeader);
+    const uint32_t dataPos = uint32_t(mFile[info] << 24 | mFile[info + 1] << 16 | mFile[info + 2] << 8 | mFile[info + 3]);
+    std::memset(&mFile[dataPos + 2], 0xFF, 8);
+    ASSERT_EQ(mOverlay.load(mFile), RESOURCE_OVERLAY_RESULT_SUCCESS);
+
+    uint32_t size = 0;
+    EXPECT_EQ(mOverlay.getPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX, size), nullptr);
+    EXPECT_EQ(mOverlay.inflatedCount(), 0u);
+    // The others are unaffected.
+    EXPECT_NE(mOverlay.getPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX + 1, size), nullptr);
+}
+
+TEST_F(ResourceOverlayTest, CopyStaysInsideBuffer)
+{
+    // partsMaxSize says 0x1000, but the buffer is what counts.
+    ASSERT_EQ(mOverlay.load(mFile), RESOURCE_OVERLAY_RESULT_SUCCESS);
+    std::vector<uint8_t> buffer(0x800 + 1, 0xCD);
+
+    uint32_t size = 0;
+    ASSERT_TRUE(mOverlay.copyPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX, buffer.data(), 0x800, size));
+    EXPECT_EQ(size, 0x800u);
+    EXPECT_EQ(std::memcmp(buffer.data(), mParts[0].data.data(), size), 0);
+    EXPECT_EQ(buffer[0x800], 0xCD);
+
+    size = 0;
+    EXPECT_FALSE(mOverlay.copyPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX + 1, buffer.data(), 0x800, size));
+    EXPECT_EQ(size, 0u);
+    EXPECT_FALSE(mOverlay.copyPart(FFLI_TEXTURE_PARTS_TYPE_GLASS, FFLI_GLASS_TEXTURE_MAX + 3, buffer.data(), 0x800, size));
+}
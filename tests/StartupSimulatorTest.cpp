@@ -0,0 +1,378 @@
+/**
+ * @file StartupSimulatorTest.cpp
+ * @brief Runs the plugin's lifecycle, from INITIALIZE_PLUGIN through ON_APPLICATION_START
+ * to its patched handles, against the stand-ins in host/.
+ *
+ * Modules are a synthetic .text with one function for each signature, built
+ * as an ELF or a compressed RPX. Put real ELF/RPX files in test-elfs/ to
+ * also time startup on them.
+ */
+#include "../src/ffl_colors.h"
+#include "../src/ffl_patches.h"
+#include "../src/ffl_verify.h"
+#include "../src/patches.h"
+#include "host/HostPlatform.h"
+#include <gtest/gtest.h>
+#include <wups.h>
+#include <chrono>
+#include <coreinit/dynload.h>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+using namespace std::chrono;
+
+extern bool gHasLoadedWiiUMenu;
+
+/// A Wii U title that isn't the Wii U Menu (Mario Kart 8, USA).
+static constexpr uint64_t cTitleIdMarioKart8 = 0x000500001010EC00ULL;
+
+// // ---------------------------------------------------------------
+// //  Synthetic Modules
+// // ---------------------------------------------------------------
+
+/// Where RPX executables' .text is linked.
+static constexpr uint32_t cTextAddress = 0x02000000;
+
+static constexpr uint32_t cInsnNop  = 0x60000000;
+static constexpr uint32_t cInsnBlr  = 0x4E800020;
+static constexpr uint32_t cInsnMflr = 0x7C0802A6; // mfspr r0,LR
+static constexpr uint32_t cInsnStwu = 0x9421FFE0; // stwu r1,-0x20(r1)
+
+struct SyntheticText
+{
+    std::vector<uint32_t> words;
+    /// Where each signature should resolve to, by name.
+    std::map<std::string, uint32_t> expected;
+};
+
+static uint32_t encodeBL(uint32_t from, uint32_t to) {
+    return 0x48000001 | ((to - from) & 0x03FFFFFC);
+}
+
+/// Lays out a function for each of cSignaturesFFL, with `padding` bytes of nops after them.
+static SyntheticText buildFFLText(size_t padding = 0) {
+    SyntheticText text;
+    std::vector<uint32_t>& words = text.words;
+    const auto here = [&words] { return cTextAddress + static_cast<uint32_t>(words.size() * 4); };
+    const auto addFunctionStart = [&words] {
+        words.push_back(cInsnMflr);
+        words.push_back(cInsnStwu);
+        words.push_back(cInsnNop);
+    };
+
+    words.assign(8, cInsnNop);
+    for (const SignatureDefinition& sig : cSignaturesFFL) {
+        const uint32_t functionStart = here();
+        addFunctionStart();
+        const uint32_t patternStart = here();
+        const size_t patternIndex = words.size();
+        for (uint32_t w = 0; w < sig.wordCount; w++) {
+            words.push_back(sig.words[w].value & sig.words[w].mask);
+        }
+        words.push_back(cInsnBlr);
+
+        switch (sig.resolveMode) {
+        case SignatureResolveMode::Direct:
+            text.expected[sig.name] = patternStart;
+            break;
+        case SignatureResolveMode::FunctionStart:
+            text.expected[sig.name] = functionStart;
+            break;
+        case SignatureResolveMode::BranchTarget: {
+            const uint32_t callee = here();
+            addFunctionStart();
+            words.push_back(cInsnBlr);
+            words[patternIndex + sig.branchWordIndex] = encodeBL(patternStart + sig.branchWordIndex * 4, callee);
+            text.expected[sig.name] = callee;
+            break;
+        }
+        }
+        words.insert(words.end(), 8, cInsnNop);
+    }
+    words.insert(words.end(), padding / 4 + SIGSCAN_MAX_WORDS, cInsnNop);
+    return text;
+}
+
+static void storeBE16(std::vector<uint8_t>& out, size_t offset, uint16_t value) {
+    out[offset] = uint8_t(value >> 8);
+    out[offset + 1] = uint8_t(value);
+}
+
+static void storeBE32(std::vector<uint8_t>& out, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[offset + size_t(i)] = uint8_t(value >> (24 - 8 * i));
+    }
+}
+
+/// Wraps .text in a big-endian PPC ELF, or an RPX with the section compressed.
+static std::vector<uint8_t> buildImage(const std::vector<uint32_t>& words, bool rpx) {
+    std::vector<uint8_t> text(words.size() * 4);
+    for (size_t i = 0; i < words.size(); i++) {
+        storeBE32(text, i * 4, words[i]);
+    }
+    uint32_t textFlags = 0x2 | 0x4; // SHF_ALLOC | SHF_EXECINSTR
+    if (rpx) {
+        uLongf compressedSize = compressBound(text.size());
+        std::vector<uint8_t> compressed(4 + compressedSize);
+        storeBE32(compressed, 0, static_cast<uint32_t>(text.size()));
+        EXPECT_EQ(compress(compressed.data() + 4, &compressedSize, text.data(), text.size()), Z_OK);
+        compressed.resize(4 + compressedSize);
+        text = std::move(compressed);
+        textFlags |= 0x08000000; // SHF_RPL_ZLIB
+    }
+    static constexpr char cStrings[] = "\0.text\0.shstrtab";
+
+    constexpr size_t cEhdrSize = 52, cShdrSize = 40;
+    const size_t textOffset = cEhdrSize;
+    const size_t stringsOffset = textOffset + text.size();
+    const size_t shOffset = (stringsOffset + sizeof(cStrings) + 3) & ~size_t(3);
+    std::vector<uint8_t> image(shOffset + 3 * cShdrSize);
+
+    const uint8_t ident[] = { 0x7F, 'E', 'L', 'F', 1 /* 32-bit */, 2 /* big-endian */, 1, rpx ? uint8_t(0xCA) : uint8_t(0) };
+    memcpy(image.data(), ident, sizeof(ident));
+    storeBE16(image, 16, rpx ? 0xFE01 : 2); // e_type
+    storeBE16(image, 18, 20); // EM_PPC
+    storeBE32(image, 20, 1);
+    storeBE32(image, 32, static_cast<uint32_t>(shOffset));
+    storeBE16(image, 40, cEhdrSize);
+    storeBE16(image, 46, cShdrSize);
+    storeBE16(image, 48, 3);
+    storeBE16(image, 50, 2); // e_shstrndx
+    memcpy(&image[textOffset], text.data(), text.size());
+    memcpy(&image[stringsOffset], cStrings, sizeof(cStrings));
+
+    // Section 0 is null.
+    const size_t textHeader = shOffset + cShdrSize;
+    storeBE32(image, textHeader + 0, 1); // ".text"
+    storeBE32(image, textHeader + 4, 1); // SHT_PROGBITS
+    storeBE32(image, textHeader + 8, textFlags);
+    storeBE32(image, textHeader + 12, cTextAddress);
+    storeBE32(image, textHeader + 16, static_cast<uint32_t>(textOffset));
+    storeBE32(image, textHeader + 20, static_cast<uint32_t>(text.size()));
+    const size_t stringsHeader = textHeader + cShdrSize;
+    storeBE32(image, stringsHeader + 0, 7); // ".shstrtab"
+    storeBE32(image, stringsHeader + 4, 3); // SHT_STRTAB
+    storeBE32(image, stringsHeader + 16, static_cast<uint32_t>(stringsOffset));
+    storeBE32(image, stringsHeader + 20, sizeof(cStrings));
+    return image;
+}
+
+// // ---------------------------------------------------------------
+// //  Fixture
+// // ---------------------------------------------------------------
+
+class StartupSimulatorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        clearHostModules();
+        clearHostFunctionPatches();
+        clearHostNotifications();
+        setHostTitleID(HOST_TITLE_ID_WII_U_MENU);
+        gHasLoadedWiiUMenu = false;
+        init_plugin();
+    }
+    void TearDown() override {
+        deinit_plugin();
+        clearHostModules();
+    }
+
+    /// Patches found by scanning, rather than the fixed ones for Mii Maker.
+    static std::vector<HostFunctionPatch> scannedPatches() {
+        std::vector<HostFunctionPatch> patches;
+        for (const HostFunctionPatch& patch : getHostFunctionPatches()) {
+            if (patch.data.type == FUNCTION_PATCHER_REPLACE_BY_LIB_OR_ADDRESS) {
+                patches.push_back(patch);
+            }
+        }
+        return patches;
+    }
+
+    /// Where a module's .text was mapped, which is only its link address if that was free.
+    static uint32_t textAddrOf(const char* name) {
+        std::vector<OSDynLoad_NotifyData> modules(static_cast<size_t>(OSDynLoad_GetNumberOfRPLs()));
+        OSDynLoad_GetRPLInfo(0, static_cast<uint32_t>(modules.size()), modules.data());
+        for (const OSDynLoad_NotifyData& module : modules) {
+            if (strcmp(module.name, name) == 0) {
+                return module.textAddr;
+            }
+        }
+        return 0;
+    }
+
+    /// Checks that every signature was patched once, at its function in `text`, with its my_ hook.
+    static void expectPatchedAt(const SyntheticText& text, const char* moduleName) {
+        const uint32_t textAddr = textAddrOf(moduleName);
+        ASSERT_NE(textAddr, 0u) << moduleName;
+        const std::vector<HostFunctionPatch> patches = scannedPatches();
+        ASSERT_EQ(patches.size(), cSignaturesFFL.size());
+        for (const SignatureDefinition& sig : cSignaturesFFL) {
+            const auto* hook = static_cast<const function_replacement_data_t*>(sig.pHookInfo);
+            int count = 0;
+            for (const HostFunctionPatch& patch : patches) {
+                if (patch.data.replaceAddr != hook->replaceAddr) {
+                    continue;
+                }
+                count++;
+                EXPECT_EQ(patch.data.virtualAddr, text.expected.at(sig.name) - cTextAddress + textAddr) << sig.name;
+                EXPECT_NE(patch.data.physicalAddr, 0u) << sig.name;
+                EXPECT_EQ(patch.data.replaceCall, hook->replaceCall) << sig.name;
+            }
+            EXPECT_EQ(count, 1) << sig.name;
+        }
+    }
+};
+
+// // ---------------------------------------------------------------
+// //  Tests
+// // ---------------------------------------------------------------
+
+TEST_F(StartupSimulatorTest, PatchesEverySignatureInAnElf)
+{
+    const SyntheticText text = buildFFLText();
+    ASSERT_TRUE(addHostModule("men.rpx", buildImage(text.words, false)));
+    on_app_starting();
+
+    expectPatchedAt(text, "men.rpx");
+    EXPECT_EQ(gHandleIndex, static_cast<int>(getHostFunctionPatches().size()));
+    // The Wii U Menu is linear, so the color hooks were bound to that column.
+    EXPECT_EQ(my_FFLiGetHairColor(FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 1),
+        &gNnMiiColorTables.common[1][NN_MII_COLOR_GAMMA_LINEAR]);
+}
+
+TEST_F(StartupSimulatorTest, PatchesEverySignatureInACompressedRpx)
+{
+    const SyntheticText text = buildFFLText();
+    setHostTitleID(cTitleIdMarioKart8);
+    gHasLoadedWiiUMenu = true;
+    ASSERT_TRUE(addHostModule("Game.rpx", buildImage(text.words, true)));
+    on_app_starting();
+
+    expectPatchedAt(text, "Game.rpx");
+    EXPECT_EQ(my_FFLiGetHairColor(FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | 1),
+        &gNnMiiColorTables.common[1][NN_MII_COLOR_GAMMA_SRGB]);
+}
+
+TEST_F(StartupSimulatorTest, WaitsForTheWiiUMenu)
+{
+    const SyntheticText text = buildFFLText();
+    ASSERT_TRUE(addHostModule("Game.rpx", buildImage(text.words, false)));
+    setHostTitleID(cTitleIdMarioKart8);
+    on_app_starting();
+    EXPECT_TRUE(scannedPatches().empty());
+    on_app_ending();
+
+    setHostTitleID(HOST_TITLE_ID_WII_U_MENU);
+    on_app_starting();
+    expectPatchedAt(text, "Game.rpx");
+}
+
+TEST_F(StartupSimulatorTest, ScansOnlyTheRpx)
+{
+    const SyntheticText text = buildFFLText();
+    // Libraries are listed too, and only as many entries as there are modules are filled in.
+    ASSERT_TRUE(addHostModule("coreinit.rpl", buildImage(buildFFLText().words, false)));
+    ASSERT_TRUE(addHostModule("men.rpx", buildImage(text.words, false)));
+    on_app_starting();
+    expectPatchedAt(text, "men.rpx");
+}
+
+TEST_F(StartupSimulatorTest, RemovesPatchesWhenTitlesEnd)
+{
+    const SyntheticText text = buildFFLText();
+    ASSERT_TRUE(addHostModule("men.rpx", buildImage(text.words, false)));
+    // More titles than gHandles could hold without removing any.
+    for (int title = 0; title < 4; title++) {
+        on_app_starting();
+        EXPECT_GT(gHandleIndex, 0);
+        on_app_ending();
+        EXPECT_EQ(gHandleIndex, 0);
+    }
+    for (const HostFunctionPatch& patch : getHostFunctionPatches()) {
+        EXPECT_TRUE(patch.removed) << patch.handle;
+    }
+}
+
+TEST_F(StartupSimulatorTest, SkipsPatchesWhenHandlesAreFull)
+{
+    const SyntheticText text = buildFFLText();
+    ASSERT_TRUE(addHostModule("men.rpx", buildImage(text.words, false)));
+    constexpr int cFreeHandles = 3;
+    gHandleIndex = MAX_PATCHED_HANDLES - cFreeHandles;
+    on_app_starting();
+    EXPECT_EQ(gHandleIndex, MAX_PATCHED_HANDLES);
+    EXPECT_EQ(getHostFunctionPatches().size(), size_t(cFreeHandles));
+}
+
+TEST_F(StartupSimulatorTest, RejectsBrokenImages)
+{
+    std::vector<uint8_t> image = buildImage(buildFFLText().words, true);
+    image[5] = 1; // Little-endian
+    EXPECT_FALSE(addHostModule("men.rpx", image));
+    image[5] = 2;
+    image.resize(image.size() / 2);
+    EXPECT_FALSE(addHostModule("men.rpx", image));
+    EXPECT_EQ(OSDynLoad_GetNumberOfRPLs(), 0);
+}
+
+TEST_F(StartupSimulatorTest, NotifiesVerifyFailuresFromTheFlusher)
+{
+    on_app_starting();
+    FFLiCharInfo info;
+    std::memset(&info, 0, sizeof(info));
+    info.miiVersion = 3;
+    info.createID[0] = 0x80;
+    // Verified natively, so FFL isn't needed.
+    info.hair.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | (FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX);
+    EXPECT_EQ(my_FFLiVerifyCharInfoWithReason(&info, 0), FFLI_VERIFY_REASON_HAIR_COLOR);
+    // Stopping the flusher posts whatever it hasn't yet.
+    on_app_ending();
+
+    const std::vector<std::string>& notifications = getHostNotifications();
+    ASSERT_EQ(notifications.size(), 1u);
+    EXPECT_NE(notifications[0].find("charinfo verify fail"), std::string::npos) << notifications[0];
+}
+
+/// Times the whole startup path on a .text as big as a large game's.
+TEST_F(StartupSimulatorTest, BenchmarkStartup)
+{
+    const SyntheticText text = buildFFLText(16 * 1024 * 1024);
+    ASSERT_TRUE(addHostModule("Game.rpx", buildImage(text.words, true)));
+    gHasLoadedWiiUMenu = true;
+
+    const auto t0 = high_resolution_clock::now();
+    on_app_starting();
+    const auto t1 = high_resolution_clock::now();
+    printf("16 MiB .text: startup took %lld ms\n",
+        static_cast<long long>(duration_cast<milliseconds>(t1 - t0).count()));
+    expectPatchedAt(text, "Game.rpx");
+}
+
+/// Same, with real executables in test-elfs/ (see "extract elfs.txt").
+TEST_F(StartupSimulatorTest, BenchmarkElfs)
+{
+    namespace fs = std::filesystem;
+    const fs::path dir("test-elfs");
+    if (!fs::exists(dir)) {
+        GTEST_SKIP() << "There are no files in test-elfs/";
+    }
+    gHasLoadedWiiUMenu = true;
+    for (const fs::directory_entry& entry : fs::directory_iterator(dir)) {
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        clearHostModules();
+        clearHostFunctionPatches();
+        ASSERT_TRUE(loadHostModule(entry.path().c_str())) << entry.path();
+
+        const auto t0 = high_resolution_clock::now();
+        on_app_starting();
+        const auto t1 = high_resolution_clock::now();
+        printf("%s: startup took %lld ms, %zu patches\n", entry.path().filename().c_str(),
+            static_cast<long long>(duration_cast<milliseconds>(t1 - t0).count()), scannedPatches().size());
+        on_app_ending();
+    }
+}
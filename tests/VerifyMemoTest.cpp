@@ -0,0 +1,90 @@
+#include "../src/ffl_patches.h"
+#include "../src/ffl_verify.h"
+#include "../src/ffl_colors.h"
+#include <gtest/gtest.h>
+#include <cstring>
+
+// my_FFLiVerifyCharInfoWithReason's real_ is this, so calls that reach FFL are counted.
+static int sRealVerifyCalls = 0;
+static int countingVerifyCharInfoWithReason(void* /* pInfo */, int /* nameCheck */) {
+    sRealVerifyCalls++;
+    return FFLI_VERIFY_REASON_SUCCESS;
+}
+
+/// A valid CharInfo, told apart from the ones in other tests by `name`.
+/// The memo outlives each test, so every test uses its own.
+static FFLiCharInfo GetCharInfo(char16_t name) {
+    FFLiCharInfo info;
+    std::memset(&info, 0, sizeof(info));
+    info.miiVersion = 3;
+    info.eyebrow.y = 10;
+    info.personal.name[0] = name;
+    info.personal.birthMonth = 2;
+    info.personal.birthDay = 29;
+    info.createID[0] = 0x80;
+    return info;
+}
+
+class VerifyMemoTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        real_FFLiVerifyCharInfoWithReason = countingVerifyCharInfoWithReason;
+        sRealVerifyCalls = 0;
+        resetVerifyMemoStats();
+    }
+
+    static void ExpectStats(uint32_t hits, uint32_t misses) {
+        const VerifyMemoStats stats = getVerifyMemoStats();
+        EXPECT_EQ(stats.hits, hits);
+        EXPECT_EQ(stats.misses, misses);
+    }
+};
+
+TEST_F(VerifyMemoTest, RepeatedCharInfoHits)
+{
+    FFLiCharInfo info = GetCharInfo(u'A');
+    EXPECT_EQ(my_FFLiVerifyCharInfoWithReason(&info, 1), FFLI_VERIFY_REASON_SUCCESS);
+    ExpectStats(0, 1);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(my_FFLiVerifyCharInfoWithReason(&info, 1), FFLI_VERIFY_REASON_SUCCESS);
+    }
+    ExpectStats(3, 1);
+    EXPECT_EQ(sRealVerifyCalls, 1);
+}
+
+TEST_F(VerifyMemoTest, ChangedCharInfoMisses)
+{
+    FFLiCharInfo info = GetCharInfo(u'B');
+    my_FFLiVerifyCharInfoWithReason(&info, 1);
+    info.eyebrow.y = 11;
+    my_FFLiVerifyCharInfoWithReason(&info, 1);
+    // Same CharInfo, other nameCheck.
+    my_FFLiVerifyCharInfoWithReason(&info, 0);
+    ExpectStats(0, 3);
+    EXPECT_EQ(sRealVerifyCalls, 3);
+
+    // Back to the first one, which is still in the memo.
+    info.eyebrow.y = 10;
+    my_FFLiVerifyCharInfoWithReason(&info, 1);
+    ExpectStats(1, 3);
+    EXPECT_EQ(sRealVerifyCalls, 3);
+}
+
+TEST_F(VerifyMemoTest, ExtendedResultsAreMemoized)
+{
+    FFLiCharInfo info = GetCharInfo(u'C');
+    info.hair.color = FFLI_NN_MII_COMMON_COLOR_ENABLE_MASK | (FFLI_NN_MII_COMMON_COLOR_MAX + FFLI_NN_MII_CUSTOM_COLOR_MAX);
+    const int result = my_FFLiVerifyCharInfoWithReason(&info, 1);
+    EXPECT_EQ(result, FFLI_VERIFY_REASON_HAIR_COLOR);
+    EXPECT_EQ(my_FFLiVerifyCharInfoWithReason(&info, 1), result);
+    ExpectStats(1, 1);
+    // Verified natively, never by FFL.
+    EXPECT_EQ(sRealVerifyCalls, 0);
+}
+
+TEST_F(VerifyMemoTest, NullIsNotCounted)
+{
+    my_FFLiVerifyCharInfoWithReason(nullptr, 1);
+    ExpectStats(0, 0);
+    EXPECT_EQ(sRealVerifyCalls, 1);
+}
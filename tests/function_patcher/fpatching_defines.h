@@ -201,8 +201,8 @@ typedef function_replacement_data_t function_replacement_data_v3_t;
         .type          = __type,                                                                \
         .physicalAddr  = 0,                                                                     \
         .virtualAddr   = 0,                                                                     \
-        .replaceAddr   = (uint32_t) my_##__replacementFunctionName,                             \
-        .replaceCall   = (uint32_t *) &real_##__replacementFunctionName,                        \
+        .replaceAddr   = (uintptr_t) my_##__replacementFunctionName,                            \
+        .replaceCall   = (uintptr_t *) &real_##__replacementFunctionName,                       \
         .targetProcess = FP_TARGET_PROCESS_ALL,                                                 \
         .ReplaceInRPX  = {                                                                      \
              .targetTitleIds      = __targetTitleIds,                                           \
@@ -0,0 +1,426 @@
+#include "HostPlatform.h"
+#include "../../src/utils/ReadFile.h"
+#include <algorithm>
+#include <chrono>
+#include <coreinit/core.h>
+#include <coreinit/debug.h>
+#include <coreinit/dynload.h>
+#include <coreinit/memorymap.h>
+#include <coreinit/thread.h>
+#include <coreinit/time.h>
+#include <coreinit/title.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <notifications/notifications.h>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+#include <whb/log.h>
+#include <zlib.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+// // ---------------------------------------------------------------
+// //  Logging
+// // ---------------------------------------------------------------
+// Quiet unless FFL_HOST_LOG is set, so benchmarks aren't measuring the terminal.
+
+static bool hostLogEnabled() {
+    static const bool enabled = getenv("FFL_HOST_LOG") != nullptr;
+    return enabled;
+}
+
+static void hostLog(const char* fmt, va_list args, bool newline) {
+    if (!hostLogEnabled()) {
+        return;
+    }
+    vfprintf(stderr, fmt, args);
+    if (newline) {
+        fputc('\n', stderr);
+    }
+}
+
+void OSReport(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    hostLog(fmt, args, false);
+    va_end(args);
+}
+
+bool WHBLogPrintf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    hostLog(fmt, args, true);
+    va_end(args);
+    return true;
+}
+
+bool WHBLogWritef(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    hostLog(fmt, args, false);
+    va_end(args);
+    return true;
+}
+
+bool WHBLogPrint(const char* str) {
+    return WHBLogPrintf("%s", str);
+}
+
+bool WHBLogWrite(const char* str) {
+    return WHBLogWritef("%s", str);
+}
+
+// // ---------------------------------------------------------------
+// //  Time and Cores
+// // ---------------------------------------------------------------
+
+OSTime OSGetSystemTime() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+    // Split up so the multiply can't overflow.
+    return static_cast<OSTime>((ns / 1000000000) * OSTimerClockSpeed +
+        (ns % 1000000000) * OSTimerClockSpeed / 1000000000);
+}
+
+OSTick OSGetSystemTick() {
+    return static_cast<OSTick>(OSGetSystemTime());
+}
+
+int OSCreateThread(OSThread* thread, OSThreadEntryPointFn entry, int32_t argc, char* argv,
+                   void* /* stack */, uint32_t /* stackSize */, int32_t /* priority */, uint8_t /* attributes */) {
+    thread->hostThread = nullptr;
+    thread->entry = entry;
+    thread->argc = argc;
+    thread->argv = reinterpret_cast<const char**>(argv);
+    return true;
+}
+
+int32_t OSResumeThread(OSThread* thread) {
+    if (thread->hostThread == nullptr) {
+        thread->hostThread = new std::thread(thread->entry, thread->argc, thread->argv);
+    }
+    return 1;
+}
+
+int OSJoinThread(OSThread* thread, int* threadResult) {
+    auto* hostThread = static_cast<std::thread*>(thread->hostThread);
+    if (hostThread == nullptr) {
+        return false;
+    }
+    hostThread->join();
+    delete hostThread;
+    thread->hostThread = nullptr;
+    if (threadResult) {
+        *threadResult = 0;
+    }
+    return true;
+}
+
+void OSSetThreadName(OSThread* /* thread */, const char* /* name */) {
+}
+
+void OSSleepTicks(OSTime ticks) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(OSTicksToNanoseconds(ticks)));
+}
+
+uint32_t OSGetCoreId() {
+    static thread_local const uint32_t core = static_cast<uint32_t>(
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) % 3);
+    return core;
+}
+
+uintptr_t OSEffectiveToPhysical(uintptr_t virtualAddress) {
+    return virtualAddress;
+}
+
+// // ---------------------------------------------------------------
+// //  Modules
+// // ---------------------------------------------------------------
+
+struct HostModule
+{
+    std::string name;
+    void* mapping;
+    size_t mappingSize;
+    OSDynLoad_NotifyData info;
+
+    ~HostModule() { munmap(mapping, mappingSize); }
+};
+
+static std::vector<std::unique_ptr<HostModule>> sModules;
+static uint64_t sTitleID = HOST_TITLE_ID_WII_U_MENU;
+
+static uint16_t loadBE16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static uint32_t loadBE32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+/// Finds the largest executable section and returns its contents, inflated if it's from an RPX.
+static bool readExecSection(const std::vector<uint8_t>& image, uint32_t& outAddr, std::vector<uint8_t>& outText) {
+    constexpr uint32_t cShtProgbits = 1;
+    constexpr uint32_t cShfAllocExec = 0x2 | 0x4;
+    /// SHF_RPL_ZLIB: starts with the inflated size, then a zlib stream.
+    constexpr uint32_t cShfRplZlib = 0x08000000;
+    constexpr size_t cShdrSize = 40;
+
+    // 32-bit, big-endian ELF.
+    if (image.size() < 52 || memcmp(image.data(), "\x7F" "ELF", 4) != 0 || image[4] != 1 || image[5] != 2) {
+        return false;
+    }
+    const uint32_t shOff = loadBE32(&image[32]);
+    const uint16_t shEntSize = loadBE16(&image[46]);
+    const uint16_t shNum = loadBE16(&image[48]);
+    if (shEntSize != cShdrSize || shOff > image.size() || (image.size() - shOff) / cShdrSize < shNum) {
+        return false;
+    }
+
+    const uint8_t* best = nullptr;
+    for (uint16_t i = 0; i < shNum; i++) {
+        const uint8_t* sh = &image[shOff + i * cShdrSize];
+        if (loadBE32(sh + 4) == cShtProgbits && (loadBE32(sh + 8) & cShfAllocExec) == cShfAllocExec &&
+            (best == nullptr || loadBE32(sh + 20) > loadBE32(best + 20))) {
+            best = sh;
+        }
+    }
+    if (best == nullptr) {
+        return false;
+    }
+    const uint32_t flags = loadBE32(best + 8);
+    const uint32_t offset = loadBE32(best + 16);
+    const uint32_t size = loadBE32(best + 20);
+    if (offset > image.size() || image.size() - offset < size) {
+        return false;
+    }
+    outAddr = loadBE32(best + 12);
+
+    const uint8_t* data = &image[offset];
+    if ((flags & cShfRplZlib) == 0) {
+        outText.assign(data, data + size);
+        return true;
+    }
+    if (size < 4) {
+        return false;
+    }
+    outText.resize(loadBE32(data));
+    uLongf inflatedSize = outText.size();
+    return uncompress(outText.data(), &inflatedSize, data + 4, size - 4) == Z_OK && inflatedSize == outText.size();
+}
+
+/// Maps memory at `address` if it's free, or anywhere below 4 GiB.
+static void* mapBelow4GiB(uint32_t address, size_t size) {
+    void* mapping = mmap(reinterpret_cast<void*>(uintptr_t(address)), size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+#ifdef MAP_32BIT
+    if (mapping == MAP_FAILED || reinterpret_cast<uintptr_t>(mapping) > UINT32_MAX - size) {
+        if (mapping != MAP_FAILED) {
+            munmap(mapping, size);
+        }
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    }
+#endif
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+    if (reinterpret_cast<uintptr_t>(mapping) > UINT32_MAX - size) {
+        munmap(mapping, size);
+        return nullptr;
+    }
+    return mapping;
+}
+
+bool addHostModule(const char* name, const std::vector<uint8_t>& image) {
+    uint32_t linkAddress;
+    std::vector<uint8_t> text;
+    if (!readExecSection(image, linkAddress, text) || text.empty()) {
+        return false;
+    }
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t mappingSize = (text.size() + pageSize - 1) / pageSize * pageSize;
+    void* mapping = mapBelow4GiB(linkAddress, mappingSize);
+    if (mapping == nullptr) {
+        return false;
+    }
+    memcpy(mapping, text.data(), text.size());
+
+    auto module = std::make_unique<HostModule>();
+    module->name = name;
+    module->mapping = mapping;
+    module->mappingSize = mappingSize;
+    module->info = {};
+    module->info.name = module->name.data();
+    module->info.textAddr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(mapping));
+    module->info.textSize = static_cast<uint32_t>(text.size());
+    sModules.push_back(std::move(module));
+    return true;
+}
+
+bool loadHostModule(const char* path) {
+    std::vector<uint8_t> image;
+    if (!readWholeFile(path, image)) {
+        return false;
+    }
+    const char* name = strrchr(path, '/');
+    return addHostModule(name != nullptr ? name + 1 : path, image);
+}
+
+void clearHostModules() {
+    sModules.clear();
+}
+
+int32_t OSDynLoad_GetNumberOfRPLs() {
+    return static_cast<int32_t>(sModules.size());
+}
+
+int OSDynLoad_GetRPLInfo(uint32_t first, uint32_t count, OSDynLoad_NotifyData* outInfos) {
+    if (outInfos == nullptr || first > sModules.size() || sModules.size() - first < count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        outInfos[i] = sModules[first + i]->info;
+    }
+    return true;
+}
+
+void setHostTitleID(uint64_t titleID) {
+    sTitleID = titleID;
+}
+
+uint64_t OSGetTitleID() {
+    return sTitleID;
+}
+
+// // ---------------------------------------------------------------
+// //  FunctionPatcher
+// // ---------------------------------------------------------------
+
+static bool sFunctionPatcherInitialized = false;
+static std::vector<HostFunctionPatch> sFunctionPatches;
+
+FunctionPatcherStatus FunctionPatcher_InitLibrary() {
+    sFunctionPatcherInitialized = true;
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+FunctionPatcherStatus FunctionPatcher_DeInitLibrary() {
+    sFunctionPatcherInitialized = false;
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+const char* FunctionPatcher_GetStatusStr(FunctionPatcherStatus status) {
+    switch (status) {
+    case FUNCTION_PATCHER_RESULT_SUCCESS:           return "FUNCTION_PATCHER_RESULT_SUCCESS";
+    case FUNCTION_PATCHER_RESULT_INVALID_ARGUMENT:  return "FUNCTION_PATCHER_RESULT_INVALID_ARGUMENT";
+    case FUNCTION_PATCHER_RESULT_PATCH_NOT_FOUND:   return "FUNCTION_PATCHER_RESULT_PATCH_NOT_FOUND";
+    case FUNCTION_PATCHER_RESULT_LIB_UNINITIALIZED: return "FUNCTION_PATCHER_RESULT_LIB_UNINITIALIZED";
+    default:                                        return "FUNCTION_PATCHER_RESULT_UNKNOWN_ERROR";
+    }
+}
+
+FunctionPatcherStatus FunctionPatcher_AddFunctionPatch(function_replacement_data_t* function_data,
+    PatchedFunctionHandle* outHandle, bool* outHasBeenPatched) {
+    if (!sFunctionPatcherInitialized) {
+        return FUNCTION_PATCHER_RESULT_LIB_UNINITIALIZED;
+    }
+    if (function_data == nullptr || outHandle == nullptr ||
+        function_data->version != FUNCTION_REPLACEMENT_DATA_STRUCT_VERSION ||
+        function_data->replaceAddr == 0 || function_data->replaceCall == nullptr) {
+        return FUNCTION_PATCHER_RESULT_INVALID_ARGUMENT;
+    }
+    // Patching by address needs both addresses.
+    const bool byAddress = function_data->type == FUNCTION_PATCHER_REPLACE_BY_LIB_OR_ADDRESS &&
+        function_data->ReplaceInRPL.library == LIBRARY_OTHER;
+    if (byAddress && (function_data->physicalAddr == 0 || function_data->virtualAddr == 0)) {
+        return FUNCTION_PATCHER_RESULT_INVALID_ARGUMENT;
+    }
+
+    HostFunctionPatch patch;
+    patch.data = *function_data;
+    patch.handle = static_cast<PatchedFunctionHandle>(sFunctionPatches.size() + 1);
+    patch.removed = false;
+    sFunctionPatches.push_back(patch);
+    *outHandle = patch.handle;
+
+    if (outHasBeenPatched != nullptr) {
+        // Patches for an executable only apply while one of its titles is running.
+        bool applies = function_data->type == FUNCTION_PATCHER_REPLACE_BY_LIB_OR_ADDRESS;
+        if (!applies) {
+            const uint64_t* titleIds = function_data->ReplaceInRPX.targetTitleIds;
+            applies = std::find(titleIds, titleIds + function_data->ReplaceInRPX.targetTitleIdsCount, sTitleID) !=
+                titleIds + function_data->ReplaceInRPX.targetTitleIdsCount;
+        }
+        *outHasBeenPatched = applies;
+    }
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+FunctionPatcherStatus FunctionPatcher_RemoveFunctionPatch(PatchedFunctionHandle handle) {
+    if (!sFunctionPatcherInitialized) {
+        return FUNCTION_PATCHER_RESULT_LIB_UNINITIALIZED;
+    }
+    if (handle == 0 || handle > sFunctionPatches.size() || sFunctionPatches[handle - 1].removed) {
+        return FUNCTION_PATCHER_RESULT_PATCH_NOT_FOUND;
+    }
+    sFunctionPatches[handle - 1].removed = true;
+    return FUNCTION_PATCHER_RESULT_SUCCESS;
+}
+
+const std::vector<HostFunctionPatch>& getHostFunctionPatches() {
+    return sFunctionPatches;
+}
+
+void clearHostFunctionPatches() {
+    sFunctionPatches.clear();
+}
+
+// // ---------------------------------------------------------------
+// //  Notifications
+// // ---------------------------------------------------------------
+
+static std::mutex sNotificationMutex;
+static std::vector<std::string> sNotifications;
+
+static NotificationModuleStatus addNotification(const char* text) {
+    std::lock_guard<std::mutex> lock(sNotificationMutex);
+    sNotifications.emplace_back(text);
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_InitLibrary() {
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+NotificationModuleStatus NotificationModule_DeInitLibrary() {
+    return NOTIFICATION_MODULE_RESULT_SUCCESS;
+}
+
+const char* NotificationModule_GetStatusStr(NotificationModuleStatus status) {
+    return status == NOTIFICATION_MODULE_RESULT_SUCCESS ? "NOTIFICATION_MODULE_RESULT_SUCCESS" : "NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR";
+}
+
+NotificationModuleStatus NotificationModule_AddInfoNotification(const char* text) {
+    return addNotification(text);
+}
+
+NotificationModuleStatus NotificationModule_AddErrorNotification(const char* text) {
+    return addNotification(text);
+}
+
+const std::vector<std::string>& getHostNotifications() {
+    return sNotifications;
+}
+
+void clearHostNotifications() {
+    std::lock_guard<std::mutex> lock(sNotificationMutex);
+    sNotifications.clear();
+}
@@ -0,0 +1,63 @@
+#pragma once
+/**
+ * @file HostPlatform.h
+ * @brief Stand-ins for the console libraries the plugin calls, so its sources build and run on a PC.
+ *
+ * Compile the plugin's sources with -D__WIIU__ and `-Ihost -I.` from tests/,
+ * and link HostPlatform.cpp. The stub headers in this directory replace
+ * wut's, WUPS's, libfunctionpatcher's and libnotifications', and the
+ * functions here set up what they return and record what the plugin did,
+ * for tests to check.
+ */
+#include <cstdint>
+#include <function_patcher/function_patching.h>
+#include <string>
+#include <vector>
+
+// // ---------------------------------------------------------------
+// //  Modules (OSDynLoad)
+// // ---------------------------------------------------------------
+
+/// The Wii U Menu (USA), which the plugin waits for before scanning.
+#define HOST_TITLE_ID_WII_U_MENU 0x0005001010040100ULL
+
+/**
+ * Adds a module for OSDynLoad_GetRPLInfo() to list, after the ones already added.
+ * @param name  Module name, e.g. "men.rpx".
+ * @param image Big-endian PPC ELF, or an RPX/RPL with zlib-compressed sections.
+ * @details The executable section is mapped at the address it was linked at
+ * when that's free, so matches have the same addresses as on the console.
+ * Otherwise it goes anywhere below 4 GiB, since textAddr is 32-bit.
+ * @return False if the image has no executable section or can't be mapped.
+ */
+bool addHostModule(const char* name, const std::vector<uint8_t>& image);
+/// Reads a file and adds it with its file name, see addHostModule().
+bool loadHostModule(const char* path);
+/// Unmaps every module.
+void clearHostModules();
+
+/// What OSGetTitleID() returns. Defaults to HOST_TITLE_ID_WII_U_MENU.
+void setHostTitleID(uint64_t titleID);
+
+// // ---------------------------------------------------------------
+// //  FunctionPatcher
+// // ---------------------------------------------------------------
+
+/// A call to FunctionPatcher_AddFunctionPatch().
+struct HostFunctionPatch
+{
+    function_replacement_data_t data; ///< As passed, so it must not point to anything temporary.
+    PatchedFunctionHandle handle;
+    bool removed; ///< By FunctionPatcher_RemoveFunctionPatch().
+};
+
+const std::vector<HostFunctionPatch>& getHostFunctionPatches();
+void clearHostFunctionPatches();
+
+// // ---------------------------------------------------------------
+// //  Notifications
+// // ---------------------------------------------------------------
+
+/// Notifications posted since the last clearHostNotifications().
+const std::vector<std::string>& getHostNotifications();
+void clearHostNotifications();
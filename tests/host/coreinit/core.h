@@ -0,0 +1,14 @@
+#pragma once
+// Host stand-in for wut's coreinit/core.h.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Spreads host threads over Espresso's three cores.
+uint32_t OSGetCoreId(void);
+
+#ifdef __cplusplus
+}
+#endif
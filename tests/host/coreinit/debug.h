@@ -0,0 +1,11 @@
+#pragma once
+// Host stand-in for wut's coreinit/debug.h. See HostPlatform.cpp.
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void OSReport(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef __cplusplus
+}
+#endif
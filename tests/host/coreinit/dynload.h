@@ -0,0 +1,30 @@
+#pragma once
+// Host stand-in for the parts of wut's coreinit/dynload.h the plugin uses.
+// Modules are ELF/RPX images added with addHostModule(), see HostPlatform.h.
+#include <stdint.h>
+
+typedef struct OSDynLoad_NotifyData
+{
+    char* name;
+    uint32_t textAddr;
+    uint32_t textOffset;
+    uint32_t textSize;
+    uint32_t dataAddr;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+    uint32_t readAddr;
+    uint32_t readOffset;
+    uint32_t readSize;
+} OSDynLoad_NotifyData;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t OSDynLoad_GetNumberOfRPLs(void);
+/// @return False if [first, first + count) isn't within the loaded modules.
+int OSDynLoad_GetRPLInfo(uint32_t first, uint32_t count, OSDynLoad_NotifyData* outInfos);
+
+#ifdef __cplusplus
+}
+#endif
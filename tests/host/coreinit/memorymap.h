@@ -0,0 +1,15 @@
+#pragma once
+// Host stand-in for wut's coreinit/memorymap.h.
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Host memory isn't remapped, so this returns the address as is.
+/// Takes uintptr_t, which is uint32_t on a Wii U, so it fits SignatureScanner's ToPhysicalFunction.
+uintptr_t OSEffectiveToPhysical(uintptr_t virtualAddress);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+// Host stand-in for the parts of wut's coreinit/thread.h the plugin uses.
+#include "time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OS_THREAD_ATTRIB_AFFINITY_ANY 0x07
+
+/// Runs on a std::thread, which is created in OSResumeThread.
+typedef struct OSThread {
+    void* hostThread;
+    int (*entry)(int, const char**);
+    int argc;
+    const char** argv;
+} OSThread;
+
+typedef int (*OSThreadEntryPointFn)(int argc, const char** argv);
+
+int OSCreateThread(OSThread* thread, OSThreadEntryPointFn entry, int32_t argc, char* argv,
+                   void* stack, uint32_t stackSize, int32_t priority, uint8_t attributes);
+int32_t OSResumeThread(OSThread* thread);
+int OSJoinThread(OSThread* thread, int* threadResult);
+void OSSetThreadName(OSThread* thread, const char* name);
+void OSSleepTicks(OSTime ticks);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+// Host stand-in for wut's coreinit/time.h, ticking at the Wii U's timer rate.
+#include <stdint.h>
+
+typedef int64_t OSTime;
+typedef int32_t OSTick;
+
+/// Bus clock / 4, as on a Wii U.
+#define OSTimerClockSpeed 62156250
+
+#define OSSecondsToTicks(val)       ((uint64_t)(val) * (uint64_t)OSTimerClockSpeed)
+#define OSMillisecondsToTicks(val) (((uint64_t)(val) * (uint64_t)OSTimerClockSpeed) / 1000ull)
+#define OSTicksToNanoseconds(val)  ((((uint64_t)(val)) * 8000ull) / ((uint64_t)OSTimerClockSpeed / 500000ull))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OSTime OSGetSystemTime(void);
+OSTick OSGetSystemTick(void);
+
+#ifdef __cplusplus
+}
+#endif
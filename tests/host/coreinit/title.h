@@ -0,0 +1,13 @@
+#pragma once
+// Host stand-in for wut's coreinit/title.h. Set the title with setHostTitleID().
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t OSGetTitleID(void);
+
+#ifdef __cplusplus
+}
+#endif
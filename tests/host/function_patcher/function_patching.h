@@ -0,0 +1,27 @@
+#pragma once
+// Host stand-in for libfunctionpatcher. Patches are recorded instead of applied,
+// see getHostFunctionPatches() in HostPlatform.h.
+#include <function_patcher/fpatching_defines.h>
+
+typedef enum FunctionPatcherStatus {
+    FUNCTION_PATCHER_RESULT_SUCCESS            = 0,
+    FUNCTION_PATCHER_RESULT_INVALID_ARGUMENT   = -0x10,
+    FUNCTION_PATCHER_RESULT_PATCH_NOT_FOUND    = -0x11,
+    FUNCTION_PATCHER_RESULT_LIB_UNINITIALIZED  = -0x20,
+    FUNCTION_PATCHER_RESULT_UNKNOWN_ERROR      = -0x1000,
+} FunctionPatcherStatus;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+FunctionPatcherStatus FunctionPatcher_InitLibrary(void);
+FunctionPatcherStatus FunctionPatcher_DeInitLibrary(void);
+const char* FunctionPatcher_GetStatusStr(FunctionPatcherStatus status);
+FunctionPatcherStatus FunctionPatcher_AddFunctionPatch(function_replacement_data_t* function_data,
+    PatchedFunctionHandle* outHandle, bool* outHasBeenPatched);
+FunctionPatcherStatus FunctionPatcher_RemoveFunctionPatch(PatchedFunctionHandle handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+// Host stand-in for libnotifications. Notifications are kept, so tests can check them.
+#include <stdint.h>
+
+typedef enum NotificationModuleStatus {
+    NOTIFICATION_MODULE_RESULT_SUCCESS        = 0,
+    NOTIFICATION_MODULE_RESULT_UNKNOWN_ERROR  = -1000,
+} NotificationModuleStatus;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+NotificationModuleStatus NotificationModule_InitLibrary(void);
+NotificationModuleStatus NotificationModule_DeInitLibrary(void);
+const char* NotificationModule_GetStatusStr(NotificationModuleStatus status);
+NotificationModuleStatus NotificationModule_AddInfoNotification(const char* text);
+NotificationModuleStatus NotificationModule_AddErrorNotification(const char* text);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+// Host stand-in for wut's whb/log.h. Logs go to stderr when FFL_HOST_LOG is set.
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool WHBLogPrint(const char* str);
+bool WHBLogWrite(const char* str);
+bool WHBLogPrintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+bool WHBLogWritef(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+// Host stand-in for the WiiUPluginSystem's wups.h.
+// Each plugin hook becomes a plain function with the name WUPS gives it, for tests to call.
+
+#define WUPS_PLUGIN_NAME(x)
+#define WUPS_PLUGIN_VERSION(x)
+#define WUPS_PLUGIN_AUTHOR(x)
+#define WUPS_PLUGIN_LICENSE(x)
+
+#define INITIALIZE_PLUGIN()     void init_plugin()
+#define DEINITIALIZE_PLUGIN()   void deinit_plugin()
+#define ON_APPLICATION_START()  void on_app_starting()
+#define ON_APPLICATION_ENDS()   void on_app_ending()
+
+void init_plugin();
+void deinit_plugin();
+void on_app_starting();
+void on_app_ending();